@@ -14,7 +14,7 @@ class ZIMConverter {
 
   public:
     // MARK: - ZIMMessage <- zim_message
-    static void cZIMMessage(std::shared_ptr<ZIMMessage> toMessage,
+    static void cZIMMessage(const std::shared_ptr<ZIMMessage> &toMessage,
                             struct zim_message &fromMessage) {
 
         if ((zim_message_type)toMessage->getType() != fromMessage.type) {
@@ -23,7 +23,8 @@ class ZIMConverter {
 
         if (fromMessage.type == zim_message_type_text) {
 
-            auto textMessage = std::static_pointer_cast<ZIMTextMessage>(toMessage);
+            // assigned in place to reuse the string storage, this runs for every text message sent
+            auto textMessage = static_cast<ZIMTextMessage *>(toMessage.get());
             textMessage->message = fromMessage.message;
 
         } else if (fromMessage.type == zim_message_type_command) {
@@ -188,7 +189,12 @@ class ZIMConverter {
         sConfig->reaction_type = const_cast<char *>(oConfig->reactionType.c_str());
     };
 
-    static void sNewZIMMessage(struct zim_message &sMessage, const ZIMMessage *oMessage) {
+    // Strings are borrowed from oMessage, which has to outlive sMessage. Mentioned user IDs are put
+    // in mentionBuffer when they fit and on the heap otherwise, sDelZIMMessage with the same buffer
+    // releases them.
+    static void sNewZIMMessage(struct zim_message &sMessage, const ZIMMessage *oMessage,
+                               char **mentionBuffer = nullptr,
+                               unsigned int mentionBufferLength = 0) {
         if (!oMessage) {
             return;
         }
@@ -320,7 +326,10 @@ class ZIMConverter {
         sMessage.is_server_message = oMessage->serverMessage;
         if (oMessage->mentionedUserIDs.size() > 0) {
             sMessage.mentioned_user_ids_length = (unsigned int)oMessage->mentionedUserIDs.size();
-            sMessage.mentioned_user_ids = new char *[sMessage.mentioned_user_ids_length];
+            sMessage.mentioned_user_ids =
+                sMessage.mentioned_user_ids_length <= mentionBufferLength
+                    ? mentionBuffer
+                    : new char *[sMessage.mentioned_user_ids_length];
             for (unsigned int i = 0; i < sMessage.mentioned_user_ids_length; i++) {
                 sMessage.mentioned_user_ids[i] =
                     const_cast<char *>(oMessage->mentionedUserIDs.at(i).c_str());
@@ -328,9 +337,11 @@ class ZIMConverter {
         }
     }
 
-    static void sDelZIMMessage(struct zim_message &sMessage) {
+    static void sDelZIMMessage(struct zim_message &sMessage, char **mentionBuffer = nullptr) {
         if (sMessage.mentioned_user_ids) {
-            delete[] sMessage.mentioned_user_ids;
+            if (sMessage.mentioned_user_ids != mentionBuffer) {
+                delete[] sMessage.mentioned_user_ids;
+            }
             sMessage.mentioned_user_ids = nullptr;
             sMessage.mentioned_user_ids_length = 0;
         }
@@ -984,10 +995,10 @@ class ZIMConverter {
 
     static void oZIMMessageMentionedUserIDs(char **user_ids, unsigned int ids_length,
                                             std::vector<std::string> &oIDs) {
-        oIDs.clear();
-        oIDs.reserve(ids_length);
+        // assigned in place, so a message updated by its own callbacks keeps its strings' storage
+        oIDs.resize(ids_length);
         for (unsigned int i = 0; i < ids_length; i++) {
-            oIDs.emplace_back(user_ids[i]);
+            oIDs[i] = user_ids[i];
         }
     }
 
@@ -1708,4 +1719,26 @@ class ZIMConverter {
     }
 };
 
+// zim_message view of a ZIMMessage for the duration of one C API call. The strings point into the
+// message and a few mentioned user IDs fit inline, so converting a text message allocates nothing.
+class ZIMBorrowedMessage {
+  public:
+    explicit ZIMBorrowedMessage(const ZIMMessage *message) {
+        memset(&message_, 0, sizeof(struct zim_message));
+        ZIMConverter::sNewZIMMessage(message_, message, mentions_, kInlineMentionCount);
+    }
+    ~ZIMBorrowedMessage() { ZIMConverter::sDelZIMMessage(message_, mentions_); }
+
+    ZIMBorrowedMessage(const ZIMBorrowedMessage &) = delete;
+    ZIMBorrowedMessage &operator=(const ZIMBorrowedMessage &) = delete;
+
+    struct zim_message &get() { return message_; }
+
+  private:
+    static const unsigned int kInlineMentionCount = 8;
+
+    struct zim_message message_;
+    char *mentions_[kInlineMentionCount];
+};
+
 } // namespace zim
@@ -0,0 +1,1963 @@
+#include "zim_mock.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace zim_mock {
+
+// MARK: - Configuration
+
+static std::mt19937_64 &threadRng()
+{
+	static std::atomic<uint64_t> seed{std::random_device{}()};
+	thread_local std::mt19937_64 rng(seed.fetch_add(0x9E3779B97F4A7C15ULL));
+	return rng;
+}
+
+bool Distribution::parse(const std::string &spec, Distribution &distribution)
+{
+	std::vector<std::string> parts;
+	std::stringstream stream(spec);
+	std::string part;
+	while (std::getline(stream, part, ':')) {
+		parts.push_back(part);
+	}
+	if (parts.empty()) {
+		return false;
+	}
+
+	std::vector<double> values;
+	for (size_t i = 1; i < parts.size(); ++i) {
+		char *end = nullptr;
+		double value = std::strtod(parts[i].c_str(), &end);
+		if (end == parts[i].c_str() || *end != '\0' || value < 0) {
+			return false;
+		}
+		values.push_back(value);
+	}
+
+	if (parts[0] == "fixed" && values.size() == 1) {
+		distribution = Distribution(Fixed, values[0]);
+	} else if (parts[0] == "uniform" && values.size() == 2 && values[0] <= values[1]) {
+		distribution = Distribution(Uniform, values[0], values[1]);
+	} else if (parts[0] == "normal" && values.size() == 2) {
+		distribution = Distribution(Normal, values[0], values[1]);
+	} else if (parts[0] == "lognormal" && values.size() == 2 && values[0] > 0) {
+		distribution = Distribution(LogNormal, values[0], values[1]);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+std::chrono::microseconds Distribution::sample(std::mt19937_64 &rng) const
+{
+	double ms = 0;
+	switch (kind_) {
+	case Fixed:
+		ms = a_;
+		break;
+	case Uniform:
+		ms = std::uniform_real_distribution<double>(a_, b_)(rng);
+		break;
+	case Normal:
+		ms = std::normal_distribution<double>(a_, b_)(rng);
+		break;
+	case LogNormal:
+		ms = std::lognormal_distribution<double>(std::log(a_), b_)(rng);
+		break;
+	}
+	return std::chrono::microseconds(static_cast<long long>(std::max(ms, 0.0) * 1000));
+}
+
+// "<n>[K|M|G]", a positive count of bytes
+static bool parseBytes(const std::string &spec, uint64_t &bytes)
+{
+	char *end = nullptr;
+	double value = std::strtod(spec.c_str(), &end);
+	if (end == spec.c_str() || value <= 0) {
+		return false;
+	}
+	std::string suffix(end);
+	if (suffix == "K" || suffix == "k") {
+		value *= 1024;
+	} else if (suffix == "M" || suffix == "m") {
+		value *= 1024 * 1024;
+	} else if (suffix == "G" || suffix == "g") {
+		value *= 1024.0 * 1024 * 1024;
+	} else if (!suffix.empty()) {
+		return false;
+	}
+	bytes = std::max<uint64_t>(1, static_cast<uint64_t>(value));
+	return true;
+}
+
+static std::mutex advanced_config_mutex;
+static std::vector<std::pair<std::string, std::string>> advanced_config;
+
+bool Config::set(const std::string &key, const std::string &value)
+{
+	std::string name = key;
+	std::transform(name.begin(), name.end(), name.begin(), [](char c) { return (char)std::toupper(c); });
+
+	if (name == "ZIM_MOCK_SEND_LATENCY") {
+		return Distribution::parse(value, send_latency);
+	} else if (name == "ZIM_MOCK_RECEIPT_LATENCY") {
+		return Distribution::parse(value, receipt_latency);
+	} else if (name == "ZIM_MOCK_PUSH_LATENCY") {
+		return Distribution::parse(value, push_latency);
+	} else if (name == "ZIM_MOCK_LOGIN_LATENCY") {
+		return Distribution::parse(value, login_latency);
+	} else if (name == "ZIM_MOCK_ERROR_RATE") {
+		error_rate = std::atof(value.c_str());
+	} else if (name == "ZIM_MOCK_ERROR_CODE") {
+		error_code = (zim_error_code)std::atoi(value.c_str());
+	} else if (name == "ZIM_MOCK_DROP_RATE") {
+		drop_rate = std::atof(value.c_str());
+	} else if (name == "ZIM_MOCK_LOGIN_ERROR_RATE") {
+		login_error_rate = std::atof(value.c_str());
+	} else if (name == "ZIM_MOCK_CALLBACK_THREADS") {
+		callback_threads = std::max(1, std::atoi(value.c_str()));
+	} else if (name == "ZIM_MOCK_ROOM_DIR") {
+		room_dir = value;
+	} else if (name == "ZIM_MOCK_GROUP_DIR") {
+		group_dir = value;
+	} else if (name == "ZIM_MOCK_UPLOAD_BANDWIDTH") {
+		return parseBytes(value, upload_bandwidth);
+	} else if (name == "ZIM_MOCK_DOWNLOAD_BANDWIDTH") {
+		return parseBytes(value, download_bandwidth);
+	} else if (name == "ZIM_MOCK_PROGRESS_INTERVAL") {
+		progress_interval = std::max(1, std::atoi(value.c_str()));
+	} else if (name == "ZIM_MOCK_HISTORY_DIR") {
+		history_dir = value;
+	} else if (name == "ZIM_MOCK_CACHE_LATENCY") {
+		return Distribution::parse(value, cache_latency);
+	} else if (name == "ZIM_MOCK_ORDERED_CALLBACKS") {
+		ordered_callbacks = std::atoi(value.c_str()) != 0;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+Config Config::current()
+{
+	static const char *const kKeys[] = {
+		"ZIM_MOCK_SEND_LATENCY",     "ZIM_MOCK_LOGIN_LATENCY",    "ZIM_MOCK_ERROR_RATE",
+		"ZIM_MOCK_ERROR_CODE",       "ZIM_MOCK_LOGIN_ERROR_RATE", "ZIM_MOCK_CALLBACK_THREADS",
+		"ZIM_MOCK_ROOM_DIR",         "ZIM_MOCK_GROUP_DIR",        "ZIM_MOCK_DROP_RATE",
+		"ZIM_MOCK_RECEIPT_LATENCY",  "ZIM_MOCK_PUSH_LATENCY",     "ZIM_MOCK_UPLOAD_BANDWIDTH",
+		"ZIM_MOCK_DOWNLOAD_BANDWIDTH", "ZIM_MOCK_PROGRESS_INTERVAL", "ZIM_MOCK_HISTORY_DIR",
+		"ZIM_MOCK_CACHE_LATENCY",    "ZIM_MOCK_ORDERED_CALLBACKS",
+	};
+
+	Config config;
+	for (const char *key : kKeys) {
+		const char *value = std::getenv(key);
+		if (value && !config.set(key, value)) {
+			std::cerr << "[zim mock] ignoring invalid " << key << "=" << value << std::endl;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(advanced_config_mutex);
+	for (const auto &entry : advanced_config) {
+		if (!config.set(entry.first, entry.second)) {
+			std::cerr << "[zim mock] ignoring invalid " << entry.first << "=" << entry.second << std::endl;
+		}
+	}
+	return config;
+}
+
+// MARK: - Dispatcher
+
+Dispatcher::Dispatcher(int threads)
+{
+	for (int i = 0; i < threads; ++i) {
+		threads_.emplace_back(&Dispatcher::run, this);
+	}
+}
+
+Dispatcher::~Dispatcher() { stop(); }
+
+void Dispatcher::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+	}
+	cv_.notify_all();
+	for (auto &thread : threads_) {
+		if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+			thread.join();
+		}
+	}
+}
+
+void Dispatcher::post(std::chrono::microseconds delay, std::function<void()> task)
+{
+	postAt(Clock::now() + delay, std::move(task));
+}
+
+void Dispatcher::postAt(Clock::time_point due, std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks_.emplace(due, std::move(task));
+	}
+	cv_.notify_one();
+}
+
+void Dispatcher::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (!stopped_) {
+		if (tasks_.empty()) {
+			cv_.wait(lock);
+			continue;
+		}
+		auto due = tasks_.begin()->first;
+		if (Clock::now() < due) {
+			cv_.wait_until(lock, due);
+			continue;
+		}
+		auto task = std::move(tasks_.begin()->second);
+		tasks_.erase(tasks_.begin());
+		// a later task may already be due as well, let another thread pick it up
+		if (!tasks_.empty()) {
+			cv_.notify_one();
+		}
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+}
+
+// MARK: - Link
+
+void Link::reserve(uint64_t bytes, Clock::time_point &start, Clock::time_point &end)
+{
+	auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(double(bytes) /
+												bandwidth_));
+	std::lock_guard<std::mutex> lock(mutex_);
+	start = std::max(Clock::now(), free_);
+	end = start + duration;
+	free_ = end;
+}
+
+// MARK: - SendOrder
+
+uint64_t SendOrder::reserve()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.emplace_back();
+	return first_ + entries_.size() - 1;
+}
+
+void SendOrder::arm(uint64_t ticket, Clock::time_point due, std::function<void()> task)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Entry &entry = entries_[ticket - first_];
+	entry.armed = true;
+	entry.due = due;
+	entry.task = std::move(task);
+}
+
+void SendOrder::drain()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (draining_) {
+		return;
+	}
+	draining_ = true;
+	while (!entries_.empty() && entries_.front().armed && entries_.front().due <= Clock::now()) {
+		auto task = std::move(entries_.front().task);
+		entries_.pop_front();
+		++first_;
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+	draining_ = false;
+}
+
+// MARK: - Messages
+
+static char *zim_message::*const kStringFields[] = {
+	&zim_message::sender_user_id,
+	&zim_message::conversation_id,
+	&zim_message::extended_data,
+	&zim_message::local_extended_data,
+	&zim_message::message,
+	&zim_message::file_local_path,
+	&zim_message::file_download_url,
+	&zim_message::file_uid,
+	&zim_message::file_name,
+	&zim_message::large_image_download_url,
+	&zim_message::thumbnail_download_url,
+	&zim_message::large_image_local_path,
+	&zim_message::thumbnail_local_path,
+	&zim_message::video_first_frame_local_path,
+	&zim_message::video_first_frame_download_url,
+	&zim_message::operated_userid,
+	&zim_message::original_text_message,
+	&zim_message::revoke_extended_data,
+	&zim_message::searched_content,
+	&zim_message::combine_title,
+	&zim_message::combine_summary,
+	&zim_message::combine_id,
+};
+
+OwnedMessage::OwnedMessage(const zim_message &source) : message_(source)
+{
+	const size_t count = sizeof(kStringFields) / sizeof(kStringFields[0]);
+	strings_.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		const char *value = source.*kStringFields[i];
+		if (value) {
+			strings_[i] = value;
+		}
+		message_.*kStringFields[i] = &strings_[i][0];
+	}
+
+	if (source.command_message && source.command_message_length > 0) {
+		command_.assign(source.command_message, source.command_message + source.command_message_length);
+	}
+	command_.push_back(0);
+	message_.command_message = command_.data();
+
+	for (unsigned int i = 0; i < source.mentioned_user_ids_length; ++i) {
+		mentioned_.emplace_back(source.mentioned_user_ids[i] ? source.mentioned_user_ids[i] : "");
+	}
+	for (auto &user_id : mentioned_) {
+		mentioned_ptrs_.push_back(&user_id[0]);
+	}
+	message_.mentioned_user_ids = mentioned_ptrs_.empty() ? nullptr : mentioned_ptrs_.data();
+
+	message_.reactions = nullptr;
+	message_.reaction_length = 0;
+	message_.combine_message_list = nullptr;
+	message_.combine_message_list_length = 0;
+}
+
+// MARK: - Mailbox
+
+// larger messages do not fit into a datagram and are not delivered
+static const size_t kMaxDatagram = 200 * 1024;
+
+static bool mailboxAddress(const std::string &user_id, sockaddr_un &address, socklen_t &length)
+{
+	std::string name = "zim_mock." + user_id;
+	address = sockaddr_un();
+	address.sun_family = AF_UNIX;
+#ifdef __linux__
+	// abstract namespace, killed processes leave nothing behind in the file system
+	if (name.size() + 1 > sizeof(address.sun_path)) {
+		return false;
+	}
+	std::memcpy(address.sun_path + 1, name.data(), name.size());
+	length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+#else
+	std::string path = "/tmp/" + name;
+	if (path.size() + 1 > sizeof(address.sun_path)) {
+		return false;
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+	length = static_cast<socklen_t>(sizeof(address));
+#endif
+	return true;
+}
+
+// Both ends run on the same machine, so the wire format is just native integers and length prefixed
+// strings.
+class WireWriter {
+public:
+	void put(uint64_t value) { data_.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+	void put(const char *value)
+	{
+		size_t size = value ? std::strlen(value) : 0;
+		put(static_cast<uint64_t>(size));
+		data_.append(value ? value : "", size);
+	}
+	const std::string &data() const { return data_; }
+
+private:
+	std::string data_;
+};
+
+class WireReader {
+public:
+	WireReader(const char *data, size_t size) : data_(data), end_(data + size) {}
+
+	bool get(uint64_t &value)
+	{
+		if (size_t(end_ - data_) < sizeof(value)) {
+			return false;
+		}
+		std::memcpy(&value, data_, sizeof(value));
+		data_ += sizeof(value);
+		return true;
+	}
+	bool get(std::string &value)
+	{
+		uint64_t size = 0;
+		if (!get(size) || size_t(end_ - data_) < size) {
+			return false;
+		}
+		value.assign(data_, size);
+		data_ += size;
+		return true;
+	}
+
+private:
+	const char *data_;
+	const char *end_;
+};
+
+// what a datagram carries, the first integer of it
+enum DatagramKind : uint64_t { kMessageDatagram = 1, kReceiptDatagram = 2 };
+
+// One unbound socket per process sends to every mailbox. A receiver that does not keep up blocks the
+// sender's callback thread for a moment, then the message is dropped.
+static int deliverySocket()
+{
+	int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (fd >= 0) {
+		timeval timeout{0, 100 * 1000};
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		int size = 4 * 1024 * 1024;
+		setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+	}
+	return fd;
+}
+
+Mailbox::~Mailbox() { close(); }
+
+bool Mailbox::open(const std::string &user_id)
+{
+	close();
+	sockaddr_un address;
+	socklen_t length;
+	if (!mailboxAddress(user_id, address, length)) {
+		return false;
+	}
+	int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (fd < 0) {
+		return false;
+	}
+	int size = 4 * 1024 * 1024;
+	setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	if (bind(fd, reinterpret_cast<sockaddr *>(&address), length) != 0) {
+		::close(fd);
+		return false;
+	}
+	fd_ = fd;
+	stopped_ = false;
+	thread_ = std::thread(&Mailbox::run, this);
+	return true;
+}
+
+void Mailbox::close()
+{
+	stopped_ = true;
+	if (thread_.joinable()) {
+		// closed from a receive callback: the loop ends once the callback returns
+		if (thread_.get_id() == std::this_thread::get_id()) {
+			thread_.detach();
+		} else {
+			thread_.join();
+		}
+	}
+	if (fd_ >= 0) {
+		::close(fd_);
+		fd_ = -1;
+	}
+}
+
+std::vector<std::string> Mailbox::deliver(const zim_message &message, const std::vector<std::string> &user_ids)
+{
+	std::vector<std::string> unreachable;
+	WireWriter writer;
+	writer.put(static_cast<uint64_t>(kMessageDatagram));
+	writer.put(static_cast<uint64_t>(message.type));
+	writer.put(static_cast<uint64_t>(message.conversation_type));
+	writer.put(static_cast<uint64_t>(message.message_id));
+	writer.put(static_cast<uint64_t>(message.timestamp));
+	writer.put(static_cast<uint64_t>(message.conversation_seq));
+	writer.put(static_cast<uint64_t>(message.is_mention_all));
+	writer.put(static_cast<uint64_t>(message.receipt_status));
+	writer.put(message.sender_user_id);
+	// the receiver sees a peer conversation under the ID of the sender
+	writer.put(message.conversation_type == zim_conversation_type_peer ? message.sender_user_id
+									    : message.conversation_id);
+	writer.put(message.message);
+	writer.put(message.extended_data);
+	writer.put(message.file_uid);
+	writer.put(message.file_name);
+	writer.put(message.file_download_url);
+	writer.put(static_cast<uint64_t>(message.file_size));
+	writer.put(static_cast<uint64_t>(message.media_duration));
+	writer.put(static_cast<uint64_t>(message.mentioned_user_ids_length));
+	for (unsigned int i = 0; i < message.mentioned_user_ids_length; ++i) {
+		writer.put(message.mentioned_user_ids[i]);
+	}
+
+	const std::string &data = writer.data();
+	if (data.size() > kMaxDatagram) {
+		return unreachable;
+	}
+	static int fd = deliverySocket();
+	// barrages are not stored, a member that falls behind loses them instead of slowing the room down
+	int flags = message.type == zim_message_type_barrage ? MSG_NOSIGNAL | MSG_DONTWAIT : MSG_NOSIGNAL;
+	for (const auto &user_id : user_ids) {
+		sockaddr_un address;
+		socklen_t length;
+		if (user_id == message.sender_user_id || !mailboxAddress(user_id, address, length)) {
+			continue;
+		}
+		if (sendto(fd, data.data(), data.size(), flags, reinterpret_cast<sockaddr *>(&address), length) < 0 &&
+		    (errno == ECONNREFUSED || errno == ENOENT)) {
+			unreachable.push_back(user_id);
+		}
+	}
+	return unreachable;
+}
+
+void Mailbox::deliverReceipt(const std::string &user_id, const std::string &conversation_id,
+			     zim_conversation_type conversation_type, const std::vector<long long> &message_ids)
+{
+	WireWriter writer;
+	writer.put(static_cast<uint64_t>(kReceiptDatagram));
+	writer.put(static_cast<uint64_t>(conversation_type));
+	writer.put(conversation_id.c_str());
+	writer.put(static_cast<uint64_t>(message_ids.size()));
+	for (long long message_id : message_ids) {
+		writer.put(static_cast<uint64_t>(message_id));
+	}
+
+	const std::string &data = writer.data();
+	sockaddr_un address;
+	socklen_t length;
+	if (data.size() > kMaxDatagram || !mailboxAddress(user_id, address, length)) {
+		return;
+	}
+	static int fd = deliverySocket();
+	// a sender that logged out misses the receipt, like an offline one would until it logs in again
+	sendto(fd, data.data(), data.size(), MSG_NOSIGNAL, reinterpret_cast<sockaddr *>(&address), length);
+}
+
+static void receiveMessage(Instance *instance, WireReader &reader)
+{
+	uint64_t type, conversation_type, message_id, timestamp, conversation_seq, mention_all, receipt_status,
+		file_size, media_duration, mentioned_count;
+	std::string sender, conversation, text, extended_data, file_uid, file_name, file_url;
+	if (!reader.get(type) || !reader.get(conversation_type) || !reader.get(message_id) ||
+	    !reader.get(timestamp) || !reader.get(conversation_seq) || !reader.get(mention_all) ||
+	    !reader.get(receipt_status) || !reader.get(sender) || !reader.get(conversation) || !reader.get(text) ||
+	    !reader.get(extended_data) || !reader.get(file_uid) || !reader.get(file_name) || !reader.get(file_url) ||
+	    !reader.get(file_size) || !reader.get(media_duration) || !reader.get(mentioned_count)) {
+		return;
+	}
+	std::vector<std::string> mentioned(mentioned_count);
+	bool complete = true;
+	for (auto &user_id : mentioned) {
+		complete = complete && reader.get(user_id);
+	}
+	if (!complete) {
+		return;
+	}
+	std::vector<char *> mentioned_ptrs;
+	for (auto &user_id : mentioned) {
+		mentioned_ptrs.push_back(&user_id[0]);
+	}
+
+	zim_message message{};
+	message.type = static_cast<zim_message_type>(type);
+	message.conversation_type = static_cast<zim_conversation_type>(conversation_type);
+	message.message_id = static_cast<long long>(message_id);
+	message.local_message_id = message.message_id;
+	message.order_key = message.message_id;
+	message.timestamp = timestamp;
+	message.conversation_seq = static_cast<long long>(conversation_seq);
+	message.direction = zim_message_direction_receive;
+	message.sent_status = zim_message_sent_status_send_success;
+	message.receipt_status = static_cast<zim_message_receipt_status>(receipt_status);
+	message.is_mention_all = mention_all != 0;
+	message.sender_user_id = &sender[0];
+	message.conversation_id = &conversation[0];
+	message.message = &text[0];
+	message.extended_data = &extended_data[0];
+	message.file_uid = &file_uid[0];
+	message.file_name = &file_name[0];
+	message.file_download_url = &file_url[0];
+	message.file_size = file_size;
+	message.media_duration = media_duration;
+	message.mentioned_user_ids = mentioned_ptrs.empty() ? nullptr : mentioned_ptrs.data();
+	message.mentioned_user_ids_length = static_cast<unsigned int>(mentioned_ptrs.size());
+	// fills in the fields that are not on the wire
+	OwnedMessage owned(message);
+
+	if (message.conversation_type == zim_conversation_type_peer) {
+		auto callback = instance->callbacks().receive_peer_message;
+		if (callback) {
+			callback(instance->handle(), &owned.get(), 1, sender.c_str());
+		}
+	} else if (message.conversation_type == zim_conversation_type_room) {
+		auto callback = instance->callbacks().receive_room_message;
+		if (callback) {
+			callback(instance->handle(), &owned.get(), 1, conversation.c_str());
+		}
+	} else if (message.conversation_type == zim_conversation_type_group) {
+		auto callback = instance->callbacks().receive_group_message;
+		if (callback) {
+			callback(instance->handle(), &owned.get(), 1, conversation.c_str());
+		}
+	}
+}
+
+static void receiveReceipt(Instance *instance, WireReader &reader)
+{
+	uint64_t conversation_type, count;
+	std::string conversation;
+	if (!reader.get(conversation_type) || !reader.get(conversation) || !reader.get(count)) {
+		return;
+	}
+	std::vector<zim_message_receipt_info> infos;
+	for (uint64_t i = 0; i < count; ++i) {
+		uint64_t message_id;
+		if (!reader.get(message_id)) {
+			return;
+		}
+		zim_message_receipt_info info{};
+		info.status = zim_message_receipt_status_done;
+		info.message_id = static_cast<long long>(message_id);
+		info.conversation_id = &conversation[0];
+		info.conversation_type = static_cast<zim_conversation_type>(conversation_type);
+		info.read_member_count = 1;
+		infos.push_back(info);
+	}
+	auto callback = instance->callbacks().message_receipt_changed;
+	if (callback && !infos.empty()) {
+		callback(instance->handle(), false, infos.data(), static_cast<unsigned int>(infos.size()));
+	}
+}
+
+void Mailbox::run()
+{
+	std::vector<char> buffer(kMaxDatagram);
+	while (!stopped_) {
+		pollfd ready{fd_, POLLIN, 0};
+		if (::poll(&ready, 1, 100) <= 0) {
+			continue;
+		}
+		ssize_t received = recv(fd_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+		if (received <= 0) {
+			continue;
+		}
+
+		WireReader reader(buffer.data(), received);
+		uint64_t kind;
+		if (!reader.get(kind)) {
+			continue;
+		}
+		if (kind == kMessageDatagram) {
+			receiveMessage(instance_, reader);
+		} else if (kind == kReceiptDatagram) {
+			receiveReceipt(instance_, reader);
+		}
+	}
+}
+
+// MARK: - Rooms
+
+static std::string memberPath(const std::string &room_dir, const std::string &room_id, const std::string &user_id)
+{
+	return room_dir + "/" + room_id + "/" + user_id;
+}
+
+bool RoomDirectory::enter(const std::string &room_dir, const std::string &room_id, const std::string &user_id)
+{
+	mkdir(room_dir.c_str(), 0777);
+	mkdir((room_dir + "/" + room_id).c_str(), 0777);
+	std::ofstream member(memberPath(room_dir, room_id, user_id));
+	return member.good();
+}
+
+void RoomDirectory::leave(const std::string &room_dir, const std::string &room_id, const std::string &user_id)
+{
+	unlink(memberPath(room_dir, room_id, user_id).c_str());
+}
+
+// Member lists are cached per path and reloaded once the modification time of the path changed,
+// which is checked at most every 100ms.
+static std::shared_ptr<const std::vector<std::string>>
+cachedMembers(const std::string &path, void (*load)(const std::string &path, std::vector<std::string> &members))
+{
+	struct Cached {
+		std::shared_ptr<const std::vector<std::string>> members;
+		Dispatcher::Clock::time_point checked;
+		timespec modified{0, 0};
+	};
+	static std::mutex mutex;
+	static std::unordered_map<std::string, Cached> cache;
+
+	auto now = Dispatcher::Clock::now();
+	std::lock_guard<std::mutex> lock(mutex);
+	Cached &cached = cache[path];
+	if (cached.members && now - cached.checked < std::chrono::milliseconds(100)) {
+		return cached.members;
+	}
+	cached.checked = now;
+
+	struct stat status;
+	if (stat(path.c_str(), &status) != 0) {
+		cached.members = std::make_shared<const std::vector<std::string>>();
+		cached.modified = timespec{0, 0};
+		return cached.members;
+	}
+	if (cached.members && status.st_mtim.tv_sec == cached.modified.tv_sec &&
+	    status.st_mtim.tv_nsec == cached.modified.tv_nsec) {
+		return cached.members;
+	}
+	cached.modified = status.st_mtim;
+
+	auto members = std::make_shared<std::vector<std::string>>();
+	load(path, *members);
+	cached.members = members;
+	return cached.members;
+}
+
+static void loadRoomMembers(const std::string &path, std::vector<std::string> &members)
+{
+	if (DIR *directory = opendir(path.c_str())) {
+		while (dirent *entry = readdir(directory)) {
+			if (entry->d_name[0] != '.') {
+				members.push_back(entry->d_name);
+			}
+		}
+		closedir(directory);
+	}
+}
+
+std::shared_ptr<const std::vector<std::string>> RoomDirectory::members(const std::string &room_dir,
+								      const std::string &room_id)
+{
+	return cachedMembers(room_dir + "/" + room_id, loadRoomMembers);
+}
+
+static bool appendMembers(int fd, const std::vector<std::string> &user_ids)
+{
+	std::string lines;
+	for (const auto &user_id : user_ids) {
+		lines += user_id;
+		lines += '\n';
+	}
+	// one write per call, so concurrent appends from several processes do not interleave
+	bool written = write(fd, lines.data(), lines.size()) == ssize_t(lines.size());
+	close(fd);
+	return written;
+}
+
+bool GroupDirectory::create(const std::string &group_dir, const std::string &group_id,
+			    const std::vector<std::string> &user_ids)
+{
+	mkdir(group_dir.c_str(), 0777);
+	int fd = open((group_dir + "/" + group_id).c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND, 0666);
+	return fd >= 0 && appendMembers(fd, user_ids);
+}
+
+bool GroupDirectory::add(const std::string &group_dir, const std::string &group_id,
+			 const std::vector<std::string> &user_ids)
+{
+	int fd = open((group_dir + "/" + group_id).c_str(), O_WRONLY | O_APPEND);
+	return fd >= 0 && appendMembers(fd, user_ids);
+}
+
+bool GroupDirectory::dismiss(const std::string &group_dir, const std::string &group_id)
+{
+	return unlink((group_dir + "/" + group_id).c_str()) == 0;
+}
+
+static void loadGroupMembers(const std::string &path, std::vector<std::string> &members)
+{
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (!line.empty()) {
+			members.push_back(line);
+		}
+	}
+}
+
+std::shared_ptr<const std::vector<std::string>> GroupDirectory::members(const std::string &group_dir,
+								       const std::string &group_id)
+{
+	return cachedMembers(group_dir + "/" + group_id, loadGroupMembers);
+}
+
+// MARK: - History
+
+std::string HistoryStore::path(const std::string &history_dir, const std::string &user_id,
+			       const std::string &conversation_id, zim_conversation_type conversation_type)
+{
+	if (conversation_type == zim_conversation_type_group) {
+		return history_dir + "/group/" + conversation_id;
+	} else if (conversation_type == zim_conversation_type_peer) {
+		const std::string &first = std::min(user_id, conversation_id);
+		const std::string &second = std::max(user_id, conversation_id);
+		return history_dir + "/peer/" + first + "/" + second;
+	}
+	return "";
+}
+
+void HistoryStore::append(const std::string &path, const zim_message &message)
+{
+	WireWriter fields;
+	fields.put(static_cast<uint64_t>(message.type));
+	fields.put(static_cast<uint64_t>(message.message_id));
+	fields.put(static_cast<uint64_t>(message.timestamp));
+	fields.put(message.sender_user_id);
+	fields.put(message.message);
+	fields.put(message.extended_data);
+	WireWriter record;
+	record.put(static_cast<uint64_t>(fields.data().size()));
+	std::string data = record.data() + fields.data();
+
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+	if (fd < 0 && errno == ENOENT) {
+		// the first message of the conversation, mkdir -p
+		for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+			mkdir(path.substr(0, slash).c_str(), 0777);
+		}
+		fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+	}
+	if (fd < 0) {
+		return;
+	}
+	// one write per record, so concurrent appends from several processes do not interleave
+	if (write(fd, data.data(), data.size()) != ssize_t(data.size())) {
+		std::cerr << "[zim mock] failed to store a message in " << path << std::endl;
+	}
+	close(fd);
+}
+
+static std::string positionKey(const std::string &sender, long long message_id)
+{
+	return sender + "\n" + std::to_string(message_id);
+}
+
+std::shared_ptr<const HistoryStore::Conversation> HistoryStore::load(const std::string &path)
+{
+	static std::mutex mutex;
+	static std::unordered_map<std::string, std::shared_ptr<const Conversation>> cache;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &cached = cache[path];
+	if (!cached) {
+		cached = std::make_shared<const Conversation>();
+	}
+	struct stat status;
+	if (stat(path.c_str(), &status) != 0 || uint64_t(status.st_size) <= cached->offset) {
+		return cached;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	file.seekg(cached->offset);
+	std::string data(uint64_t(status.st_size) - cached->offset, '\0');
+	file.read(&data[0], data.size());
+	data.resize(file.gcount());
+
+	auto conversation = std::make_shared<Conversation>(*cached);
+	size_t offset = 0;
+	while (true) {
+		WireReader header(data.data() + offset, data.size() - offset);
+		uint64_t size = 0;
+		// a record being appended right now is read next time
+		if (!header.get(size) || data.size() - offset - sizeof(size) < size) {
+			break;
+		}
+		WireReader fields(data.data() + offset + sizeof(size), size);
+		uint64_t type, message_id, timestamp;
+		Record record;
+		if (fields.get(type) && fields.get(message_id) && fields.get(timestamp) && fields.get(record.sender) &&
+		    fields.get(record.text) && fields.get(record.extended_data)) {
+			record.type = static_cast<zim_message_type>(type);
+			record.message_id = static_cast<long long>(message_id);
+			record.timestamp = timestamp;
+			conversation->positions[positionKey(record.sender, record.message_id)] =
+				conversation->records.size();
+			conversation->records.push_back(std::move(record));
+		}
+		offset += sizeof(size) + size;
+	}
+	conversation->offset += offset;
+	cached = conversation;
+	return cached;
+}
+
+bool HistoryStore::find(const Conversation &conversation, const std::string &sender, long long message_id,
+			size_t &position)
+{
+	auto it = conversation.positions.find(positionKey(sender, message_id));
+	if (it == conversation.positions.end()) {
+		return false;
+	}
+	position = it->second;
+	return true;
+}
+
+// MARK: - Instance
+
+Instance::Instance(const Config &config)
+	: config_(config), uplink_(config.upload_bandwidth), downlink_(config.download_bandwidth),
+	  dispatcher_(config.callback_threads)
+{
+}
+
+zim_sequence Instance::nextSequence(zim_sequence *sequence)
+{
+	// like the SDK: keep the sequence chosen by the caller, assign one when it passes 0
+	if (sequence && *sequence != 0) {
+		return *sequence;
+	}
+	zim_sequence assigned = --sequence_;
+	if (sequence) {
+		*sequence = assigned;
+	}
+	return assigned;
+}
+
+bool Instance::roll(double rate)
+{
+	if (rate <= 0) {
+		return false;
+	}
+	return std::uniform_real_distribution<double>(0, 1)(threadRng()) < rate;
+}
+
+std::chrono::microseconds Instance::sample(const Distribution &distribution)
+{
+	return distribution.sample(threadRng());
+}
+
+void Instance::enteredRoom(const std::string &room_id)
+{
+	std::lock_guard<std::mutex> lock(rooms_mutex_);
+	if (std::find(rooms_.begin(), rooms_.end(), room_id) == rooms_.end()) {
+		rooms_.push_back(room_id);
+	}
+}
+
+void Instance::leftRoom(const std::string &room_id)
+{
+	std::lock_guard<std::mutex> lock(rooms_mutex_);
+	rooms_.erase(std::remove(rooms_.begin(), rooms_.end(), room_id), rooms_.end());
+	RoomDirectory::leave(config_.room_dir, room_id, user_id);
+}
+
+std::shared_ptr<SendOrder> Instance::sendOrder(zim_conversation_type conversation_type,
+					       const std::string &conversation_id)
+{
+	std::lock_guard<std::mutex> lock(orders_mutex_);
+	auto &order = orders_[std::to_string(conversation_type) + ":" + conversation_id];
+	if (!order) {
+		order = std::make_shared<SendOrder>();
+	}
+	return order;
+}
+
+void Instance::loggedIn() { logged_in_at_ = nowMillis(); }
+
+bool Instance::hasHistory(const std::string &path, const HistoryStore::Conversation &conversation, size_t begin,
+			  size_t end)
+{
+	std::lock_guard<std::mutex> lock(history_mutex_);
+	std::vector<bool> &fetched = fetched_[path];
+	fetched.resize(std::max(fetched.size(), conversation.records.size()));
+	bool has = true;
+	for (size_t position = begin; position < end; ++position) {
+		has = has && (fetched[position] || conversation.records[position].timestamp >= logged_in_at_);
+		fetched[position] = true;
+	}
+	return has;
+}
+
+void Instance::leaveRooms()
+{
+	std::lock_guard<std::mutex> lock(rooms_mutex_);
+	for (const auto &room_id : rooms_) {
+		RoomDirectory::leave(config_.room_dir, room_id, user_id);
+	}
+	rooms_.clear();
+}
+
+static std::mutex instances_mutex;
+static std::vector<Instance *> instances;
+
+Instance *instanceOf(zim_handle handle)
+{
+	std::lock_guard<std::mutex> lock(instances_mutex);
+	auto it = std::find(instances.begin(), instances.end(), static_cast<Instance *>(handle));
+	return it == instances.end() ? nullptr : *it;
+}
+
+unsigned long long nowMillis()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		       std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+static std::mutex paths_mutex;
+static std::string log_path;
+static unsigned long long log_size = 5 * 1024 * 1024;
+static std::string cache_path;
+
+static void connectionStateChanged(Instance *instance, zim_connection_state state, zim_connection_event event)
+{
+	auto callback = instance->callbacks().connection_state_changed;
+	if (callback) {
+		callback(instance->handle(), state, event, "");
+	}
+}
+
+} // namespace zim_mock
+
+using namespace zim_mock;
+
+// MARK: - Main
+
+const char *ZIM_CALL zim_get_version(void) { return "2.14.0.2416-mock"; }
+
+// Instances the caller never destroys would keep calling into the SDK wrapper while its statics are
+// destroyed at exit, so the callback threads are stopped first. Registered after those statics were
+// constructed, the handler runs before their destructors.
+static void stopInstancesAtExit()
+{
+	std::lock_guard<std::mutex> lock(instances_mutex);
+	for (auto instance : instances) {
+		instance->dispatcher().stop();
+		instance->mailbox().close();
+		instance->leaveRooms();
+	}
+}
+
+void ZIM_CALL zim_create(zim_handle *handle, unsigned int app_id, const char *app_sign)
+{
+	static std::once_flag at_exit;
+	std::call_once(at_exit, [] { std::atexit(stopInstancesAtExit); });
+
+	auto instance = new Instance(Config::current());
+	{
+		std::lock_guard<std::mutex> lock(instances_mutex);
+		instances.push_back(instance);
+	}
+	*handle = instance->handle();
+}
+
+void ZIM_CALL zim_get_instance(zim_handle *handle)
+{
+	std::lock_guard<std::mutex> lock(instances_mutex);
+	*handle = instances.empty() ? nullptr : instances.back();
+}
+
+void ZIM_CALL zim_destroy(zim_handle *handle)
+{
+	Instance *instance = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(instances_mutex);
+		auto it = std::find(instances.begin(), instances.end(), static_cast<Instance *>(*handle));
+		if (it == instances.end()) {
+			return;
+		}
+		instance = *it;
+		instances.erase(it);
+	}
+	// joins the callback threads, pending callbacks are dropped like they are by the SDK
+	delete instance;
+	*handle = nullptr;
+}
+
+void ZIM_CALL zim_set_log_config(struct zim_log_config config)
+{
+	std::lock_guard<std::mutex> lock(paths_mutex);
+	log_path = config.log_path ? config.log_path : "";
+	if (config.log_size != 0) {
+		log_size = config.log_size;
+	}
+}
+
+const char *ZIM_CALL zim_get_log_path(void)
+{
+	std::lock_guard<std::mutex> lock(paths_mutex);
+	return log_path.c_str();
+}
+
+unsigned long long ZIM_CALL zim_get_log_size(void)
+{
+	std::lock_guard<std::mutex> lock(paths_mutex);
+	return log_size;
+}
+
+void ZIM_CALL zim_set_cache_config(struct zim_cache_config config)
+{
+	std::lock_guard<std::mutex> lock(paths_mutex);
+	cache_path = config.cache_path ? config.cache_path : "";
+}
+
+const char *ZIM_CALL zim_get_cache_path(void)
+{
+	std::lock_guard<std::mutex> lock(paths_mutex);
+	return cache_path.c_str();
+}
+
+void ZIM_CALL zim_set_advanced_config(const char *key, const char *value)
+{
+	if (!key || !value) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(advanced_config_mutex);
+	advanced_config.emplace_back(key, value);
+}
+
+void ZIM_CALL zim_register_logged_in_callback(zim_handle handle, zim_on_logged_in_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().logged_in = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_error_event(zim_handle handle, zim_on_error_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().error = event_function;
+	}
+}
+
+void ZIM_CALL zim_register_connection_state_changed_event(zim_handle handle,
+							  zim_on_connection_state_changed_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().connection_state_changed = event_function;
+	}
+}
+
+void ZIM_CALL zim_login(zim_handle handle, const char *user_id, struct zim_login_config config,
+			zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	instance->user_id = user_id ? user_id : "";
+	connectionStateChanged(instance, zim_connection_state_connecting, zim_connection_event_active_login);
+
+	bool failed = instance->roll(instance->config().login_error_rate);
+	instance->dispatcher().post(instance->sample(instance->config().login_latency), [instance, seq, failed]() {
+		zim_error error{};
+		if (failed) {
+			error.code = zim_error_code_network_module_common_error;
+			error.message = "mock: injected login failure";
+			connectionStateChanged(instance, zim_connection_state_disconnected,
+					       zim_connection_event_login_timeout);
+		} else {
+			error.code = zim_error_code_success;
+			error.message = "";
+			instance->loggedIn();
+			if (!instance->mailbox().open(instance->user_id)) {
+				std::cerr << "[zim mock] " << instance->user_id
+					  << " is logged in by another instance, no messages are delivered to this one"
+					  << std::endl;
+			}
+			connectionStateChanged(instance, zim_connection_state_connected, zim_connection_event_success);
+		}
+		if (instance->callbacks().logged_in) {
+			instance->callbacks().logged_in(instance->handle(), error, seq);
+		}
+	});
+}
+
+void ZIM_CALL zim_logout(zim_handle handle)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->mailbox().close();
+		instance->leaveRooms();
+		connectionStateChanged(instance, zim_connection_state_disconnected, zim_connection_event_success);
+	}
+}
+
+// MARK: - Message
+
+void ZIM_CALL zim_register_message_sent_callback(zim_handle handle, zim_on_message_sent_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().message_sent = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_message_attached_callback(zim_handle handle,
+						     zim_on_message_attached_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().message_attached = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_receive_peer_message_event(zim_handle handle,
+						       zim_on_receive_peer_message_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().receive_peer_message = event_function;
+	}
+}
+
+// Fills in what the SDK sets on a message it is about to send.
+static void prepareSend(Instance *instance, zim_message &message, const char *to_conversation_id,
+			zim_conversation_type conversation_type, const zim_message_send_config &config)
+{
+	message.conversation_id = const_cast<char *>(to_conversation_id ? to_conversation_id : "");
+	message.conversation_type = conversation_type;
+	message.sender_user_id = const_cast<char *>(instance->user_id.c_str());
+	message.direction = zim_message_direction_send;
+	message.sent_status = zim_message_sent_status_sending;
+	message.local_message_id = instance->nextMessageID();
+	message.timestamp = nowMillis();
+	message.receipt_status = config.has_receipt ? zim_message_receipt_status_processing
+						    : zim_message_receipt_status_none;
+}
+
+// the round trip of a send, with the extra work of the server for a receipt or an offline push
+static std::chrono::microseconds sendLatency(Instance *instance, const zim_message_send_config &config)
+{
+	auto latency = instance->sample(instance->config().send_latency);
+	if (config.has_receipt) {
+		latency += instance->sample(instance->config().receipt_latency);
+	}
+	if (config.enable_offline_push) {
+		latency += instance->sample(instance->config().push_latency);
+	}
+	return latency;
+}
+
+// Fills in what the server answers to a send, with `code` unless it is zim_error_code_success.
+static zim_error finishSend(zim_message &sent, zim_error_code code, const char *reason)
+{
+	zim_error error{};
+	if (code != zim_error_code_success) {
+		error.code = code;
+		error.message = reason;
+		sent.sent_status = zim_message_sent_status_send_failed;
+	} else {
+		error.code = zim_error_code_success;
+		error.message = "";
+		sent.sent_status = zim_message_sent_status_send_success;
+		sent.message_id = sent.local_message_id;
+		sent.order_key = sent.local_message_id;
+		sent.conversation_seq = sent.local_message_id;
+	}
+	return error;
+}
+
+// Hands a successful send to the members of the conversation and to its history.
+static void deliverSend(Instance *instance, const zim_message &sent)
+{
+	if (sent.conversation_type == zim_conversation_type_peer) {
+		Mailbox::deliver(sent, std::vector<std::string>{sent.conversation_id});
+	} else if (sent.conversation_type == zim_conversation_type_room) {
+		const std::string &room_dir = instance->config().room_dir;
+		auto members = RoomDirectory::members(room_dir, sent.conversation_id);
+		// members of killed processes never left, drop them
+		for (const auto &user_id : Mailbox::deliver(sent, *members)) {
+			RoomDirectory::leave(room_dir, sent.conversation_id, user_id);
+		}
+	} else if (sent.conversation_type == zim_conversation_type_group) {
+		// offline group members would get the message later, there is no later in a benchmark
+		auto members = GroupDirectory::members(instance->config().group_dir, sent.conversation_id);
+		Mailbox::deliver(sent, *members);
+	}
+	const std::string &history_dir = instance->config().history_dir;
+	if (!history_dir.empty() && sent.type == zim_message_type_text) {
+		std::string path = HistoryStore::path(history_dir, instance->user_id, sent.conversation_id,
+						      sent.conversation_type);
+		if (!path.empty()) {
+			HistoryStore::append(path, sent);
+		}
+	}
+}
+
+static void callBackSend(Instance *instance, const zim_message &sent, const zim_error &error, zim_sequence seq)
+{
+	if (instance->callbacks().message_sent) {
+		instance->callbacks().message_sent(instance->handle(), sent, error, seq);
+	}
+}
+
+// Runs `task` for the send of `ticket` at `due` at the earliest, after the sends to the conversation
+// before it.
+static void completeInOrder(Instance *instance, const std::shared_ptr<SendOrder> &order, uint64_t ticket,
+			    Dispatcher::Clock::time_point due, std::function<void()> task)
+{
+	order->arm(ticket, due, std::move(task));
+	instance->dispatcher().postAt(due, [order]() { order->drain(); });
+}
+
+// Completes the send of `ticket` with `code` at `due`. The sent callback comes at `due` itself, the delivery
+// to the conversation after the sends before it, see SendOrder. With ZIM_MOCK_ORDERED_CALLBACKS the callback
+// waits for them as well. The owned message is final before either runs, they only read it.
+static void completeSend(Instance *instance, const std::shared_ptr<OwnedMessage> &owned, zim_sequence seq,
+			 const std::shared_ptr<SendOrder> &order, uint64_t ticket, Dispatcher::Clock::time_point due,
+			 zim_error_code code, const char *reason)
+{
+	zim_error error = finishSend(owned->get(), code, reason);
+	bool delivered = code == zim_error_code_success;
+	bool ordered = instance->config().ordered_callbacks;
+	completeInOrder(instance, order, ticket, due, [instance, owned, seq, error, delivered, ordered]() {
+		if (delivered) {
+			deliverSend(instance, owned->get());
+		}
+		if (ordered) {
+			callBackSend(instance, owned->get(), error, seq);
+		}
+	});
+	if (!ordered) {
+		instance->dispatcher().postAt(
+			due, [instance, owned, seq, error]() { callBackSend(instance, owned->get(), error, seq); });
+	}
+}
+
+// The SDK attaches the local message first; whatever `send` queues only runs afterwards, so the two never
+// touch the owned copy concurrently.
+static void attachThen(Instance *instance, const std::shared_ptr<OwnedMessage> &owned, zim_sequence seq,
+		       std::function<void()> send)
+{
+	if (!instance->callbacks().message_attached) {
+		send();
+		return;
+	}
+	instance->dispatcher().post(std::chrono::microseconds(0), [instance, owned, seq, send]() {
+		instance->callbacks().message_attached(instance->handle(), owned->get(), seq);
+		send();
+	});
+}
+
+void ZIM_CALL zim_send_message(zim_handle handle, struct zim_message message, const char *to_conversation_id,
+			       enum zim_conversation_type conversation_type, struct zim_message_send_config config,
+			       zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	prepareSend(instance, message, to_conversation_id, conversation_type, config);
+	auto owned = std::make_shared<OwnedMessage>(message);
+
+	bool failed = instance->roll(instance->config().error_rate);
+	bool dropped = instance->roll(instance->config().drop_rate);
+	auto due = Dispatcher::Clock::now() + sendLatency(instance, config);
+	auto order = instance->sendOrder(conversation_type, owned->get().conversation_id);
+	uint64_t ticket = order->reserve();
+	attachThen(instance, owned, seq, [instance, owned, seq, order, ticket, due, failed, dropped]() {
+		if (dropped) {
+			// lost on the way, the SDK keeps waiting for the ack; the conversation goes on without it
+			completeInOrder(instance, order, ticket, due, []() {});
+			return;
+		}
+		zim_error_code code = failed ? instance->config().error_code : zim_error_code_success;
+		completeSend(instance, owned, seq, order, ticket, due, code, "mock: injected send failure");
+	});
+}
+
+// MARK: - Media
+
+typedef void (*TransferProgress)(zim_handle handle, const struct zim_message message, long long current_file_size,
+				 long long total_file_size, zim_sequence sequence);
+
+static const char kMockURLPrefix[] = "mock://";
+
+// One progress callback of a transfer of the file size of the message over [start, end], then the next
+// one a progress interval later. The last one reports the whole file and runs `done`. Each step queues
+// the next, so the callbacks of a transfer never overlap.
+static void transferStep(Instance *instance, std::shared_ptr<OwnedMessage> owned, zim_sequence seq,
+			 Link::Clock::time_point start, Link::Clock::time_point end, TransferProgress progress,
+			 std::function<void()> done)
+{
+	auto now = Link::Clock::now();
+	long long total = static_cast<long long>(owned->get().file_size);
+	long long current = total;
+	if (now < end) {
+		current = static_cast<long long>(total * std::chrono::duration<double>(now - start).count() /
+						 std::chrono::duration<double>(end - start).count());
+	}
+	if (progress) {
+		progress(instance->handle(), owned->get(), current, total, seq);
+	}
+	if (now >= end) {
+		done();
+		return;
+	}
+	auto next = std::min(end, now + std::chrono::milliseconds(instance->config().progress_interval));
+	instance->dispatcher().postAt(next, [instance, owned, seq, start, end, progress, done]() {
+		transferStep(instance, owned, seq, start, end, progress, done);
+	});
+}
+
+// queues the transfer of the file of `owned` behind the others on `link`
+static void transfer(Instance *instance, Link &link, const std::shared_ptr<OwnedMessage> &owned, zim_sequence seq,
+		     TransferProgress progress, std::function<void()> done)
+{
+	Link::Clock::time_point start, end;
+	link.reserve(owned->get().file_size, start, end);
+	auto first = std::min(end, start + std::chrono::milliseconds(instance->config().progress_interval));
+	instance->dispatcher().postAt(first, [instance, owned, seq, start, end, progress, done]() {
+		transferStep(instance, owned, seq, start, end, progress, done);
+	});
+}
+
+void ZIM_CALL zim_register_media_uploading_progress_callback(zim_handle handle,
+							     zim_on_media_uploading_progress_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().media_uploading_progress = callback_function;
+	}
+}
+
+void ZIM_CALL zim_send_media_message(zim_handle handle, struct zim_message message,
+				     const char *to_conversation_id, enum zim_conversation_type conversation_type,
+				     struct zim_message_send_config config, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	prepareSend(instance, message, to_conversation_id, conversation_type, config);
+
+	std::string path = message.file_local_path ? message.file_local_path : "";
+	struct stat status;
+	bool exists = !path.empty() && ::stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode);
+	std::string name = path.substr(path.find_last_of('/') + 1);
+	std::string uid = "mock-" + instance->user_id + "-" + std::to_string(message.local_message_id);
+	std::string url = kMockURLPrefix + path;
+	message.file_size = exists ? static_cast<unsigned long long>(status.st_size) : 0;
+	message.file_name = &name[0];
+	message.file_uid = &uid[0];
+	message.file_download_url = &url[0];
+	auto owned = std::make_shared<OwnedMessage>(message);
+
+	bool failed = instance->roll(instance->config().error_rate);
+	bool dropped = instance->roll(instance->config().drop_rate);
+	auto latency = sendLatency(instance, config);
+	auto order = instance->sendOrder(conversation_type, owned->get().conversation_id);
+	// the message itself goes out once the file is up, and takes its place in the conversation then
+	auto send = [instance, owned, seq, order, latency, exists, failed, dropped]() {
+		uint64_t ticket = order->reserve();
+		auto due = Dispatcher::Clock::now() + latency;
+		if (!exists) {
+			completeSend(instance, owned, seq, order, ticket, due,
+				     zim_error_code_message_module_file_not_exist, "mock: the file does not exist");
+		} else if (dropped) {
+			completeInOrder(instance, order, ticket, due, []() {});
+		} else {
+			completeSend(instance, owned, seq, order, ticket, due,
+				     failed ? instance->config().error_code : zim_error_code_success,
+				     "mock: injected send failure");
+		}
+	};
+	attachThen(instance, owned, seq, [instance, owned, seq, exists, send]() {
+		if (!exists) {
+			send();
+			return;
+		}
+		auto progress = instance->callbacks().media_uploading_progress;
+		transfer(instance, instance->uplink(), owned, seq, progress, send);
+	});
+}
+
+void ZIM_CALL zim_register_media_downloading_progress_callback(
+	zim_handle handle, zim_on_media_downloading_progress_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().media_downloading_progress = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_media_downloaded_callback(zim_handle handle,
+						     zim_on_media_downloaded_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().media_downloaded = callback_function;
+	}
+}
+
+// Every file type is the whole file: the mock has no large images, thumbnails or first frames.
+void ZIM_CALL zim_download_media_file(zim_handle handle, struct zim_message message, enum zim_media_file_type file_type,
+				      zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string url = message.file_download_url ? message.file_download_url : "";
+	bool found = url.compare(0, sizeof(kMockURLPrefix) - 1, kMockURLPrefix) == 0;
+	// "downloaded" to where the sender has the file, on this machine
+	std::string path = found ? url.substr(sizeof(kMockURLPrefix) - 1) : "";
+	message.file_local_path = &path[0];
+	auto owned = std::make_shared<OwnedMessage>(message);
+
+	std::function<void()> done = [instance, owned, seq, found]() {
+		zim_error error{};
+		error.code = found ? zim_error_code_success : zim_error_code_message_module_file_download_url_not_found;
+		error.message = found ? "" : "mock: not a mock:// download URL";
+		if (instance->callbacks().media_downloaded) {
+			instance->callbacks().media_downloaded(instance->handle(), owned->get(), error, seq);
+		}
+	};
+	// the request goes out before the file comes back
+	instance->dispatcher().post(instance->sample(instance->config().send_latency), [instance, owned, seq, found,
+											  done]() {
+		if (!found) {
+			done();
+			return;
+		}
+		transfer(instance, instance->downlink(), owned, seq, instance->callbacks().media_downloading_progress,
+			 done);
+	});
+}
+
+// MARK: - Receipt
+
+void ZIM_CALL zim_register_message_receipts_read_sent_callback(
+	zim_handle handle, zim_on_message_receipts_read_sent_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().message_receipts_read_sent = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_message_receipt_changed_event(zim_handle handle,
+							 zim_on_message_receipt_changed_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().message_receipt_changed = event_function;
+	}
+}
+
+// A round trip like a send, then each sender hears about the messages of its own that were read. A failed
+// call lists every message as failed and tells nobody.
+void ZIM_CALL zim_send_message_receipts_read(zim_handle handle, struct zim_message *message_list,
+					     unsigned int message_list_length, const char *conversation_id,
+					     enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string conversation = conversation_id ? conversation_id : "";
+	std::map<std::string, std::vector<long long>> by_sender;
+	std::vector<long long> message_ids;
+	for (unsigned int i = 0; i < message_list_length; ++i) {
+		const zim_message &message = message_list[i];
+		if (message.sender_user_id && instance->user_id != message.sender_user_id) {
+			by_sender[message.sender_user_id].push_back(message.message_id);
+		}
+		message_ids.push_back(message.message_id);
+	}
+
+	bool failed = instance->roll(instance->config().error_rate);
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, conversation, conversation_type, by_sender,
+					      message_ids, failed]() {
+		zim_error error{};
+		error.code = zim_error_code_success;
+		error.message = "";
+		if (failed) {
+			error.code = instance->config().error_code;
+			error.message = "mock: injected receipts read failure";
+		} else {
+			// the sender of a peer message knows the conversation by the reader
+			const std::string &seen = conversation_type == zim_conversation_type_peer ? instance->user_id
+												    : conversation;
+			for (const auto &sender : by_sender) {
+				Mailbox::deliverReceipt(sender.first, seen, conversation_type, sender.second);
+			}
+		}
+		if (instance->callbacks().message_receipts_read_sent) {
+			instance->callbacks().message_receipts_read_sent(
+				instance->handle(), conversation.c_str(), conversation_type,
+				failed ? message_ids.data() : nullptr,
+				failed ? static_cast<unsigned int>(message_ids.size()) : 0, error, seq);
+		}
+	});
+}
+
+// MARK: - Room
+
+void ZIM_CALL zim_register_room_entered_callback(zim_handle handle, zim_on_room_entered_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().room_entered = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_room_left_callback(zim_handle handle, zim_on_room_left_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().room_left = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_receive_room_message_event(zim_handle handle,
+						       zim_on_receive_room_message_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().receive_room_message = event_function;
+	}
+}
+
+// enterRoom and leaveRoom take a round trip like a send
+void ZIM_CALL zim_enter_room(zim_handle handle, struct zim_room_info room_info, struct zim_room_advanced_config *config,
+			     zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string room_id = room_info.room_id ? room_info.room_id : "";
+	std::string room_name = room_info.room_name ? room_info.room_name : "";
+
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, room_id, room_name]() {
+		zim_error error{};
+		error.message = "";
+		zim_room_full_info info{};
+		info.base_info.room_id = const_cast<char *>(room_id.c_str());
+		info.base_info.room_name = const_cast<char *>(room_name.c_str());
+		if (!room_id.empty() && RoomDirectory::enter(instance->config().room_dir, room_id, instance->user_id)) {
+			instance->enteredRoom(room_id);
+			error.code = zim_error_code_success;
+		} else {
+			error.code = zim_error_code_room_module_create_room_error;
+			error.message = "mock: can not enter the room";
+			info.base_info.room_id = const_cast<char *>("");
+		}
+		if (instance->callbacks().room_entered) {
+			instance->callbacks().room_entered(instance->handle(), info, error, seq);
+		}
+	});
+}
+
+void ZIM_CALL zim_leave_room(zim_handle handle, const char *room_id, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string room = room_id ? room_id : "";
+
+	instance->dispatcher().post(instance->sample(instance->config().send_latency), [instance, seq, room]() {
+		instance->leftRoom(room);
+		zim_error error{};
+		error.code = zim_error_code_success;
+		error.message = "";
+		if (instance->callbacks().room_left) {
+			instance->callbacks().room_left(instance->handle(), room.c_str(), error, seq);
+		}
+	});
+}
+
+// MARK: - Group
+
+void ZIM_CALL zim_register_group_created_callback(zim_handle handle, zim_on_group_created_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().group_created = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_group_users_invited_callback(zim_handle handle,
+							 zim_on_group_users_invited_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().group_users_invited = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_group_dismissed_callback(zim_handle handle,
+						     zim_on_group_dismissed_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().group_dismissed = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_receive_group_message_event(zim_handle handle,
+							zim_on_receive_group_message_event event_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().receive_group_message = event_function;
+	}
+}
+
+static std::vector<std::string> userIDs(const char **user_ids, unsigned int user_ids_length)
+{
+	std::vector<std::string> ids;
+	for (unsigned int i = 0; i < user_ids_length; ++i) {
+		if (user_ids[i] && user_ids[i][0] != '\0') {
+			ids.emplace_back(user_ids[i]);
+		}
+	}
+	return ids;
+}
+
+// Member infos of `user_ids` for the created and invited callbacks. The strings point into `user_ids`.
+static std::vector<zim_group_member_info> memberInfos(const std::vector<std::string> &user_ids)
+{
+	std::vector<zim_group_member_info> infos(user_ids.size());
+	for (size_t i = 0; i < user_ids.size(); ++i) {
+		infos[i].user_id = const_cast<char *>(user_ids[i].c_str());
+		infos[i].user_name = const_cast<char *>(user_ids[i].c_str());
+		infos[i].member_nick_name = const_cast<char *>("");
+		infos[i].member_avatar_url = const_cast<char *>("");
+		infos[i].member_role = 3;
+	}
+	return infos;
+}
+
+// group requests take a round trip like a send
+void ZIM_CALL zim_create_group(zim_handle handle, struct zim_group_info group_info, const char **user_ids,
+			       unsigned int user_ids_length, struct zim_group_advanced_config *config,
+			       zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string group_id = group_info.group_id ? group_info.group_id : "";
+	std::string group_name = group_info.group_name ? group_info.group_name : "";
+	std::vector<std::string> members = userIDs(user_ids, user_ids_length);
+
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, group_id, group_name, members]() {
+		std::vector<std::string> all = members;
+		all.insert(all.begin(), instance->user_id);
+
+		zim_error error{};
+		error.message = "";
+		if (group_id.empty()) {
+			error.code = zim_error_code_group_module_create_group_error;
+			error.message = "mock: the group ID is empty";
+		} else if (!GroupDirectory::create(instance->config().group_dir, group_id, all)) {
+			error.code = zim_error_code_group_module_group_already_exists;
+			error.message = "mock: the group exists already";
+		} else {
+			error.code = zim_error_code_success;
+		}
+
+		zim_group_full_info info{};
+		info.base_info.group_id = const_cast<char *>(group_id.c_str());
+		info.base_info.group_name = const_cast<char *>(group_name.c_str());
+		info.base_info.group_avatar_url = const_cast<char *>("");
+		info.group_notice = const_cast<char *>("");
+		if (error.code != zim_error_code_success) {
+			all.clear();
+		}
+		auto infos = memberInfos(all);
+		if (instance->callbacks().group_created) {
+			instance->callbacks().group_created(instance->handle(), info, infos.data(),
+							    static_cast<unsigned int>(infos.size()), nullptr, 0, error,
+							    seq);
+		}
+	});
+}
+
+void ZIM_CALL zim_invite_users_into_group(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+					  const char *group_id, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string group = group_id ? group_id : "";
+	std::vector<std::string> members = userIDs(user_ids, user_ids_length);
+
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, group, members]() mutable {
+		zim_error error{};
+		error.message = "";
+		if (GroupDirectory::add(instance->config().group_dir, group, members)) {
+			error.code = zim_error_code_success;
+		} else {
+			error.code = zim_error_code_group_module_group_does_not_exist;
+			error.message = "mock: the group does not exist";
+		}
+		if (error.code != zim_error_code_success) {
+			members.clear();
+		}
+		auto infos = memberInfos(members);
+		if (instance->callbacks().group_users_invited) {
+			instance->callbacks().group_users_invited(instance->handle(), group.c_str(), infos.data(),
+								  static_cast<unsigned int>(infos.size()), nullptr, 0,
+								  error, seq);
+		}
+	});
+}
+
+void ZIM_CALL zim_dismiss_group(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string group = group_id ? group_id : "";
+
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, group]() {
+		zim_error error{};
+		error.message = "";
+		if (GroupDirectory::dismiss(instance->config().group_dir, group)) {
+			error.code = zim_error_code_success;
+		} else {
+			error.code = zim_error_code_group_module_group_does_not_exist;
+			error.message = "mock: the group does not exist";
+		}
+		if (instance->callbacks().group_dismissed) {
+			instance->callbacks().group_dismissed(instance->handle(), group.c_str(), error, seq);
+		}
+	});
+}
+
+// MARK: - Query
+
+// Nothing is stored, every query completes after a round trip with an empty page.
+
+void ZIM_CALL zim_register_message_queried_callback(zim_handle handle,
+						     zim_on_message_queried_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().message_queried = callback_function;
+	}
+}
+
+void ZIM_CALL zim_register_conversation_list_queried_callback(
+	zim_handle handle, zim_on_conversation_list_queried_callback callback_function)
+{
+	if (auto instance = instanceOf(handle)) {
+		instance->callbacks().conversation_list_queried = callback_function;
+	}
+}
+
+void ZIM_CALL zim_query_history_message(zim_handle handle, const char *conversation_id,
+				       enum zim_conversation_type conversation_type,
+				       struct zim_message_query_config config, zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+	std::string conversation = conversation_id ? conversation_id : "";
+
+	// the page [begin, end) of the stored history, oldest first whichever way it is walked
+	std::string path;
+	if (!instance->config().history_dir.empty()) {
+		path = HistoryStore::path(instance->config().history_dir, instance->user_id, conversation,
+					  conversation_type);
+	}
+	auto history = path.empty() ? std::make_shared<const HistoryStore::Conversation>() : HistoryStore::load(path);
+	size_t size = history->records.size();
+	size_t cursor = config.reverse ? size : 0;
+	bool found = true;
+	if (config.next_message) {
+		const char *sender = config.next_message->sender_user_id ? config.next_message->sender_user_id : "";
+		size_t position = 0;
+		found = HistoryStore::find(*history, sender, config.next_message->message_id, position);
+		cursor = config.reverse ? position : position + 1;
+	}
+	size_t begin = found && config.reverse ? cursor - std::min<size_t>(cursor, config.count) : cursor;
+	size_t end = found && !config.reverse ? std::min<size_t>(size, cursor + config.count) : cursor;
+
+	// only the server knows whether a short page is the start (or end) of the conversation
+	bool cached = config.count > 0 && end - begin == config.count &&
+		      instance->hasHistory(path, *history, begin, end);
+	auto latency = instance->sample(cached ? instance->config().cache_latency : instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq, conversation, conversation_type, history, begin, end]() {
+		std::vector<std::unique_ptr<OwnedMessage>> owned;
+		std::vector<zim_message> messages;
+		for (size_t position = begin; position < end; ++position) {
+			const HistoryStore::Record &record = history->records[position];
+			zim_message message{};
+			message.type = record.type;
+			message.message_id = record.message_id;
+			message.local_message_id = record.message_id;
+			message.order_key = static_cast<long long>(position) + 1;
+			message.conversation_seq = static_cast<long long>(position) + 1;
+			message.timestamp = record.timestamp;
+			message.direction = record.sender == instance->user_id ? zim_message_direction_send
+									       : zim_message_direction_receive;
+			message.sent_status = zim_message_sent_status_send_success;
+			message.conversation_type = conversation_type;
+			message.sender_user_id = const_cast<char *>(record.sender.c_str());
+			message.conversation_id = const_cast<char *>(conversation.c_str());
+			message.message = const_cast<char *>(record.text.c_str());
+			message.extended_data = const_cast<char *>(record.extended_data.c_str());
+			// fills in the fields that are not stored
+			owned.emplace_back(new OwnedMessage(message));
+			messages.push_back(owned.back()->get());
+		}
+		zim_error error{};
+		error.code = zim_error_code_success;
+		error.message = "";
+		if (instance->callbacks().message_queried) {
+			const zim_message *list = messages.empty() ? nullptr : messages.data();
+			instance->callbacks().message_queried(instance->handle(), conversation.c_str(),
+							      conversation_type, list,
+							      static_cast<unsigned int>(messages.size()), error, seq);
+		}
+	});
+}
+
+void ZIM_CALL zim_query_conversation_list(zim_handle handle, struct zim_conversation_query_config config,
+					 zim_sequence *sequence)
+{
+	auto instance = instanceOf(handle);
+	if (!instance) {
+		return;
+	}
+	zim_sequence seq = instance->nextSequence(sequence);
+
+	auto latency = instance->sample(instance->config().send_latency);
+	instance->dispatcher().post(latency, [instance, seq]() {
+		zim_error error{};
+		error.code = zim_error_code_success;
+		error.message = "";
+		if (instance->callbacks().conversation_list_queried) {
+			instance->callbacks().conversation_list_queried(instance->handle(), nullptr, 0, error, seq);
+		}
+	});
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+//
+//  zim_mock.h
+//  In-process stand-in for libZIM, used by the zimcli_mockzim target to benchmark the client
+//  side without network, appid or appsign.
+//
+//  Behaviour is configured through environment variables (or zim_set_advanced_config with the same
+//  names in lower case, before zim_create):
+//
+//    ZIM_MOCK_SEND_LATENCY       latency of sent callbacks, default lognormal:20:0.5
+//    ZIM_MOCK_RECEIPT_LATENCY    added to it for sends with hasReceipt, default fixed:0
+//    ZIM_MOCK_PUSH_LATENCY       added to it for sends with a pushConfig, default fixed:0
+//    ZIM_MOCK_LOGIN_LATENCY      latency of login callbacks, default fixed:50
+//    ZIM_MOCK_ERROR_RATE         share of sends completing with ZIM_MOCK_ERROR_CODE, default 0
+//    ZIM_MOCK_ERROR_CODE         default 6000203 (send message failed)
+//    ZIM_MOCK_DROP_RATE          share of sends that are neither delivered nor called back, default 0
+//    ZIM_MOCK_LOGIN_ERROR_RATE   share of logins failing with 6000101, default 0
+//    ZIM_MOCK_CALLBACK_THREADS   size of the callback thread pool, default 2
+//    ZIM_MOCK_ROOM_DIR           where room membership is kept, default /tmp/zim_mock_rooms
+//    ZIM_MOCK_GROUP_DIR          where group membership is kept, default /tmp/zim_mock_groups
+//    ZIM_MOCK_UPLOAD_BANDWIDTH   bytes per second of the uplink of an instance, default 10M
+//    ZIM_MOCK_DOWNLOAD_BANDWIDTH bytes per second of the downlink of an instance, default 20M
+//    ZIM_MOCK_PROGRESS_INTERVAL  milliseconds between two upload or download progress callbacks, default 100
+//    ZIM_MOCK_HISTORY_DIR        where the history of peer and group conversations is kept, default empty (none)
+//    ZIM_MOCK_CACHE_LATENCY      latency of a history page from the local cache, default fixed:1
+//    ZIM_MOCK_ORDERED_CALLBACKS  1 holds the sent callbacks of a conversation in order too, default 0
+//
+//  Latencies are "fixed:<ms>", "uniform:<min ms>:<max ms>", "normal:<mean ms>:<stddev ms>" or
+//  "lognormal:<median ms>:<sigma>". Bandwidths take a K, M or G suffix (powers of 1024).
+//
+//  Messages that were sent successfully are delivered to the instance logged in as the receiver, or to
+//  every member of the room or group, in this process or any other one on the machine, see Mailbox,
+//  RoomDirectory and GroupDirectory. Messages sent with hasReceipt arrive with the receipt status
+//  processing; zim_send_message_receipts_read completes after ZIM_MOCK_SEND_LATENCY and raises the receipt
+//  changed event at their senders, one read member per call and message. Barrage messages are delivered
+//  the same way, but a receiver whose mailbox is full loses them instead of holding up the sender.
+//  The sends of one conversation are delivered in the order they were made, see SendOrder, while each sent
+//  callback comes after its own latency. ZIM_MOCK_ORDERED_CALLBACKS makes a callback wait for the sends
+//  before it as well, which stretches the callback latency to the slowest send before it: the tail of
+//  ZIM_MOCK_SEND_LATENCY then sets the median, and more so the higher the rate into one conversation.
+//
+//  zim_send_media_message reads the size of the local file and "uploads" it over the uplink of the instance,
+//  which concurrent uploads queue for, then completes like a send. The receivers get a mock:// download URL
+//  naming the same local file; zim_download_media_file takes a round trip and then the size of the file
+//  over the downlink, whatever the file type, and hands that local path back. No bytes are copied.
+//
+//  With ZIM_MOCK_HISTORY_DIR set, zim_query_history_message pages through the text messages sent to a peer
+//  or group conversation, see HistoryStore. A full page of messages the instance has, because they came
+//  after its login or an earlier page fetched them, takes ZIM_MOCK_CACHE_LATENCY; any other page, including
+//  the last one, takes ZIM_MOCK_SEND_LATENCY like a server round trip. Without it every page is empty.
+//
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "zim.h"
+
+namespace zim_mock {
+
+class Distribution {
+public:
+	enum Kind { Fixed, Uniform, Normal, LogNormal };
+
+	Distribution(Kind kind = Fixed, double a = 0, double b = 0) : kind_(kind), a_(a), b_(b) {}
+
+	static bool parse(const std::string &spec, Distribution &distribution);
+
+	std::chrono::microseconds sample(std::mt19937_64 &rng) const;
+
+private:
+	Kind kind_;
+	double a_;
+	double b_;
+};
+
+struct Config {
+	Distribution send_latency{Distribution::LogNormal, 20, 0.5};
+	Distribution receipt_latency{Distribution::Fixed, 0};
+	Distribution push_latency{Distribution::Fixed, 0};
+	Distribution login_latency{Distribution::Fixed, 50};
+	double error_rate = 0;
+	zim_error_code error_code = zim_error_code_message_module_send_message_failed;
+	double drop_rate = 0;
+	double login_error_rate = 0;
+	int callback_threads = 2;
+	std::string room_dir = "/tmp/zim_mock_rooms";
+	std::string group_dir = "/tmp/zim_mock_groups";
+	uint64_t upload_bandwidth = 10 * 1024 * 1024;
+	uint64_t download_bandwidth = 20 * 1024 * 1024;
+	int progress_interval = 100;
+	std::string history_dir;
+	Distribution cache_latency{Distribution::Fixed, 1};
+	bool ordered_callbacks = false;
+
+	// applies one ZIM_MOCK_* setting, `key` is case insensitive
+	bool set(const std::string &key, const std::string &value);
+	// the process wide settings: environment first, then zim_set_advanced_config
+	static Config current();
+};
+
+// Fixed size thread pool running tasks once they are due, the stand-in for the SDK's callback threads.
+class Dispatcher {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	explicit Dispatcher(int threads);
+	~Dispatcher();
+
+	void post(std::chrono::microseconds delay, std::function<void()> task);
+	void postAt(Clock::time_point due, std::function<void()> task);
+	// drops the pending tasks and joins the threads, except the calling one
+	void stop();
+
+private:
+	void run();
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	// keyed by due time, the multimap keeps tasks with the same due time in posting order
+	std::multimap<Clock::time_point, std::function<void()>> tasks_;
+	bool stopped_ = false;
+	std::vector<std::thread> threads_;
+};
+
+// Deep copy of a zim_message that stays valid after the caller has released its own copy.
+// Every string field points to owned storage (never nullptr, the converters assume that), fields the
+// mock does not model such as reactions and combined messages are cleared.
+class OwnedMessage {
+public:
+	explicit OwnedMessage(const zim_message &source);
+	OwnedMessage(const OwnedMessage &) = delete;
+	OwnedMessage &operator=(const OwnedMessage &) = delete;
+
+	zim_message &get() { return message_; }
+
+private:
+	zim_message message_;
+	std::vector<std::string> strings_;
+	std::vector<unsigned char> command_;
+	std::vector<std::string> mentioned_;
+	std::vector<char *> mentioned_ptrs_;
+};
+
+struct Callbacks {
+	zim_on_logged_in_callback logged_in = nullptr;
+	zim_on_message_sent_callback message_sent = nullptr;
+	zim_on_message_attached_callback message_attached = nullptr;
+	zim_on_error_event error = nullptr;
+	zim_on_connection_state_changed_event connection_state_changed = nullptr;
+	zim_on_receive_peer_message_event receive_peer_message = nullptr;
+	zim_on_receive_room_message_event receive_room_message = nullptr;
+	zim_on_room_entered_callback room_entered = nullptr;
+	zim_on_room_left_callback room_left = nullptr;
+	zim_on_receive_group_message_event receive_group_message = nullptr;
+	zim_on_group_created_callback group_created = nullptr;
+	zim_on_group_users_invited_callback group_users_invited = nullptr;
+	zim_on_group_dismissed_callback group_dismissed = nullptr;
+	zim_on_message_queried_callback message_queried = nullptr;
+	zim_on_conversation_list_queried_callback conversation_list_queried = nullptr;
+	zim_on_message_receipts_read_sent_callback message_receipts_read_sent = nullptr;
+	zim_on_message_receipt_changed_event message_receipt_changed = nullptr;
+	zim_on_media_uploading_progress_callback media_uploading_progress = nullptr;
+	zim_on_media_downloading_progress_callback media_downloading_progress = nullptr;
+	zim_on_media_downloaded_callback media_downloaded = nullptr;
+};
+
+// The uplink or downlink of an instance. Transfers get the whole bandwidth one after the other, in the
+// order they were started, so concurrent ones share it.
+class Link {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	explicit Link(uint64_t bandwidth) : bandwidth_(bandwidth) {}
+
+	// when a transfer of `bytes` starting now gets the link and when it is done
+	void reserve(uint64_t bytes, Clock::time_point &start, Clock::time_point &end);
+
+private:
+	const uint64_t bandwidth_;
+	std::mutex mutex_;
+	Clock::time_point free_;
+};
+
+// The sends of one conversation of an instance in the order they were made. Each one is delivered once its
+// latency is over and every send before it has been, so a quick send waits for a slow one before it like
+// the server relays the messages of a conversation in order.
+class SendOrder {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// the place of a send that is being made
+	uint64_t reserve();
+	// `task` completes the send of `ticket`, due at `due`; drain() is to be called at `due`
+	void arm(uint64_t ticket, Clock::time_point due, std::function<void()> task);
+	// Runs the tasks at the front that are armed and due, one thread at a time. A call while another
+	// thread drains leaves the task to it.
+	void drain();
+
+private:
+	struct Entry {
+		bool armed = false;
+		Clock::time_point due;
+		std::function<void()> task;
+	};
+
+	std::mutex mutex_;
+	std::deque<Entry> entries_;
+	// ticket of the front entry
+	uint64_t first_ = 0;
+	bool draining_ = false;
+};
+
+class Instance;
+
+// Delivery between instances, across processes too: every logged in user binds a unix datagram socket
+// named after its user ID, a successful send writes the message to the socket of the receiver and the
+// receive thread there raises the receive event. Messages to users nobody is logged in as are dropped,
+// like offline messages would be from the point of view of a benchmark.
+class Mailbox {
+public:
+	explicit Mailbox(Instance *instance) : instance_(instance) {}
+	~Mailbox();
+
+	// binds the address of `user_id` and starts receiving, false if another instance owns it already
+	bool open(const std::string &user_id);
+	void close();
+
+	// Writes a sent message to the mailboxes of `user_ids`, except to the sender's own, and blocks for a
+	// while on a full one. A barrage is dropped at once on a full mailbox. Returns the users that have no
+	// mailbox.
+	static std::vector<std::string> deliver(const zim_message &message, const std::vector<std::string> &user_ids);
+	// Tells `user_id`, who sent the messages, that they were read in the conversation, which for a peer
+	// conversation is named after the reader.
+	static void deliverReceipt(const std::string &user_id, const std::string &conversation_id,
+				   zim_conversation_type conversation_type, const std::vector<long long> &message_ids);
+
+private:
+	Mailbox(const Mailbox &) = delete;
+	Mailbox &operator=(const Mailbox &) = delete;
+
+	void run();
+
+	Instance *const instance_;
+	int fd_ = -1;
+	std::atomic<bool> stopped_{false};
+	std::thread thread_;
+};
+
+// Room membership shared by every process on the machine: one empty file per member in
+// <room_dir>/<room id>/. Senders cache the member list and reread it once the directory changed.
+class RoomDirectory {
+public:
+	static bool enter(const std::string &room_dir, const std::string &room_id, const std::string &user_id);
+	static void leave(const std::string &room_dir, const std::string &room_id, const std::string &user_id);
+	// at most 100ms old
+	static std::shared_ptr<const std::vector<std::string>> members(const std::string &room_dir,
+									 const std::string &room_id);
+};
+
+// Group membership shared by every process on the machine: one file per group in <group_dir> listing
+// its members line by line. Members only join until the group is dismissed, so appending suffices.
+class GroupDirectory {
+public:
+	// false if the group exists already
+	static bool create(const std::string &group_dir, const std::string &group_id,
+			   const std::vector<std::string> &user_ids);
+	// false if the group does not exist
+	static bool add(const std::string &group_dir, const std::string &group_id,
+			const std::vector<std::string> &user_ids);
+	static bool dismiss(const std::string &group_dir, const std::string &group_id);
+	// at most 100ms old
+	static std::shared_ptr<const std::vector<std::string>> members(const std::string &group_dir,
+									 const std::string &group_id);
+};
+
+// History of peer and group conversations shared by every process on the machine: each text message sent
+// successfully is appended to a file per conversation, <history_dir>/peer/<user ID>/<user ID> with the
+// two IDs sorted or <history_dir>/group/<group ID>. Room messages and barrages are not kept.
+class HistoryStore {
+public:
+	struct Record {
+		zim_message_type type;
+		long long message_id;
+		unsigned long long timestamp;
+		std::string sender;
+		std::string text;
+		std::string extended_data;
+	};
+
+	// the messages in the order they were stored
+	struct Conversation {
+		std::vector<Record> records;
+		// the position of every message by sender and message ID, which is only unique per sender
+		std::unordered_map<std::string, size_t> positions;
+		// bytes of the file read so far
+		uint64_t offset = 0;
+	};
+
+	// the file of a conversation `user_id` is in, empty for a room
+	static std::string path(const std::string &history_dir, const std::string &user_id,
+				const std::string &conversation_id, zim_conversation_type conversation_type);
+	static void append(const std::string &path, const zim_message &message);
+	// what the file holds now, earlier loads are cached and only the messages appended since are read
+	static std::shared_ptr<const Conversation> load(const std::string &path);
+	// the position of `message_id` of `sender`, false if the conversation does not have it
+	static bool find(const Conversation &conversation, const std::string &sender, long long message_id,
+			 size_t &position);
+};
+
+class Instance {
+public:
+	explicit Instance(const Config &config);
+
+	zim_handle handle() { return this; }
+	const Config &config() const { return config_; }
+	Callbacks &callbacks() { return callbacks_; }
+	Dispatcher &dispatcher() { return dispatcher_; }
+	Mailbox &mailbox() { return mailbox_; }
+	Link &uplink() { return uplink_; }
+	Link &downlink() { return downlink_; }
+
+	zim_sequence nextSequence(zim_sequence *sequence);
+	long long nextMessageID() { return ++message_id_; }
+	// true with probability `rate`
+	bool roll(double rate);
+	std::chrono::microseconds sample(const Distribution &distribution);
+
+	// rooms are left again on logout and at exit
+	void enteredRoom(const std::string &room_id);
+	void leftRoom(const std::string &room_id);
+	void leaveRooms();
+
+	// the order of the sends to a conversation
+	std::shared_ptr<SendOrder> sendOrder(zim_conversation_type conversation_type,
+					     const std::string &conversation_id);
+
+	void loggedIn();
+	// True if this instance has the messages [begin, end) of the conversation stored at `path`: they came
+	// after the login, or an earlier page fetched them, which these do from now on as well.
+	bool hasHistory(const std::string &path, const HistoryStore::Conversation &conversation, size_t begin,
+			size_t end);
+
+	std::string user_id;
+
+private:
+	const Config config_;
+	Callbacks callbacks_;
+	std::atomic<zim_sequence> sequence_{0};
+	std::atomic<long long> message_id_{0};
+	std::mutex rooms_mutex_;
+	std::vector<std::string> rooms_;
+	std::mutex orders_mutex_;
+	std::unordered_map<std::string, std::shared_ptr<SendOrder>> orders_;
+	std::atomic<unsigned long long> logged_in_at_{0};
+	std::mutex history_mutex_;
+	// by path, the messages of a conversation earlier pages fetched
+	std::unordered_map<std::string, std::vector<bool>> fetched_;
+	Mailbox mailbox_{this};
+	Link uplink_;
+	Link downlink_;
+	Dispatcher dispatcher_;
+};
+
+Instance *instanceOf(zim_handle handle);
+
+unsigned long long nowMillis();
+
+} // namespace zim_mock
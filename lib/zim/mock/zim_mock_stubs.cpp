@@ -0,0 +1,1102 @@
+//
+//  zim_mock_stubs.cpp
+//  The part of the zim C API the mock does not model. Calls are accepted and never answered, so the
+//  C++ layer links and everything outside the modelled hot path simply stays silent.
+//  When a scenario starts using one of these, move it to zim_mock.cpp and give it a real behaviour.
+//
+
+#include "zim.h"
+
+void ZIM_CALL zim_set_pushid(const char *pushid)
+{
+}
+
+void ZIM_CALL zim_set_badge(int badge, const char *pushID)
+{
+}
+
+void ZIM_CALL zim_set_android_env(void *jvm, void *context)
+{
+}
+
+void ZIM_CALL zim_write_custom_log(const char *custom_log, const char *module_name)
+{
+}
+
+void ZIM_CALL zim_register_log_uploaded_callback(zim_handle handle, zim_on_log_uploaded_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_upload_log(zim_handle handle, zim_sequence *sequence)
+{
+}
+
+bool ZIM_CALL zim_set_geofencing_config(const int *area_list, unsigned int area_list_length,
+		enum zim_geofencing_type type)
+{
+	return false;
+}
+
+void ZIM_CALL zim_register_token_renewed_callback(zim_handle handle, zim_on_token_renewed_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_renew_token(zim_handle handle, const char *token, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_users_info_queried_callback(zim_handle handle,
+		zim_on_users_info_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_users_info(zim_handle handle, const char **user_id_list, unsigned int user_id_list_length,
+		struct zim_users_info_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_user_name_updated_callback(zim_handle handle,
+		zim_on_user_name_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_user_name(zim_handle handle, const char *user_name, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_user_avatar_url_updated_callback(zim_handle handle,
+		zim_on_user_avatar_url_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_user_avatar_url(zim_handle handle, const char *user_avatar_url, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_user_extended_data_updated_callback(zim_handle handle,
+		zim_on_user_extended_data_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_user_extended_data(zim_handle handle, const char *user_extended_data, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_local_extended_data_updated_callback(zim_handle handle,
+		zim_on_message_local_extended_data_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_message_local_extended_data(zim_handle handle, const char *local_extended_data,
+		struct zim_message message, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_queried_callback(zim_handle handle,
+		zim_on_conversation_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_conversation(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_pinned_list_queried_callback(zim_handle handle,
+		zim_on_conversation_pinned_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_conversation_pinned_list(zim_handle handle, struct zim_conversation_query_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_pinned_state_updated_callback(zim_handle handle,
+		zim_on_conversation_pinned_state_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_conversation_pinned_state(zim_handle handle, bool is_pinned, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_deleted_callback(zim_handle handle,
+		zim_on_conversation_deleted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_delete_conversation(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, struct zim_conversation_delete_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversations_all_deleted_callback(zim_handle handle,
+		zim_on_conversations_all_deleted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_delete_all_conversations(zim_handle handle, struct zim_conversation_delete_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_unread_message_count_cleared_callback(zim_handle handle,
+		zim_on_conversation_unread_message_count_cleared_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_clear_conversation_unread_message_count(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_total_unread_message_count_cleared_callback(zim_handle handle,
+		zim_on_conversation_total_unread_message_count_cleared_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_clear_conversation_total_unread_message_count(zim_handle handle, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_notification_status_set_callback(zim_handle handle,
+		zim_on_conversation_notification_status_set_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_conversation_notification_status(zim_handle handle,
+		enum zim_conversation_notification_status status, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_message_receipt_read_sent_callback(zim_handle handle,
+		zim_on_conversation_message_receipt_read_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_send_conversation_message_receipt_read(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_query_combine_message_detail_callback(zim_handle handle,
+		zim_on_combine_message_detail_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_combine_message_detail(zim_handle handle, struct zim_message message, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_draft_set_callback(zim_handle handle,
+		zim_on_conversation_draft_set_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_conversation_draft(zim_handle handle, const char *draft, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_send_peer_message(zim_handle handle, struct zim_message message, const char *to_user_id,
+		struct zim_message_send_config *config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_send_room_message(zim_handle handle, struct zim_message message, const char *to_room_id,
+		struct zim_message_send_config *config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_send_group_message(zim_handle handle, struct zim_message message, const char *to_group_id,
+		struct zim_message_send_config *config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_deleted_callback(zim_handle handle,
+		zim_on_message_deleted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_delete_messages(zim_handle handle, struct zim_message *message_list, unsigned int member_list_length,
+		const char *conversation_id, enum zim_conversation_type conversation_type,
+		struct zim_message_delete_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_delete_all_message(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, struct zim_message_delete_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversation_messages_all_deleted_callback(zim_handle handle,
+		zim_on_conversation_messages_all_deleted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_delete_all_conversation_messages(zim_handle handle, struct zim_message_delete_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_inserted_callback(zim_handle handle,
+		zim_on_message_inserted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_insert_message_to_local_db(zim_handle handle, struct zim_message message, const char *conversation_id,
+		enum zim_conversation_type conversation_type, const char *sender_user_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_receipts_info_queried_callback(zim_handle handle,
+		zim_on_message_receipts_info_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_message_receipts_info(zim_handle handle, struct zim_message *message_list,
+		unsigned int message_list_length, const char *conversation_id,
+		enum zim_conversation_type conversation_type, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_revoked_callback(zim_handle handle,
+		zim_on_message_revoked_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_revoke_message(zim_handle handle, struct zim_message message, struct zim_message_revoke_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_messages_searched_callback(zim_handle handle,
+		zim_on_messages_searched_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_search_local_messages(zim_handle handle, const char *conversation_id,
+		enum zim_conversation_type conversation_type, struct zim_message_search_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_messages_global_searched_callback(zim_handle handle,
+		zim_on_messages_global_searched_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_search_global_local_messages(zim_handle handle, const struct zim_message_search_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_conversations_searched_callback(zim_handle handle,
+		zim_on_conversations_searched_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_search_local_conversations(zim_handle handle, struct zim_conversation_search_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_added_reaction_callback(zim_handle handle,
+		on_message_reaction_added_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_add_message_reaction(zim_handle handle, const char *reaction_type, struct zim_message message,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_deleted_reaction_callback(zim_handle handle,
+		on_message_reaction_deleted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_delete_message_reaction(zim_handle handle, const char *reaction_type, struct zim_message message,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_queried_reaction_user_list_callback(zim_handle handle,
+		on_message_reaction_users_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_message_reaction_user_list(zim_handle handle, struct zim_message message,
+		struct zim_message_reaction_users_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_message_reactions_changed_event(zim_handle handle,
+		on_message_reactions_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_created_callback(zim_handle handle, zim_on_room_created_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_create_room(zim_handle handle, struct zim_room_info room_info,
+		struct zim_room_advanced_config *config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_joined_callback(zim_handle handle, zim_on_room_joined_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_join_room(zim_handle handle, const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_member_queried_callback(zim_handle handle,
+		zim_on_room_member_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_member_list(zim_handle handle, const char *room_id,
+		struct zim_room_member_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_members_queried_callback(zim_handle handle,
+		zim_on_room_members_queried callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_members(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_online_member_count_queried_callback(zim_handle handle,
+		zim_on_room_online_member_count_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_online_member_count(zim_handle handle, const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_attributes_operated_callback(zim_handle handle,
+		zim_on_room_attributes_operated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_room_attributes(zim_handle handle, struct zim_room_attribute *room_attributes,
+		unsigned int room_attributes_length, const char *room_id, struct zim_room_attributes_set_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_delete_room_attributes(zim_handle handle, const char **keys, unsigned int keys_length,
+		const char *room_id, struct zim_room_attributes_delete_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_attributes_batch_operated_callback(zim_handle handle,
+		zim_on_room_attributes_batch_operated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_begin_room_attributes_batch_operation(zim_handle handle, const char *room_id,
+		struct zim_room_attributes_batch_operation_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_end_room_attributes_batch_operation(zim_handle handle, const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_attributes_queried_callback(zim_handle handle,
+		zim_on_room_attributes_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_all_attributes(zim_handle handle, const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_members_attributes_operated_callback(zim_handle handle,
+		zim_on_room_members_attributes_operated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_room_members_attributes(zim_handle handle, struct zim_room_member_attribute *attributes,
+		unsigned int attributes_length, const char **user_ids, unsigned int user_ids_length,
+		const char *room_id, struct zim_room_member_attributes_set_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_members_attributes_queried_callback(zim_handle handle,
+		zim_on_room_members_attributes_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_members_attributes(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		const char *room_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_room_member_attributes_list_queried_callback(zim_handle handle,
+		zim_on_room_member_attributes_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_room_member_attributes_list(zim_handle handle, const char *room_id,
+		struct zim_room_member_attributes_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_joined_callback(zim_handle handle, zim_on_group_joined_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_join_group(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_left_callback(zim_handle handle, zim_on_group_left_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_leave_group(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_kicked_callback(zim_handle handle,
+		zim_on_group_member_kicked_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_kick_group_members(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_owner_transferred_callback(zim_handle handle,
+		zim_on_group_owner_transferred_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_transfer_group_owner(zim_handle handle, const char *to_user_id, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_name_updated_callback(zim_handle handle,
+		zim_on_group_name_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_group_name(zim_handle handle, const char *group_name, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_avatar_url_updated_callback(zim_handle handle,
+		zim_on_group_avatar_url_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_group_avatar_url(zim_handle handle, const char *group_avatar_url, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_notice_updated_callback(zim_handle handle,
+		zim_on_group_notice_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_update_group_notice(zim_handle handle, const char *group_notice, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_info_queried_callback(zim_handle handle,
+		zim_on_group_info_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_info(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_attributes_operated_callback(zim_handle handle,
+		zim_on_group_attributes_operated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_group_attributes(zim_handle handle, struct zim_group_attribute *group_attributes,
+		unsigned int group_attributes_length, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_delete_group_attributes(zim_handle handle, const char **keys, unsigned int keys_length,
+		const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_attributes_queried_callback(zim_handle handle,
+		zim_on_group_attributes_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_attributes(zim_handle handle, const char **keys, unsigned int keys_length,
+		const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_query_group_all_attributes(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_nickname_updated_callback(zim_handle handle,
+		zim_on_group_member_nickname_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_group_member_nickname(zim_handle handle, const char *group_member_nickname,
+		const char *for_user_id, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_role_updated_callback(zim_handle handle,
+		zim_on_group_member_role_updated_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_set_group_member_role(zim_handle handle, int role, const char *for_user_id, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_muted_callback(zim_handle handle, zim_on_group_muted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_mute_group(zim_handle handle, bool is_mute, const char *group_id, struct zim_group_mute_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_list_muted_callback(zim_handle handle,
+		zim_on_group_member_list_muted_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_mute_group_members(zim_handle handle, bool is_mute, const char *group_id, const char **user_id_list,
+		unsigned int user_id_list_length, struct zim_group_member_list_mute_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_muted_member_list_queried_callback(zim_handle handle,
+		zim_on_group_muted_member_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_muted_member_list(zim_handle handle, const char *group_id,
+		struct zim_group_muted_members_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_info_queried_callback(zim_handle handle,
+		zim_on_group_member_info_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_member_info(zim_handle handle, const char *user_id, const char *group_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_list_queried_callback(zim_handle handle,
+		zim_on_group_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_list(zim_handle handle, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_list_queried_callback(zim_handle handle,
+		zim_on_group_member_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_member_list(zim_handle handle, const char *group_id,
+		struct zim_group_member_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_member_count_queried_callback(zim_handle handle,
+		zim_on_group_member_count_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_member_count(zim_handle handle, const char *group_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_message_receipt_member_list_queried_callback(zim_handle handle,
+		zim_on_group_message_receipt_member_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_group_message_receipt_read_member_list(zim_handle handle, struct zim_message message,
+		const char *group_id, struct zim_group_message_receipt_member_query_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_query_group_message_receipt_unread_member_list(zim_handle handle, struct zim_message message,
+		const char *group_id, struct zim_group_message_receipt_member_query_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_groups_searched_callback(zim_handle handle,
+		zim_on_groups_searched_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_search_local_groups(zim_handle handle, struct zim_group_search_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_group_members_searched_callback(zim_handle handle,
+		zim_on_group_members_searched_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_search_local_group_members(zim_handle handle, const char *group_id,
+		struct zim_group_member_search_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_sent_callback(zim_handle handle,
+		zim_on_call_invitation_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_invite(zim_handle handle, const char **invitees, unsigned int invitees_length,
+		struct zim_call_invite_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_calling_invitation_sent_callback(zim_handle handle,
+		zim_on_calling_invitation_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_calling_invite(zim_handle handle, const char *call_id, const char **invitees,
+		unsigned int invitees_count, struct zim_calling_invite_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_join_sent_callback(zim_handle handle, zim_on_call_join_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_join(zim_handle handle, const char *call_id, struct zim_call_join_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_cancel_sent_callback(zim_handle handle,
+		zim_on_call_cancel_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_cancel(zim_handle handle, const char *call_id, const char **invitees,
+		unsigned int invitees_length, struct zim_call_cancel_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_acceptance_sent_callback(zim_handle handle,
+		zim_on_call_acceptance_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_accept(zim_handle handle, const char *call_id, struct zim_call_accept_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_rejection_sent_callback(zim_handle handle,
+		zim_on_call_rejection_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_reject(zim_handle handle, const char *call_id, struct zim_call_reject_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_quit_sent_callback(zim_handle handle, zim_on_call_quit_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_quit(zim_handle handle, const char *call_id, struct zim_call_quit_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_end_sent_callback(zim_handle handle, zim_on_call_end_sent_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_call_end(zim_handle handle, const char *call_id, struct zim_call_end_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_call_list_queried_callback(zim_handle handle,
+		zim_on_call_list_queried_callback callback_function)
+{
+}
+
+void ZIM_CALL zim_query_call_list(zim_handle handle, struct zim_query_call_list_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_token_will_expire_event(zim_handle handle, zim_on_token_will_expire_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_user_info_updated_event(zim_handle handle, zim_on_user_info_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_conversation_changed_event(zim_handle handle,
+		zim_on_conversation_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_conversation_total_unread_message_count_updated_event(zim_handle handle,
+		zim_on_conversation_total_unread_message_count_updated_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_conversations_all_deleted_event(zim_handle handle,
+		zim_on_conversations_all_deleted_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_message_sent_status_changed_event(zim_handle handle,
+		zim_on_message_sent_status_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_message_revoke_received_event(zim_handle handle,
+		zim_on_message_revoke_received_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_broadcast_message_received_event(zim_handle handle,
+		zim_on_broadcast_message_received_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_message_deleted_event(zim_handle handle, zim_on_message_deleted_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_state_changed_event(zim_handle handle, zim_on_room_state_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_member_joined_event(zim_handle handle, zim_on_room_member_joined_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_member_left_event(zim_handle handle, zim_on_room_member_left_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_attributes_updated_event(zim_handle handle,
+		zim_on_room_attributes_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_attributes_batch_updated_event(zim_handle handle,
+		zim_on_room_attributes_batch_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_room_member_attributes_updated_event(zim_handle handle,
+		zim_on_room_member_attributes_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_on_friend_list_changed_event(zim_handle handle, zim_on_friend_list_changed_event callback)
+{
+}
+
+void ZIM_CALL zim_register_on_friend_info_updated_event(zim_handle handle, zim_on_friend_info_updated_event callback)
+{
+}
+
+void ZIM_CALL zim_register_on_friend_application_updated_event(zim_handle handle,
+		zim_on_friend_application_updated_event callback)
+{
+}
+
+void ZIM_CALL zim_register_on_friend_application_changed_event(zim_handle handle,
+		zim_on_friend_application_changed_event callback)
+{
+}
+
+void ZIM_CALL zim_register_on_blacklist_changed_event(zim_handle handle, zim_on_blacklist_changed_event callback)
+{
+}
+
+void ZIM_CALL zim_register_group_state_changed_event(zim_handle handle, zim_on_group_state_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_member_state_changed_event(zim_handle handle,
+		zim_on_group_member_state_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_name_updated_event(zim_handle handle, zim_on_group_name_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_notice_updated_event(zim_handle handle,
+		zim_on_group_notice_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_avatar_url_updated_event(zim_handle handle,
+		zim_on_group_avatar_url_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_mute_info_updated_event(zim_handle handle,
+		zim_on_group_mute_info_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_group_attributes_updated_event(zim_handle handle,
+		zim_on_group_attributes_updated_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_group_member_info_updated_event(zim_handle handle,
+		zim_on_group_member_info_updated_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_received_event(zim_handle handle,
+		zim_on_call_invitation_received_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_created_event(zim_handle handle,
+		zim_on_call_invitation_created_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_cancelled_event(zim_handle handle,
+		zim_on_call_invitation_cancelled_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_accepted_event(zim_handle handle,
+		zim_on_call_invitation_accepted_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_rejected_event(zim_handle handle,
+		zim_on_call_invitation_rejected_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_timeout_event(zim_handle handle,
+		zim_on_call_invitation_timeout_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitees_answered_timeout_event(zim_handle handle,
+		zim_on_call_invitees_answered_timeout_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_invitation_ended_event(zim_handle handle,
+		zim_on_call_invitation_ended_event callback_function)
+{
+}
+
+void ZIM_CALL zim_register_call_state_changed_event(zim_handle handle, zim_on_call_state_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_call_user_state_changed_event(zim_handle handle,
+		zim_on_call_user_state_changed_event event_function)
+{
+}
+
+void ZIM_CALL zim_register_friend_added_callback(zim_handle handle, zim_on_friend_added_callback callback)
+{
+}
+
+void ZIM_CALL zim_add_friend(zim_handle handle, const char *user_ids, struct zim_friend_add_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friend_application_sent_callback(zim_handle handle,
+		zim_on_friend_application_sent_callback callback)
+{
+}
+
+void ZIM_CALL zim_send_friend_application(zim_handle handle, const char *user_id,
+		struct zim_friend_application_send_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_delete_friends_callback(zim_handle handle, zim_on_delete_friend_callback callback)
+{
+}
+
+void ZIM_CALL zim_delete_friends(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		struct zim_friend_delete_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friends_relation_check_callback(zim_handle handle,
+		zim_on_friends_relation_check_callback callback)
+{
+}
+
+void ZIM_CALL zim_check_friends_relation(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		struct zim_friend_relation_check_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_update_friend_alias_callback(zim_handle handle, zim_on_update_friend_alias_callback callback)
+{
+}
+
+void ZIM_CALL zim_update_friend_alias(zim_handle handle, const char *friend_alias, const char *user_id,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_update_friend_attributes_callback(zim_handle handle,
+		zim_on_update_friend_attributes_callback callback)
+{
+}
+
+void ZIM_CALL zim_update_friend_attributes(zim_handle handle, struct zim_friend_attribute *friend_attributes,
+		unsigned int friend_attributes_length, const char *user_id, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friends_info_queried_callback(zim_handle handle,
+		zim_on_friends_info_queried_callback callback)
+{
+}
+
+void ZIM_CALL zim_search_local_friends(zim_handle handle, struct zim_friend_search_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friends_searched_callback(zim_handle handle, zim_on_friends_searched_callback callback)
+{
+}
+
+void ZIM_CALL zim_query_friends_info(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friend_application_accepted_callback(zim_handle handle,
+		zim_on_friend_application_accepted_callback callback)
+{
+}
+
+void ZIM_CALL zim_accept_friend_application(zim_handle handle, const char *user_id,
+		struct zim_friend_application_accept_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_friend_application_reject_callback(zim_handle handle,
+		zim_on_friend_application_reject_callback callback)
+{
+}
+
+void ZIM_CALL zim_friend_reject_application(zim_handle handle, const char *user_id,
+		struct zim_friend_application_reject_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_query_friend_list_callback(zim_handle handle, zim_on_query_friend_list_callback callback)
+{
+}
+
+void ZIM_CALL zim_query_friend_list(zim_handle handle, struct zim_friend_list_query_config config,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_query_friend_application_list_callback(zim_handle handle,
+		zim_on_query_friend_application_list_callback callback)
+{
+}
+
+void ZIM_CALL zim_query_friend_application_list(zim_handle handle,
+		struct zim_friend_application_list_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_blacklist_users_added_callback(zim_handle handle,
+		zim_on_blacklist_users_added_callback callback)
+{
+}
+
+void ZIM_CALL zim_add_users_to_blacklist(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_blacklist_users_remove_callback(zim_handle handle,
+		zim_on_blacklist_users_remove_callback callback)
+{
+}
+
+void ZIM_CALL zim_remove_users_from_blacklist(zim_handle handle, const char **user_ids, unsigned int user_ids_length,
+		zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_blacklist_queried_callback(zim_handle handle, zim_on_blacklist_queried_callback callback)
+{
+}
+
+void ZIM_CALL zim_query_blacklist(zim_handle handle, struct zim_blacklist_query_config config, zim_sequence *sequence)
+{
+}
+
+void ZIM_CALL zim_register_check_user_is_in_blacklist_callback(zim_handle handle,
+		zim_on_check_user_is_in_blacklist_callback callback)
+{
+}
+
+void ZIM_CALL zim_check_user_is_in_blacklist(zim_handle handle, const char *user_id, zim_sequence *sequence)
+{
+}
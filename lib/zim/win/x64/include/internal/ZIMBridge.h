@@ -406,27 +406,14 @@ class ZIMBridge {
             return;
         }
 
-        ZIMMessageSentCallback callback = nullptr;
-        std::shared_ptr<ZIMMessage> oMessage = nullptr;
-
-        {
-            std::lock_guard<std::mutex> lock(zim->message_sent_callbacks_mutex_);
-            callback = zim->message_sent_callbacks_[sequence];
-            {
-                std::lock_guard<std::mutex> lock_2(zim->message_obj_map_mutex_);
-                if (zim->message_obj_map_.find(sequence) != zim->message_obj_map_.end()) {
-
-                    oMessage = zim->message_obj_map_[sequence];
-                    zim->message_obj_map_.erase(sequence);
-                }
-            }
-
-            zim->message_sent_callbacks_.erase(sequence);
-            zim->media_send_progress_callbacks_.erase(sequence);
-            zim->send_message_notification_callbacks_.erase(sequence);
-            zim->send_media_message_notification_callbacks_.erase(sequence);
+        ZIMPendingMessage pending;
+        if (!zim->pending_messages_.take(sequence, pending)) {
+            return;
         }
 
+        ZIMMessageSentCallback callback = std::move(pending.callback);
+        std::shared_ptr<ZIMMessage> oMessage = std::move(pending.message);
+
         if (!callback) {
             return;
         }
@@ -454,33 +441,13 @@ class ZIMBridge {
 
         std::shared_ptr<ZIMMessageSendNotification> messageNotification = nullptr;
         std::shared_ptr<ZIMMediaMessageSendNotification> mediaMessageNotification = nullptr;
-
-        {
-            std::lock_guard<std::mutex> lock(zim->send_message_notification_callbacks_mutex_);
-            if (zim->send_message_notification_callbacks_.find(sequence) !=
-                zim->send_message_notification_callbacks_.end()) {
-                messageNotification = zim->send_message_notification_callbacks_[sequence];
-            }
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(zim->send_media_message_notification_callbacks_mutex_);
-            if (zim->send_media_message_notification_callbacks_.find(sequence) !=
-                zim->send_media_message_notification_callbacks_.end()) {
-                mediaMessageNotification =
-                    zim->send_media_message_notification_callbacks_[sequence];
-            }
-        }
-
         std::shared_ptr<ZIMMessage> oMessage = nullptr;
 
-        {
-            std::lock_guard<std::mutex> lock(zim->message_obj_map_mutex_);
-            if (zim->message_obj_map_.find(sequence) != zim->message_obj_map_.end()) {
-                oMessage = zim->message_obj_map_[sequence];
-                zim->message_obj_map_.erase(sequence);
-            }
-        }
+        zim->pending_messages_.visit(sequence, [&](ZIMPendingMessage &pending) {
+            messageNotification = pending.notification;
+            mediaMessageNotification = pending.mediaNotification;
+            oMessage = pending.message;
+        });
 
         if (oMessage) {
             ZIMConverter::cZIMMessage(oMessage, message);
@@ -3495,35 +3462,16 @@ class ZIMBridge {
         }
 
         ZIMMediaUploadingProgress callback = nullptr;
-
-        {
-            std::lock_guard<std::mutex> lock(zim->media_send_progress_callbacks_mutex_);
-            callback = zim->media_send_progress_callbacks_[sequence];
-        }
-
         std::shared_ptr<ZIMMediaMessageSendNotification> notification = nullptr;
-
-        {
-            std::lock_guard<std::mutex> lock(zim->send_media_message_notification_callbacks_mutex_);
-            if (zim->send_media_message_notification_callbacks_.find(sequence) !=
-                zim->send_media_message_notification_callbacks_.end()) {
-                notification = zim->send_media_message_notification_callbacks_[sequence];
-            }
-        }
-
         std::shared_ptr<ZIMMessage> oMessage = nullptr;
 
-        bool is_find_in_map = false;
-        {
-            std::lock_guard<std::mutex> lock(zim->message_obj_map_mutex_);
-            if (zim->message_obj_map_.find(sequence) != zim->message_obj_map_.end()) {
-                oMessage = zim->message_obj_map_[sequence];
-                zim->message_obj_map_.erase(sequence);
-                is_find_in_map = true;
-            }
-        }
+        zim->pending_messages_.visit(sequence, [&](ZIMPendingMessage &pending) {
+            callback = pending.progress;
+            notification = pending.mediaNotification;
+            oMessage = pending.message;
+        });
 
-        if (!is_find_in_map) {
+        if (!oMessage) {
             oMessage = ZIMConverter::oZIMMessage(&message);
         }
 
@@ -15,6 +15,7 @@
 // clang-format off
 #include "include/zim.h"
 #include "ZIMConverter.h"
+#include "ZIMPendingMessageTable.h"
 
 #if defined(__APPLE_OS__) || defined(__APPLE__)
 #include "TargetConditionals.h"
@@ -186,27 +187,25 @@ class ZIMImpl : public ZIM {
     void sendPeerMessage(ZIMMessage *message, const std::string &toUserID,
                          const ZIMMessageSendConfig &config,
                          ZIMMessageSentCallback callback) override {
-        struct zim_message sMessage {};
-        ZIMConverter::sNewZIMMessage(sMessage, message);
+        ZIMBorrowedMessage sMessage(message);
 
         zim_sequence sequence = ++sequence_;
 
         zim_message_send_config send_config{};
         ZIMConverter::sZIMMessageSendConfig(send_config, &config);
         {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
 
-        zim_send_peer_message(handle_, sMessage, toUserID.c_str(), &send_config, &sequence);
-        ZIMConverter::sDelZIMMessage(sMessage);
+        zim_send_peer_message(handle_, sMessage.get(), toUserID.c_str(), &send_config, &sequence);
     }
 
     void sendRoomMessage(ZIMMessage *message, const std::string &toRoomID,
                          const ZIMMessageSendConfig &config,
                          ZIMMessageSentCallback callback) override {
-        struct zim_message sMessage {};
-        ZIMConverter::sNewZIMMessage(sMessage, message);
+        ZIMBorrowedMessage sMessage(message);
 
         zim_sequence sequence = ++sequence_;
 
@@ -216,18 +215,17 @@ class ZIMImpl : public ZIM {
         send_config.enable_offline_push = false;
 
         {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
-        zim_send_room_message(handle_, sMessage, toRoomID.c_str(), &send_config, &sequence);
-        ZIMConverter::sDelZIMMessage(sMessage);
+        zim_send_room_message(handle_, sMessage.get(), toRoomID.c_str(), &send_config, &sequence);
     }
 
     void sendGroupMessage(ZIMMessage *message, const std::string &toGroupID,
                           const ZIMMessageSendConfig &config,
                           ZIMMessageSentCallback callback) override {
-        struct zim_message sMessage {};
-        ZIMConverter::sNewZIMMessage(sMessage, message);
+        ZIMBorrowedMessage sMessage(message);
 
         zim_sequence sequence = ++sequence_;
 
@@ -235,19 +233,18 @@ class ZIMImpl : public ZIM {
         ZIMConverter::sZIMMessageSendConfig(send_config, &config);
 
         {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
-        zim_send_group_message(handle_, sMessage, toGroupID.c_str(), &send_config, &sequence);
-        ZIMConverter::sDelZIMMessage(sMessage);
+        zim_send_group_message(handle_, sMessage.get(), toGroupID.c_str(), &send_config, &sequence);
     }
 
     void sendMessage(std::shared_ptr<ZIMMessage> message, const std::string &toConversationID,
                      ZIMConversationType conversationType, const ZIMMessageSendConfig &config,
                      std::shared_ptr<ZIMMessageSendNotification> notification,
                      ZIMMessageSentCallback callback) override {
-        struct zim_message sMessage {};
-        ZIMConverter::sNewZIMMessage(sMessage, message.get());
+        ZIMBorrowedMessage sMessage(message.get());
 
         zim_sequence sequence = ++sequence_;
 
@@ -255,21 +252,17 @@ class ZIMImpl : public ZIM {
         ZIMConverter::sZIMMessageSendConfig(send_config, &config);
 
         {
-            std::lock_guard<std::mutex> lock(this->send_message_notification_callbacks_mutex_);
-            this->send_message_notification_callbacks_[sequence] = notification;
-        }
-        {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
-        }
-        if (message->getMessageID() == 0 && message->getLocalMessageID() == 0) {
-            std::lock_guard<std::mutex> lock(this->message_obj_map_mutex_);
-            this->message_obj_map_[sequence] = message;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            pending.notification = notification;
+            if (message->getMessageID() == 0 && message->getLocalMessageID() == 0) {
+                pending.message = message;
+            }
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
 
-        zim_send_message(handle_, sMessage, toConversationID.c_str(),
+        zim_send_message(handle_, sMessage.get(), toConversationID.c_str(),
                          (zim_conversation_type)conversationType, send_config, &sequence);
-        ZIMConverter::sDelZIMMessage(sMessage);
     }
 
     void sendMediaMessage(ZIMMediaMessage *message, const std::string &toConversationID,
@@ -285,12 +278,10 @@ class ZIMImpl : public ZIM {
         ZIMConverter::sZIMMessageSendConfig(send_config, &config);
 
         {
-            std::lock_guard<std::mutex> lock(this->media_send_progress_callbacks_mutex_);
-            this->media_send_progress_callbacks_[sequence] = progress;
-        }
-        {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            pending.progress = progress;
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
 
         zim_send_media_message(handle_, sMessage, toConversationID.c_str(),
@@ -312,17 +303,13 @@ class ZIMImpl : public ZIM {
         ZIMConverter::sZIMMessageSendConfig(send_config, &config);
 
         {
-            std::lock_guard<std::mutex> lock(
-                this->send_media_message_notification_callbacks_mutex_);
-            this->send_media_message_notification_callbacks_[sequence] = notification;
-        }
-        {
-            std::lock_guard<std::mutex> lock(this->message_sent_callbacks_mutex_);
-            this->message_sent_callbacks_[sequence] = callback;
-        }
-        if (message->getMessageID() == 0 && message->getLocalMessageID() == 0) {
-            std::lock_guard<std::mutex> lock(this->message_obj_map_mutex_);
-            this->message_obj_map_[sequence] = message;
+            ZIMPendingMessage pending;
+            pending.callback = callback;
+            pending.mediaNotification = notification;
+            if (message->getMessageID() == 0 && message->getLocalMessageID() == 0) {
+                pending.message = message;
+            }
+            this->pending_messages_.insert(sequence, std::move(pending));
         }
 
         zim_send_media_message(handle_, sMessage, toConversationID.c_str(),
@@ -2184,9 +2171,6 @@ class ZIMImpl : public ZIM {
     std::unordered_map<zim_sequence, ZIMMessageQueriedCallback> message_queried_callbacks_;
     std::mutex message_queried_callbacks_mutex_;
 
-    std::unordered_map<zim_sequence, ZIMMessageSentCallback> message_sent_callbacks_;
-    std::mutex message_sent_callbacks_mutex_;
-
     std::unordered_map<zim_sequence, ZIMMessageInsertedCallback> message_inserted_callbacks_;
     std::mutex message_inserted_callbacks_mutex_;
 
@@ -2201,17 +2185,6 @@ class ZIMImpl : public ZIM {
     std::unordered_map<zim_sequence, ZIMMediaDownloadedCallback> media_download_callbacks_;
     std::mutex media_download_callbacks_mutex_;
 
-    std::unordered_map<zim_sequence, ZIMMediaUploadingProgress> media_send_progress_callbacks_;
-    std::mutex media_send_progress_callbacks_mutex_;
-
-    std::unordered_map<zim_sequence, std::shared_ptr<ZIMMessageSendNotification>>
-        send_message_notification_callbacks_;
-    std::mutex send_message_notification_callbacks_mutex_;
-
-    std::unordered_map<zim_sequence, std::shared_ptr<ZIMMediaMessageSendNotification>>
-        send_media_message_notification_callbacks_;
-    std::mutex send_media_message_notification_callbacks_mutex_;
-
     std::unordered_map<zim_sequence, ZIMMediaDownloadingProgress>
         media_downloading_progress_callbacks_;
     std::mutex media_downloading_progress_callbacks_mutex_;
@@ -2523,6 +2496,10 @@ class ZIMImpl : public ZIM {
     std::mutex blacklist_checked_callbacks_mutex_;
 
   public:
+    // sends waiting for their attached, progress and sent callbacks
+    ZIMPendingMessageTable pending_messages_;
+
+    // messages passed to downloadMediaFile and insertMessageToLocalDB
     std::unordered_map<zim_sequence, std::shared_ptr<ZIMMessage>> message_obj_map_;
     std::mutex message_obj_map_mutex_;
 
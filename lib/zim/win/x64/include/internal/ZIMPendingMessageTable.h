@@ -0,0 +1,155 @@
+#pragma once
+
+//
+//  ZIMPendingMessageTable.h
+//  ZIM
+//
+//  Everything a message send is waiting for, kept in one slot per sequence.
+//
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace zim {
+
+struct ZIMPendingMessage {
+    ZIMMessageSentCallback callback;
+    ZIMMediaUploadingProgress progress;
+    std::shared_ptr<ZIMMessageSendNotification> notification;
+    std::shared_ptr<ZIMMediaMessageSendNotification> mediaNotification;
+    // only set for messages the caller has not sent before. The attached, progress and sent
+    // callbacks all update this object in place and hand it back, instead of converting a new one.
+    std::shared_ptr<ZIMMessage> message;
+};
+
+// Pending sends keyed by sequence. The table is split into shards by the low bits of the sequence,
+// each shard is an open-addressed array with linear probing, so a send and its completion take one
+// lock and one probe, and no node is allocated per message once the arrays have grown to the
+// number of messages in flight.
+class ZIMPendingMessageTable {
+  public:
+    void insert(zim_sequence sequence, ZIMPendingMessage &&pending) {
+        Shard &shard = shardOf(sequence);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if ((shard.size + 1) * 2 > shard.slots.size()) {
+            grow(shard);
+        }
+        size_t index = probe(shard, sequence);
+        Slot &slot = shard.slots[index];
+        if (!slot.used) {
+            slot.used = true;
+            slot.sequence = sequence;
+            ++shard.size;
+        }
+        slot.pending = std::move(pending);
+    }
+
+    // Runs `visitor` on the pending entry under the shard lock, returns false if there is none.
+    template <typename Visitor> bool visit(zim_sequence sequence, Visitor visitor) {
+        Shard &shard = shardOf(sequence);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.slots.empty()) {
+            return false;
+        }
+        Slot &slot = shard.slots[probe(shard, sequence)];
+        if (!slot.used) {
+            return false;
+        }
+        visitor(slot.pending);
+        return true;
+    }
+
+    // Removes the pending entry and moves it to `pending`, returns false if there is none.
+    bool take(zim_sequence sequence, ZIMPendingMessage &pending) {
+        Shard &shard = shardOf(sequence);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.slots.empty()) {
+            return false;
+        }
+        size_t index = probe(shard, sequence);
+        if (!shard.slots[index].used) {
+            return false;
+        }
+        pending = std::move(shard.slots[index].pending);
+        erase(shard, index);
+        return true;
+    }
+
+  private:
+    static const size_t kShardBits = 4;
+    static const size_t kShardCount = 1 << kShardBits;
+    static const size_t kInitialSlots = 16;
+
+    struct Slot {
+        bool used = false;
+        zim_sequence sequence = 0;
+        ZIMPendingMessage pending;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        // size is a power of two and at least twice the number of used slots
+        std::vector<Slot> slots;
+        size_t size = 0;
+    };
+
+    Shard &shardOf(zim_sequence sequence) {
+        return shards_[static_cast<size_t>(sequence) & (kShardCount - 1)];
+    }
+
+    // Sequences are handed out consecutively, so the bits above the shard index spread them
+    // over the slots without further hashing.
+    static size_t home(const Shard &shard, zim_sequence sequence) {
+        return (static_cast<size_t>(sequence) >> kShardBits) & (shard.slots.size() - 1);
+    }
+
+    // index of the slot holding `sequence`, or of the free slot where it would go
+    static size_t probe(const Shard &shard, zim_sequence sequence) {
+        size_t mask = shard.slots.size() - 1;
+        size_t index = home(shard, sequence);
+        while (shard.slots[index].used && shard.slots[index].sequence != sequence) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    static void grow(Shard &shard) {
+        std::vector<Slot> old;
+        old.swap(shard.slots);
+        shard.slots.resize(old.empty() ? kInitialSlots : old.size() * 2);
+        for (Slot &slot : old) {
+            if (slot.used) {
+                Slot &target = shard.slots[probe(shard, slot.sequence)];
+                target.used = true;
+                target.sequence = slot.sequence;
+                target.pending = std::move(slot.pending);
+            }
+        }
+    }
+
+    // Backward shift deletion: entries probed past the freed slot move back into it, so lookups
+    // never have to step over tombstones.
+    static void erase(Shard &shard, size_t index) {
+        size_t mask = shard.slots.size() - 1;
+        size_t next = (index + 1) & mask;
+        while (shard.slots[next].used) {
+            size_t wanted = home(shard, shard.slots[next].sequence);
+            // the entry may fill the hole if its home is not in the cyclic range (index, next]
+            if (((next - wanted) & mask) >= ((next - index) & mask)) {
+                shard.slots[index].sequence = shard.slots[next].sequence;
+                shard.slots[index].pending = std::move(shard.slots[next].pending);
+                index = next;
+            }
+            next = (next + 1) & mask;
+        }
+        shard.slots[index].used = false;
+        shard.slots[index].pending = ZIMPendingMessage();
+        --shard.size;
+    }
+
+    Shard shards_[kShardCount];
+};
+
+} // namespace zim
@@ -0,0 +1,108 @@
+#include "completion_tracker.h"
+
+#include <algorithm>
+
+CompletionTracker::CompletionTracker(Clock::duration timeout, Clock::duration tick)
+	: timeout_(timeout), tick_(std::max(tick, Clock::duration(1))), origin_(Clock::now())
+{
+	// one turn of the wheel covers the timeout, so a slot never holds two deadlines a turn apart unless
+	// expire() falls behind, which the deadline tick stored with every token takes care of
+	slots_.resize(static_cast<size_t>(timeout_ / tick_) + 2);
+	ring_.resize(1024);
+}
+
+uint64_t CompletionTracker::tickOf(Clock::time_point time) const
+{
+	if (time <= origin_) {
+		return 0;
+	}
+	return static_cast<uint64_t>((time - origin_) / tick_);
+}
+
+uint64_t CompletionTracker::start(Clock::time_point now, void *context)
+{
+	// rounded up, an operation never times out early
+	uint64_t deadline = tickOf(now + timeout_) + 1;
+	std::lock_guard<std::mutex> lock(mutex_);
+	uint64_t token = ++next_token_;
+	if (ring_[token & (ring_.size() - 1)].token != 0) {
+		grow(token);
+	}
+	Entry &entry = ring_[token & (ring_.size() - 1)];
+	entry.token = token;
+	entry.context = context;
+	++outstanding_;
+	slots_[deadline % slots_.size()].emplace_back(token, deadline);
+	return token;
+}
+
+bool CompletionTracker::complete(uint64_t token)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Entry entry;
+	return take(token, entry);
+}
+
+bool CompletionTracker::take(uint64_t token, Entry &entry)
+{
+	Entry &place = ring_[token & (ring_.size() - 1)];
+	if (token == 0 || place.token != token) {
+		return false;
+	}
+	entry = place;
+	place = Entry();
+	--outstanding_;
+	return true;
+}
+
+void CompletionTracker::grow(uint64_t token)
+{
+	// tokens apart by less than the size never share a place, nor do they in the doubled ring
+	std::vector<Entry> ring(ring_.size() * 2);
+	for (const auto &entry : ring_) {
+		if (entry.token != 0) {
+			ring[entry.token & (ring.size() - 1)] = entry;
+		}
+	}
+	ring_.swap(ring);
+	if (ring_[token & (ring_.size() - 1)].token != 0) {
+		grow(token);
+	}
+}
+
+size_t CompletionTracker::expire(Clock::time_point now, std::vector<void *> *contexts)
+{
+	uint64_t target = tickOf(now);
+	size_t expired = 0;
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (target < current_) {
+		return 0;
+	}
+	// after a long pause every slot is visited once
+	uint64_t ticks = std::min<uint64_t>(target - current_ + 1, slots_.size());
+	for (uint64_t i = 0; i < ticks; ++i) {
+		auto &slot = slots_[(current_ + i) % slots_.size()];
+		auto kept = std::remove_if(slot.begin(), slot.end(), [&](const std::pair<uint64_t, uint64_t> &entry) {
+			if (entry.second > target) {
+				return false;
+			}
+			Entry outstanding;
+			if (take(entry.first, outstanding)) {
+				if (contexts && outstanding.context) {
+					contexts->push_back(outstanding.context);
+				}
+				++expired;
+			}
+			return true;
+		});
+		slot.erase(kept, slot.end());
+	}
+	current_ = target + 1;
+	return expired;
+}
+
+size_t CompletionTracker::outstanding() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return outstanding_;
+}
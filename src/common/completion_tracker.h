@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Outstanding operations with a deadline on a timing wheel, to notice callbacks that never come.
+// start() and complete() are O(1) under one lock and allocate nothing once the ring and the wheel have
+// grown to the load; expire() only looks at the slots of the ticks that passed since its last call.
+class CompletionTracker {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	CompletionTracker(Clock::duration timeout, Clock::duration tick);
+
+	// Tracks a new operation started at `now` and returns its token. `context` is handed back by expire()
+	// if the operation times out.
+	uint64_t start(Clock::time_point now, void *context = nullptr);
+	// Called from the operation's callback. False if the operation already timed out, its state is gone
+	// and the callback is late.
+	bool complete(uint64_t token);
+	// Drops the operations whose deadline passed before `now` and returns how many there were. Their contexts
+	// are appended to `contexts`, those that have one.
+	size_t expire(Clock::time_point now, std::vector<void *> *contexts = nullptr);
+
+	size_t outstanding() const;
+
+private:
+	// an outstanding operation in the ring, at its token modulo the size of the ring
+	struct Entry {
+		// 0 if the place is free
+		uint64_t token = 0;
+		void *context = nullptr;
+	};
+
+	uint64_t tickOf(Clock::time_point time) const;
+	// Removes the operation of `token` if it is still outstanding, and returns its entry.
+	bool take(uint64_t token, Entry &entry);
+	// doubles the ring until `token` has a free place in it
+	void grow(uint64_t token);
+
+	const Clock::duration timeout_;
+	const Clock::duration tick_;
+	const Clock::time_point origin_;
+
+	mutable std::mutex mutex_;
+	// (token, deadline tick) in the slot of their deadline tick; completed tokens stay behind until their
+	// slot comes round and are skipped then
+	std::vector<std::vector<std::pair<uint64_t, uint64_t>>> slots_;
+	// tokens are handed out in order, so the outstanding ones are a window of them that a ring holds
+	// without collisions once it is larger than that window
+	std::vector<Entry> ring_;
+	size_t outstanding_ = 0;
+	uint64_t next_token_ = 0;
+	// ticks before this one have been expired
+	uint64_t current_ = 0;
+};
@@ -0,0 +1,86 @@
+#include "control_socket.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+ControlSocket::~ControlSocket()
+{
+	if (fd_ >= 0) {
+		close(fd_);
+	}
+	// forked workers inherit the object, only the parent removes the path
+	if (!path_.empty() && owner_ == getpid()) {
+		unlink(path_.c_str());
+	}
+}
+
+bool ControlSocket::listen(const std::string &path)
+{
+	sockaddr_un address{};
+	if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+		return false;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return false;
+	}
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	unlink(path.c_str());
+	if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, 16) != 0) {
+		close(fd);
+		return false;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fd_ = fd;
+	path_ = path;
+	owner_ = getpid();
+	return true;
+}
+
+void ControlSocket::poll(const Handler &handler)
+{
+	if (fd_ < 0) {
+		return;
+	}
+	for (;;) {
+		int client = accept(fd_, nullptr, nullptr);
+		if (client < 0) {
+			return;
+		}
+		// like the metrics endpoint, a silent client must not stall the caller's loop
+		timeval timeout{0, 100 * 1000};
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		std::string command;
+		char buffer[256];
+		while (command.find('\n') == std::string::npos && command.size() < 1024) {
+			ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+			if (received <= 0) {
+				break;
+			}
+			command.append(buffer, received);
+		}
+		command = command.substr(0, command.find('\n'));
+		if (!command.empty() && command.back() == '\r') {
+			command.pop_back();
+		}
+
+		std::string reply = handler(command);
+		size_t offset = 0;
+		while (offset < reply.size()) {
+			ssize_t written = send(client, reply.data() + offset, reply.size() - offset, MSG_NOSIGNAL);
+			if (written <= 0) {
+				break;
+			}
+			offset += written;
+		}
+		close(client);
+	}
+}
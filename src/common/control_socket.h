@@ -0,0 +1,33 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <functional>
+#include <string>
+
+// Unix domain stream socket taking one command line per connection and answering it, e.g.
+//
+//     echo "qps 2000" | nc -U /tmp/zimcli.sock
+//
+// Polled from the caller's loop like MetricsEmitter, so the parent of --users stays single threaded.
+class ControlSocket {
+public:
+	// the reply to a command, sent back before the connection is closed
+	typedef std::function<std::string(const std::string &command)> Handler;
+
+	ControlSocket() = default;
+	ControlSocket(const ControlSocket &) = delete;
+	ControlSocket &operator=(const ControlSocket &) = delete;
+	// closes the socket, the process that bound it also removes the path
+	~ControlSocket();
+
+	// replaces a stale socket file left behind by a killed run
+	bool listen(const std::string &path);
+	// Answers every connection waiting to be accepted.
+	void poll(const Handler &handler);
+
+private:
+	std::string path_;
+	int fd_ = -1;
+	pid_t owner_ = 0;
+};
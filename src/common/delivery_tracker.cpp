@@ -0,0 +1,152 @@
+#include "delivery_tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+// digits up to `separator`, which is consumed as well
+bool parseNumber(const char *&p, const char *end, char separator, uint64_t &value)
+{
+	const char *start = p;
+	value = 0;
+	while (p < end && *p >= '0' && *p <= '9') {
+		value = value * 10 + uint64_t(*p - '0');
+		++p;
+	}
+	if (p == start || p - start > 20 || p == end || *p != separator) {
+		return false;
+	}
+	++p;
+	return true;
+}
+
+} // namespace
+
+const size_t MessageStamp::kMaxLength;
+const uint64_t DeliveryTracker::kWindow;
+
+size_t MessageStamp::write(char *buffer) const
+{
+	int length = std::snprintf(buffer, kMaxLength, "zc:%llu:%llu:%llu|", (unsigned long long)epoch,
+				   (unsigned long long)sequence, (unsigned long long)sent_micros);
+	return length > 0 ? size_t(length) : 0;
+}
+
+bool MessageStamp::parse(const std::string &text, MessageStamp &stamp)
+{
+	if (text.compare(0, 3, "zc:") != 0) {
+		return false;
+	}
+	const char *p = text.data() + 3;
+	const char *end = text.data() + std::min(text.size(), kMaxLength);
+	return parseNumber(p, end, ':', stamp.epoch) && parseNumber(p, end, ':', stamp.sequence) &&
+	       parseNumber(p, end, '|', stamp.sent_micros);
+}
+
+uint64_t unixMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+DeliveryTracker::Outcome DeliveryTracker::record(const std::string &user_id, const MessageStamp &stamp)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	++metrics_.received;
+	Sender &sender = senders_[user_id];
+	++sender.summary.received;
+
+	if (sender.seen.empty() || stamp.epoch > sender.epoch) {
+		if (sender.summary.user_id.empty()) {
+			sender.summary.user_id = user_id;
+		}
+		reset(sender, stamp);
+		return InOrder;
+	}
+	if (stamp.epoch < sender.epoch) {
+		return Stale;
+	}
+
+	if (stamp.sequence > sender.highest) {
+		// the bits of the sequences entering the window still describe the ones kWindow below them
+		uint64_t advance = std::min(stamp.sequence - sender.highest, kWindow);
+		for (uint64_t i = 0; i < advance; ++i) {
+			uint64_t bit = (stamp.sequence - i) % kWindow;
+			sender.seen[bit / 64] &= ~(1ULL << (bit % 64));
+		}
+		uint64_t gap = stamp.sequence - sender.highest - 1;
+		sender.highest = stamp.sequence;
+		mark(sender, stamp.sequence);
+		if (gap > 0) {
+			sender.summary.missing += gap;
+			metrics_.missing += gap;
+		}
+		return InOrder;
+	}
+
+	bool in_window = sender.highest - stamp.sequence < kWindow;
+	if (in_window && test(sender, stamp.sequence)) {
+		++sender.summary.duplicates;
+		++metrics_.duplicates;
+		return Duplicate;
+	}
+	if (in_window) {
+		mark(sender, stamp.sequence);
+	}
+	++sender.summary.reordered;
+	++metrics_.reordered;
+	// only a gap counted as missing is filled: not a late arrival from before the first message of the
+	// run, and not one too far back to tell from a duplicate
+	if (in_window && stamp.sequence > sender.first) {
+		--sender.summary.missing;
+		--metrics_.missing;
+	}
+	return Reordered;
+}
+
+std::vector<DeliveryTracker::SenderSummary> DeliveryTracker::worst(size_t limit) const
+{
+	std::vector<SenderSummary> summaries;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		summaries.reserve(senders_.size());
+		for (const auto &entry : senders_) {
+			summaries.push_back(entry.second.summary);
+		}
+	}
+	limit = std::min(limit, summaries.size());
+	std::partial_sort(summaries.begin(), summaries.begin() + limit, summaries.end(),
+			  [](const SenderSummary &a, const SenderSummary &b) { return a.missing > b.missing; });
+	summaries.resize(limit);
+	return summaries;
+}
+
+size_t DeliveryTracker::senderCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return senders_.size();
+}
+
+bool DeliveryTracker::test(const Sender &sender, uint64_t sequence)
+{
+	uint64_t bit = sequence % kWindow;
+	return (sender.seen[bit / 64] >> (bit % 64)) & 1;
+}
+
+void DeliveryTracker::mark(Sender &sender, uint64_t sequence)
+{
+	uint64_t bit = sequence % kWindow;
+	sender.seen[bit / 64] |= 1ULL << (bit % 64);
+}
+
+void DeliveryTracker::reset(Sender &sender, const MessageStamp &stamp)
+{
+	sender.epoch = stamp.epoch;
+	sender.first = stamp.sequence;
+	sender.highest = stamp.sequence;
+	sender.seen.assign(kWindow / 64, 0);
+	mark(sender, stamp.sequence);
+}
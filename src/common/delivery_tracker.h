@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shared_metrics.h"
+
+// Header the sender writes in front of every message body, "zc:<epoch>:<sequence>:<sent at>|", so a
+// receiver can measure one-way latency and check the sequence. The epoch is the start time of the
+// sending process and tells two runs of the same user apart.
+struct MessageStamp {
+	static const size_t kMaxLength = 72;
+
+	uint64_t epoch = 0;
+	// 1 for the first message of a run
+	uint64_t sequence = 0;
+	// unix time in microseconds when the message was handed to sendMessage
+	uint64_t sent_micros = 0;
+
+	// writes the header to `buffer`, which holds at least kMaxLength bytes, and returns its length
+	size_t write(char *buffer) const;
+	// false if `text` does not start with a stamp
+	static bool parse(const std::string &text, MessageStamp &stamp);
+};
+
+uint64_t unixMicros();
+
+// Receiving side of the stamps: keeps the highest sequence and a sliding window of the sequences seen
+// below it for every sender, and counts into `metrics` what arrives in order, what arrives late and
+// fills a gap, what arrives twice, and how many sequences are still missing. Counting starts with the
+// first message received from a sender.
+class DeliveryTracker {
+public:
+	enum Outcome {
+		InOrder,
+		Reordered,
+		Duplicate,
+		// from an older run of the sender, not counted against the current one
+		Stale,
+	};
+
+	struct SenderSummary {
+		std::string user_id;
+		uint64_t received = 0;
+		uint64_t duplicates = 0;
+		uint64_t reordered = 0;
+		uint64_t missing = 0;
+	};
+
+	explicit DeliveryTracker(WorkerMetrics &metrics) : metrics_(metrics) {}
+
+	// thread safe, the SDK may deliver from several callback threads
+	Outcome record(const std::string &sender, const MessageStamp &stamp);
+
+	// the senders with the most missing sequences first, at most `limit` of them
+	std::vector<SenderSummary> worst(size_t limit) const;
+	size_t senderCount() const;
+
+private:
+	// sequences this far below the highest one are treated as late arrivals without checking for
+	// duplicates
+	static const uint64_t kWindow = 4096;
+
+	struct Sender {
+		uint64_t epoch = 0;
+		// the sequence counting started with, the ones before it were never missing
+		uint64_t first = 0;
+		uint64_t highest = 0;
+		// bit (sequence % kWindow) is set if that sequence arrived, for the kWindow sequences up to highest
+		std::vector<uint64_t> seen;
+		SenderSummary summary;
+	};
+
+	static bool test(const Sender &sender, uint64_t sequence);
+	static void mark(Sender &sender, uint64_t sequence);
+	void reset(Sender &sender, const MessageStamp &stamp);
+
+	WorkerMetrics &metrics_;
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, Sender> senders_;
+};
@@ -0,0 +1,113 @@
+#include "event_handler.h"
+
+#include <iostream>
+
+#include "delivery_tracker.h"
+#include "history_walker.h"
+#include "media_transfer.h"
+#include "read_receipts.h"
+#include "worker.h"
+
+EventHandler::EventHandler(Worker &worker) : worker_(worker) {}
+
+void EventHandler::onConnectionStateChanged(zim::ZIM * /*zim*/, zim::ZIMConnectionState state,
+					    zim::ZIMConnectionEvent event, const std::string & /*extendedData*/)
+{
+	worker_.metrics().connectionChanges().record(static_cast<int>(state), static_cast<int>(event));
+	if (worker_.options().debug != 0) {
+		std::cout << "[event][onConnectionStateChanged] state:" << state << ",event:" << event << std::endl;
+	}
+}
+
+void EventHandler::onReceivePeerMessage(zim::ZIM * /*zim*/,
+					const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+					const std::string &fromUserID)
+{
+	record(messageList, std::string(), "onReceivePeerMessage");
+	download(messageList);
+	markRead(messageList, fromUserID, zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER);
+}
+
+void EventHandler::onReceiveRoomMessage(zim::ZIM * /*zim*/,
+					const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+					const std::string &fromRoomID)
+{
+	record(messageList, fromRoomID, "onReceiveRoomMessage");
+	download(messageList);
+}
+
+void EventHandler::onReceiveGroupMessage(zim::ZIM * /*zim*/,
+					 const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+					 const std::string &fromGroupID)
+{
+	record(messageList, fromGroupID, "onReceiveGroupMessage");
+	download(messageList);
+	markRead(messageList, fromGroupID, zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_GROUP);
+}
+
+void EventHandler::onMessageReceiptChanged(zim::ZIM * /*zim*/, const std::vector<zim::ZIMMessageReceiptInfo> &infos)
+{
+	if (worker_.receipts()) {
+		worker_.receipts()->changed(infos);
+	}
+}
+
+void EventHandler::record(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+			  const std::string &group, const char *event)
+{
+	DeliveryTracker *tracker = worker_.tracker();
+	if (!tracker) {
+		// a sender somebody else sends to
+		return;
+	}
+	HistoryWalker *history = worker_.history();
+	WorkerMetrics &slot = worker_.slot();
+	uint64_t now = unixMicros();
+	for (const auto &message : messageList) {
+		if (history) {
+			history->cache().add(*message);
+		}
+		MessageStamp stamp;
+		const std::string *body = nullptr;
+		if (message->getType() == zim::ZIM_MESSAGE_TYPE_TEXT) {
+			body = &static_cast<zim::ZIMTextMessage *>(message.get())->message;
+		} else if (message->getType() == zim::ZIM_MESSAGE_TYPE_BARRAGE) {
+			body = &static_cast<zim::ZIMBarrageMessage *>(message.get())->message;
+		} else if (isMedia(message->getType())) {
+			// see MessageSender::sendMedia
+			body = &message->extendedData;
+		}
+		if (!body || !MessageStamp::parse(*body, stamp)) {
+			// not sent by zimcli, nothing to check
+			++slot.received;
+			continue;
+		}
+		worker_.metrics().deliveryLatency().record(now > stamp.sent_micros ? now - stamp.sent_micros : 0);
+		auto outcome = tracker->record(
+			group.empty() ? message->getSenderUserID() : message->getSenderUserID() + "@" + group, stamp);
+		if (worker_.options().debug != 0) {
+			std::cout << "[event][" << event << "] from:" << message->getSenderUserID()
+				  << ",sequence:" << stamp.sequence << ",outcome:" << outcome << std::endl;
+		}
+	}
+}
+
+void EventHandler::markRead(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+			    const std::string &conversationID, zim::ZIMConversationType type)
+{
+	if (worker_.receipts()) {
+		worker_.receipts()->markRead(messageList, conversationID, type);
+	}
+}
+
+void EventHandler::download(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList)
+{
+	if (worker_.options().download_media == 0 || !worker_.tracker()) {
+		return;
+	}
+	for (const auto &message : messageList) {
+		if (isMedia(message->getType())) {
+			worker_.media()->download(std::static_pointer_cast<zim::ZIMMediaMessage>(message));
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ZIM.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Worker;
+
+// Counts the connection state changes of every worker. For --role receiver, room and group members it
+// also checks the stamp of every message and records its delivery latency, with --read-receipts it
+// batches the messages to mark read and with --download-media it downloads the media files. Senders time
+// the read receipts of their messages.
+class EventHandler : public zim::ZIMEventHandler {
+public:
+	explicit EventHandler(Worker &worker);
+
+	void onConnectionStateChanged(zim::ZIM *zim, zim::ZIMConnectionState state, zim::ZIMConnectionEvent event,
+				      const std::string &extendedData) override;
+	void onReceivePeerMessage(zim::ZIM *zim, const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+				  const std::string &fromUserID) override;
+	void onReceiveRoomMessage(zim::ZIM *zim, const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+				  const std::string &fromRoomID) override;
+	void onReceiveGroupMessage(zim::ZIM *zim, const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+				   const std::string &fromGroupID) override;
+	void onMessageReceiptChanged(zim::ZIM *zim, const std::vector<zim::ZIMMessageReceiptInfo> &infos) override;
+
+private:
+	// sequences are checked per sender and room or `group`, a sender numbers the messages to each of its
+	// conversations separately
+	void record(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList, const std::string &group,
+		    const char *event);
+	// queues the messages that wait for a receipt with ReadReceipts
+	void markRead(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+		      const std::string &conversationID, zim::ZIMConversationType type);
+	// starts a downloadMediaFile for every media message
+	void download(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList);
+
+	Worker &worker_;
+};
@@ -0,0 +1,160 @@
+#include "group_provisioner.h"
+
+#include <algorithm>
+
+const size_t GroupProvisioner::kInviteBatch;
+
+struct GroupProvisioner::Failures {
+	std::mutex mutex;
+	std::map<int, size_t> codes;
+};
+
+// one create() or dismiss(), shared with the callbacks of its requests
+struct GroupProvisioner::Run {
+	Run(zim::ZIM *zim, size_t window, WorkerMetrics &metrics, LatencyHistogram &latency,
+	    std::shared_ptr<Failures> failures)
+		: zim(zim), window(window), metrics(metrics), latency(latency), failures(std::move(failures))
+	{
+	}
+
+	zim::ZIM *const zim;
+	InflightWindow window;
+	WorkerMetrics &metrics;
+	LatencyHistogram &latency;
+	const std::shared_ptr<Failures> failures;
+
+	std::mutex mutex;
+	std::vector<std::string> done;
+};
+
+// a group being created, it holds one slot of the window until its last member is invited
+struct GroupProvisioner::Pending {
+	Group group;
+	// members[0, invited) are in the group
+	size_t invited = 0;
+	Clock::time_point started;
+};
+
+GroupProvisioner::GroupProvisioner(zim::ZIM *zim, size_t window, WorkerMetrics &metrics, LatencyHistogram &latency)
+	: zim_(zim), window_(std::max<size_t>(1, window)), metrics_(metrics), latency_(latency),
+	  failures_(std::make_shared<Failures>())
+{
+}
+
+std::shared_ptr<GroupProvisioner::Run> GroupProvisioner::start()
+{
+	auto run = std::make_shared<Run>(zim_, window_, metrics_, latency_, failures_);
+	std::lock_guard<std::mutex> lock(mutex_);
+	run_ = run;
+	return run;
+}
+
+void GroupProvisioner::stop()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (run_) {
+		run_->window.stop();
+	}
+}
+
+std::vector<std::string> GroupProvisioner::create(const std::vector<Group> &groups, Clock::time_point deadline)
+{
+	auto run = start();
+	for (const auto &group : groups) {
+		if (!run->window.acquireUntil(deadline)) {
+			break;
+		}
+		auto pending = std::make_shared<Pending>();
+		pending->group = group;
+		pending->invited = std::min(kInviteBatch, group.members.size());
+		pending->started = Clock::now();
+
+		auto created = [run, pending](const zim::ZIMGroupFullInfo &,
+					      const std::vector<zim::ZIMGroupMemberInfo> &,
+					      const std::vector<zim::ZIMErrorUserInfo> &, const zim::ZIMError &error) {
+			if (error.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_GROUP_MODULE_GROUP_ALREADY_EXISTS) {
+				// not dismissed by an interrupted run, its members are the ones we would invite
+				pending->invited = pending->group.members.size();
+			} else if (error.code != zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+				fail(*run, error);
+				return;
+			}
+			invite(run, pending);
+		};
+		std::vector<std::string> first(group.members.begin(), group.members.begin() + pending->invited);
+		zim_->createGroup(zim::ZIMGroupInfo(group.group_id, group.group_id, ""), first, created);
+	}
+	run->window.drainUntil(deadline);
+
+	std::lock_guard<std::mutex> lock(run->mutex);
+	return run->done;
+}
+
+void GroupProvisioner::invite(const std::shared_ptr<Run> &run, const std::shared_ptr<Pending> &pending)
+{
+	const auto &members = pending->group.members;
+	if (pending->invited >= members.size()) {
+		run->latency.record(Clock::now() - pending->started);
+		++run->metrics.groups_ready;
+		{
+			std::lock_guard<std::mutex> lock(run->mutex);
+			run->done.push_back(pending->group.group_id);
+		}
+		run->window.release();
+		return;
+	}
+
+	size_t end = std::min(pending->invited + kInviteBatch, members.size());
+	std::vector<std::string> batch(members.begin() + pending->invited, members.begin() + end);
+	pending->invited = end;
+	run->zim->inviteUsersIntoGroup(batch, pending->group.group_id,
+				       [run, pending](const std::string &, const std::vector<zim::ZIMGroupMemberInfo> &,
+						      const std::vector<zim::ZIMErrorUserInfo> &,
+						      const zim::ZIMError &error) {
+					       if (error.code != zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+						       fail(*run, error);
+						       return;
+					       }
+					       invite(run, pending);
+				       });
+}
+
+void GroupProvisioner::fail(Run &run, const zim::ZIMError &error)
+{
+	++run.metrics.groups_failed;
+	{
+		std::lock_guard<std::mutex> lock(run.failures->mutex);
+		++run.failures->codes[static_cast<int>(error.code)];
+	}
+	run.window.release();
+}
+
+size_t GroupProvisioner::dismiss(const std::vector<std::string> &group_ids, Clock::time_point deadline)
+{
+	auto run = start();
+	for (const auto &group_id : group_ids) {
+		if (!run->window.acquireUntil(deadline)) {
+			break;
+		}
+		zim_->dismissGroup(group_id, [run](const std::string &group_id, const zim::ZIMError &error) {
+			if (error.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+				std::lock_guard<std::mutex> lock(run->mutex);
+				run->done.push_back(group_id);
+			} else {
+				std::lock_guard<std::mutex> lock(run->failures->mutex);
+				++run->failures->codes[static_cast<int>(error.code)];
+			}
+			run->window.release();
+		});
+	}
+	run->window.drainUntil(deadline);
+
+	std::lock_guard<std::mutex> lock(run->mutex);
+	return run->done.size();
+}
+
+std::map<int, size_t> GroupProvisioner::failures() const
+{
+	std::lock_guard<std::mutex> lock(failures_->mutex);
+	return failures_->codes;
+}
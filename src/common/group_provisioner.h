@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ZIM.h>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "inflight_window.h"
+#include "latency_histogram.h"
+#include "shared_metrics.h"
+
+// Sets up and tears down the groups of --conversation group. Requests are pipelined: up to `window`
+// groups are being created at a time, and each one invites its remaining members in batches right from
+// the callback of the previous request, so provisioning a thousand groups costs about a thousand round
+// trips divided by the window instead of a thousand. Callbacks hold on to the state of their run, a
+// run that gave up at its deadline does not leave them dangling.
+class GroupProvisioner {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// members invited per createGroup or inviteUsersIntoGroup, the most the SDK accepts in one call
+	static const size_t kInviteBatch = 100;
+
+	struct Group {
+		std::string group_id;
+		// without the owner, who is the user logged in to `zim`
+		std::vector<std::string> members;
+	};
+
+	// counts into metrics.groups_ready and groups_failed, and records the time from createGroup to the
+	// last invite of every group into `latency`
+	GroupProvisioner(zim::ZIM *zim, size_t window, WorkerMetrics &metrics, LatencyHistogram &latency);
+
+	// Returns the IDs of the groups that are complete by `deadline`. A group left over by an earlier
+	// run under the same ID is reused as it is.
+	std::vector<std::string> create(const std::vector<Group> &groups, Clock::time_point deadline);
+	// Returns how many of `group_ids` were dismissed by `deadline`.
+	size_t dismiss(const std::vector<std::string> &group_ids, Clock::time_point deadline);
+	// Makes the create() or dismiss() running on another thread return now, the following ones run
+	// normally.
+	void stop();
+
+	// failed requests by ZIMErrorCode, of every run so far
+	std::map<int, size_t> failures() const;
+
+private:
+	struct Failures;
+	struct Run;
+	struct Pending;
+
+	std::shared_ptr<Run> start();
+	static void invite(const std::shared_ptr<Run> &run, const std::shared_ptr<Pending> &pending);
+	static void fail(Run &run, const zim::ZIMError &error);
+
+	zim::ZIM *const zim_;
+	const size_t window_;
+	WorkerMetrics &metrics_;
+	LatencyHistogram &latency_;
+
+	mutable std::mutex mutex_;
+	std::shared_ptr<Run> run_;
+	std::shared_ptr<Failures> failures_;
+};
@@ -0,0 +1,81 @@
+#include "group_session.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "worker.h"
+
+GroupSession::GroupSession(Worker &worker) : worker_(worker), owned_(plan(worker.options())) {}
+
+std::vector<GroupProvisioner::Group> GroupSession::plan(const Options &options)
+{
+	std::vector<GroupProvisioner::Group> planned;
+	int index = options.index;
+	const std::string &member_prefix =
+		options.receiver_prefix.empty() ? options.user_prefix : options.receiver_prefix;
+	for (int n = std::max(index, 0); n < options.groups; n += index < 0 ? 1 : options.users) {
+		GroupProvisioner::Group group;
+		group.group_id = options.group_prefix + std::to_string(n);
+		if (index >= 0) {
+			for (int k = 1; k < options.group_size; ++k) {
+				group.members.push_back(member_prefix +
+							std::to_string(options.user_start + (n + k) % options.users));
+			}
+		} else {
+			if (!options.receiver.empty() && options.group_size > 1) {
+				group.members.push_back(options.receiver);
+			}
+			for (int k = 0; int(group.members.size()) + 1 < options.group_size; ++k) {
+				std::string member = options.user_prefix + std::to_string(options.user_start + k);
+				if (member != options.sender && member != options.receiver) {
+					group.members.push_back(member);
+				}
+			}
+		}
+		planned.push_back(group);
+	}
+	return planned;
+}
+
+void GroupSession::start()
+{
+	provisioner_.reset(new GroupProvisioner(worker_.zim(), worker_.options().provision_concurrency, worker_.slot(),
+						worker_.metrics().provisionLatency()));
+}
+
+bool GroupSession::provision()
+{
+	const Options &options = worker_.options();
+	auto started = GroupProvisioner::Clock::now();
+	ready_ = provisioner_->create(owned_, started + std::chrono::seconds(options.execution_time));
+	double seconds = std::chrono::duration<double>(GroupProvisioner::Clock::now() - started).count();
+	auto failures = provisioner_->failures();
+	if (options.verbose || !failures.empty()) {
+		std::cout << "[createGroup] " << options.sender << " ready: " << ready_.size() << "/" << owned_.size()
+			  << " in " << seconds << "s";
+		for (const auto &failure : failures) {
+			std::cout << ", code " << failure.first << ": " << failure.second;
+		}
+		std::cout << std::endl;
+	}
+	return !ready_.empty();
+}
+
+void GroupSession::stop()
+{
+	if (provisioner_) {
+		provisioner_->stop();
+	}
+}
+
+void GroupSession::dismiss()
+{
+	if (ready_.empty()) {
+		return;
+	}
+	size_t dismissed = provisioner_->dismiss(ready_, GroupProvisioner::Clock::now() + std::chrono::seconds(10));
+	if (worker_.options().verbose || dismissed < ready_.size()) {
+		std::cout << "[dismissGroup] " << worker_.options().sender << " dismissed: " << dismissed << "/"
+			  << ready_.size() << std::endl;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "group_provisioner.h"
+#include "options.h"
+
+class Worker;
+
+// The groups a sender of --conversation group owns: created and filled before the sends to them, dismissed
+// at the end.
+class GroupSession {
+public:
+	explicit GroupSession(Worker &worker);
+
+	// The groups of the sender. In fan-out mode worker `index` owns every group n with n % users == index,
+	// and the members of group n are the group_size - 1 users after n % users, so each user is in about
+	// groups * group_size / users groups. A single sender owns all groups and fills them with the receiver
+	// and <user-prefix><n>.
+	static std::vector<GroupProvisioner::Group> plan(const Options &options);
+
+	// once the instance is created
+	void start();
+	// Creates the groups, true if any of them is ready to be sent to. The time it takes is left out of the
+	// send rate but counts against --execution-time.
+	bool provision();
+	// makes provision() give up
+	void stop();
+	// dismiss explicitly, otherwise the next run would find the groups and their members in place
+	void dismiss();
+
+	size_t owned() const { return owned_.size(); }
+	// the groups that were created and are sent to
+	const std::vector<std::string> &ready() const { return ready_; }
+
+private:
+	Worker &worker_;
+	const std::vector<GroupProvisioner::Group> owned_;
+	std::unique_ptr<GroupProvisioner> provisioner_;
+	std::vector<std::string> ready_;
+};
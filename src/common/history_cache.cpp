@@ -0,0 +1,28 @@
+#include "history_cache.h"
+
+void HistoryCache::add(zim::ZIMMessage &message)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	known_.insert(key(message));
+}
+
+bool HistoryCache::addPage(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messages, unsigned int count)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	bool cached = messages.size() == count;
+	for (const auto &message : messages) {
+		cached = !known_.insert(key(*message)).second && cached;
+	}
+	return cached;
+}
+
+size_t HistoryCache::size() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return known_.size();
+}
+
+std::string HistoryCache::key(zim::ZIMMessage &message)
+{
+	return message.getSenderUserID() + "\n" + std::to_string(message.getMessageID());
+}
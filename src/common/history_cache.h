@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ZIM.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// What the SDK of a user keeps in its local cache, as far as --history-walkers can tell: the messages it
+// sent or received during the run and those returned by earlier queryHistoryMessage pages. A full page of
+// such messages can come from the local cache, any other page, including the last one of a walk, needs the
+// server.
+class HistoryCache {
+public:
+	void add(zim::ZIMMessage &message);
+	// Adds the messages of a page queried for `count` of them. True if the page could come from the cache.
+	bool addPage(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messages, unsigned int count);
+	size_t size() const;
+
+private:
+	// message IDs are only unique per sender
+	static std::string key(zim::ZIMMessage &message);
+
+	mutable std::mutex mutex_;
+	std::unordered_set<std::string> known_;
+};
@@ -0,0 +1,118 @@
+#include "history_walker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "message_sender.h"
+#include "worker.h"
+
+HistoryWalker::HistoryWalker(Worker &worker) : worker_(worker) {}
+
+void HistoryWalker::run(const std::vector<std::string> &targets, zim::ZIMConversationType type)
+{
+	MessageSender &sender = *worker_.sender();
+	if (targets.empty() || !sender.begin()) {
+		return;
+	}
+	const Options &options = worker_.options();
+	WorkerMetrics &slot = worker_.slot();
+	RateScheduler::Clock::time_point intended;
+	// the conversations in turn, each one numbers its messages from 1
+	size_t seed = size_t(std::max(options.history_seed, 0)) * targets.size();
+	for (size_t i = 0; i < seed && sender.scheduler().acquire(intended); ++i) {
+		sender.send(targets[i % targets.size()], type, i / targets.size() + 1, intended);
+	}
+	// a send whose callback never came counts once --callback-timeout gives up on it
+	while (!worker_.stopped() && inFlight(slot) > 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	if (options.verbose && options.history_seed > 0) {
+		std::cout << "[history] " << options.sender << " seeded: " << slot.acked << " in "
+			  << std::chrono::duration<double>(RateScheduler::Clock::now() - sender.started()).count()
+			  << "s" << std::endl;
+	}
+	for (int i = 0; i < options.history_walkers && !worker_.stopped(); ++i) {
+		queryPage(targets[i % targets.size()], type, nullptr, 0);
+	}
+	// the walks go on from the callbacks, only the pages that failed come back here
+	while (!worker_.stopped()) {
+		std::vector<Retry> due;
+		{
+			std::lock_guard<std::mutex> lock(retries_mutex_);
+			auto now = RateScheduler::Clock::now();
+			auto waiting = std::partition(retries_.begin(), retries_.end(),
+						      [now](const Retry &retry) { return retry.due > now; });
+			due.assign(waiting, retries_.end());
+			retries_.erase(waiting, retries_.end());
+		}
+		for (const auto &retry : due) {
+			queryPage(retry.target, retry.type, retry.next, retry.failures);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void HistoryWalker::finish()
+{
+	auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(worker_.options().drain_timeout);
+	while (pages_in_flight_ > 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void HistoryWalker::queryPage(const std::string &target, zim::ZIMConversationType type,
+			      const std::shared_ptr<zim::ZIMMessage> &next, unsigned failures)
+{
+	if (worker_.stopped()) {
+		return;
+	}
+	const Options &options = worker_.options();
+	zim::ZIMMessageQueryConfig config;
+	config.nextMessage = next;
+	config.count = options.page_size;
+	config.reverse = options.history_reverse != 0;
+	auto started = RateScheduler::Clock::now();
+	++pages_in_flight_;
+	auto queried = [this, target, type, next, started, failures](
+			       const std::string &, zim::ZIMConversationType,
+			       const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+			       const zim::ZIMError &errorInfo) {
+		const Options &options = worker_.options();
+		MetricsRegion &metrics = worker_.metrics();
+		if (errorInfo.code != zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+			// nothing to tell where it came from
+			++metrics.operation(Operation::HistoryFailed).issued;
+			worker_.recordOperation(Operation::HistoryFailed, started, errorInfo);
+			retryPage(target, type, next, failures + 1);
+			--pages_in_flight_;
+			return;
+		}
+		bool cached = cache_.addPage(messageList, options.page_size);
+		Operation operation = cached ? Operation::HistoryCache : Operation::HistoryServer;
+		++metrics.operation(operation).issued;
+		worker_.recordOperation(operation, started, errorInfo);
+		worker_.slot().history_messages += messageList.size();
+
+		std::shared_ptr<zim::ZIMMessage> after = nullptr;
+		if (messageList.size() < size_t(options.page_size)) {
+			++worker_.slot().history_walks;
+		} else {
+			// a page is in chronological order whichever way the walk goes
+			after = options.history_reverse != 0 ? messageList.front() : messageList.back();
+		}
+		queryPage(target, type, after, 0);
+		--pages_in_flight_;
+	};
+	worker_.zim()->queryHistoryMessage(target, type, config, queried);
+}
+
+void HistoryWalker::retryPage(const std::string &target, zim::ZIMConversationType type,
+			      const std::shared_ptr<zim::ZIMMessage> &next, unsigned failures)
+{
+	auto pause = std::chrono::milliseconds(100) * (1 << std::min(failures - 1, 6u));
+	std::lock_guard<std::mutex> lock(retries_mutex_);
+	retries_.push_back(Retry{RateScheduler::Clock::now() + pause, target, type, next, failures});
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ZIM.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "history_cache.h"
+#include "rate_scheduler.h"
+
+class Worker;
+
+// --history-walkers: a sender seeds each of its conversations with --history-seed messages at --qps, and
+// once they are acked walks them with queryHistoryMessage, page after page from one end to the other and over
+// again, the walks spread over the conversations in turn.
+// The walks go on from the callbacks of their pages. Every page is told apart by whether it could come from
+// the HistoryCache.
+class HistoryWalker {
+public:
+	explicit HistoryWalker(Worker &worker);
+
+	// Seeds `targets` and walks them until the end of the run, querying the pages that failed again.
+	void run(const std::vector<std::string> &targets, zim::ZIMConversationType type);
+	// waits up to --drain-timeout for the pages in flight, the walks stop at them
+	void finish();
+
+	// what the SDK of the user can have in its local cache
+	HistoryCache &cache() { return cache_; }
+
+private:
+	// a page that failed, queried again once `due` has passed
+	struct Retry {
+		RateScheduler::Clock::time_point due;
+		std::string target;
+		zim::ZIMConversationType type;
+		std::shared_ptr<zim::ZIMMessage> next;
+		// failures of the walk in a row
+		unsigned failures;
+	};
+
+	// Queries the page after `next` of a walk, and from its callback the one after it or, past the end of
+	// the conversation, the first page of the next walk. `failures` are the failed pages of the walk in a
+	// row.
+	void queryPage(const std::string &target, zim::ZIMConversationType type,
+		       const std::shared_ptr<zim::ZIMMessage> &next, unsigned failures);
+	// Queues a failed page for run(), the pause doubles with every failure of the walk in a row from 100ms
+	// up to 6.4s, so a failing backend is not queried in a hot loop.
+	void retryPage(const std::string &target, zim::ZIMConversationType type,
+		       const std::shared_ptr<zim::ZIMMessage> &next, unsigned failures);
+
+	Worker &worker_;
+	HistoryCache cache_;
+	std::atomic<uint64_t> pages_in_flight_{0};
+	std::mutex retries_mutex_;
+	std::vector<Retry> retries_;
+};
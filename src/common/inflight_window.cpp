@@ -0,0 +1,57 @@
+#include "inflight_window.h"
+
+InflightWindow::InflightWindow(size_t limit) : limit_(limit) {}
+
+bool InflightWindow::acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	cv_.wait(lock, [this]() { return stopped_ || inflight_ < limit_; });
+	if (stopped_) {
+		return false;
+	}
+	++inflight_;
+	return true;
+}
+
+bool InflightWindow::acquireUntil(Clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (!cv_.wait_until(lock, deadline, [this]() { return stopped_ || inflight_ < limit_; }) || stopped_) {
+		return false;
+	}
+	++inflight_;
+	return true;
+}
+
+bool InflightWindow::drainUntil(Clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	return cv_.wait_until(lock, deadline, [this]() { return stopped_ || inflight_ == 0; }) && !stopped_;
+}
+
+void InflightWindow::release()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (inflight_ > 0) {
+			--inflight_;
+		}
+	}
+	// a drainUntil() may wait next to the acquire(), waking only one of them could pick the wrong one
+	cv_.notify_all();
+}
+
+void InflightWindow::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+	}
+	cv_.notify_all();
+}
+
+size_t InflightWindow::inflight() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return inflight_;
+}
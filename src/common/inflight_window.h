@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+// Bounds the number of outstanding operations for closed-loop load: acquire() blocks while `limit`
+// operations are in flight and returns as soon as a completion calls release().
+class InflightWindow {
+public:
+	explicit InflightWindow(size_t limit);
+
+	typedef std::chrono::steady_clock Clock;
+
+	// Returns false once the window has been stopped.
+	bool acquire();
+	// Also returns false if no slot frees up before `deadline`.
+	bool acquireUntil(Clock::time_point deadline);
+	// Waits until nothing is in flight, false if that does not happen before `deadline` or the window is
+	// stopped.
+	bool drainUntil(Clock::time_point deadline);
+	void release();
+	// Wakes up all waiters; every following acquire() returns false.
+	void stop();
+
+	size_t limit() const { return limit_; }
+	size_t inflight() const;
+
+private:
+	const size_t limit_;
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+	size_t inflight_ = 0;
+	bool stopped_ = false;
+};
@@ -0,0 +1,191 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace histogram_layout {
+
+static int mostSignificantBit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(value);
+#else
+	int bit = 0;
+	while (value >>= 1) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+size_t indexOf(uint64_t value)
+{
+	if (value < kSubBucketCount) {
+		return static_cast<size_t>(value);
+	}
+	int bucket = mostSignificantBit(value) - kSubBucketBits;
+	if (bucket > kMaxValueBits - kSubBucketBits - 1) {
+		return kBucketCount - 1;
+	}
+	uint64_t sub = value >> bucket; // in [kSubBucketCount, 2 * kSubBucketCount)
+	return static_cast<size_t>((bucket + 1) * kSubBucketCount + (sub - kSubBucketCount));
+}
+
+uint64_t highestEquivalentValue(size_t index)
+{
+	if (index < kSubBucketCount) {
+		return index;
+	}
+	int bucket = static_cast<int>(index / kSubBucketCount) - 1;
+	uint64_t sub = index % kSubBucketCount + kSubBucketCount;
+	return ((sub + 1) << bucket) - 1;
+}
+
+} // namespace histogram_layout
+
+using namespace histogram_layout;
+
+HistogramSnapshot::HistogramSnapshot() { counts_.fill(0); }
+
+uint64_t HistogramSnapshot::max() const
+{
+	if (max_ != 0 || count_ == 0) {
+		return max_;
+	}
+	for (size_t i = kBucketCount; i > 0; --i) {
+		if (counts_[i - 1] != 0) {
+			return highestEquivalentValue(i - 1);
+		}
+	}
+	return 0;
+}
+
+uint64_t HistogramSnapshot::quantile(double q) const
+{
+	if (count_ == 0) {
+		return 0;
+	}
+	if (q >= 1.0) {
+		return max();
+	}
+	uint64_t rank = static_cast<uint64_t>(q * count_) + 1;
+	if (rank > count_) {
+		rank = count_;
+	}
+	uint64_t seen = 0;
+	for (size_t i = 0; i < kBucketCount; ++i) {
+		seen += counts_[i];
+		if (seen >= rank) {
+			uint64_t value = highestEquivalentValue(i);
+			return max_ != 0 && value > max_ ? max_ : value;
+		}
+	}
+	return max();
+}
+
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot &earlier) const
+{
+	HistogramSnapshot delta;
+	for (size_t i = 0; i < kBucketCount; ++i) {
+		delta.counts_[i] = counts_[i] - earlier.counts_[i];
+	}
+	delta.count_ = count_ - earlier.count_;
+	delta.sum_ = sum_ - earlier.sum_;
+	// the exact maximum of an interval is not known, max() falls back to the highest non-empty bucket
+	delta.max_ = 0;
+	return delta;
+}
+
+void HistogramSnapshot::add(const HistogramSnapshot &other)
+{
+	for (size_t i = 0; i < kBucketCount; ++i) {
+		counts_[i] += other.counts_[i];
+	}
+	count_ += other.count_;
+	sum_ += other.sum_;
+	max_ = std::max(max_, other.max_);
+}
+
+std::string HistogramSnapshot::encode() const
+{
+	std::ostringstream out;
+	out << count_ << " " << sum_ << " " << max_;
+	for (size_t i = 0; i < kBucketCount; ++i) {
+		if (counts_[i] != 0) {
+			out << " " << i << ":" << counts_[i];
+		}
+	}
+	return out.str();
+}
+
+bool HistogramSnapshot::decode(const std::string &text)
+{
+	HistogramSnapshot decoded;
+	std::istringstream in(text);
+	if (!(in >> decoded.count_ >> decoded.sum_ >> decoded.max_)) {
+		return false;
+	}
+	uint64_t total = 0;
+	size_t index;
+	char colon;
+	uint64_t count;
+	while (in >> index >> colon >> count) {
+		if (colon != ':' || index >= kBucketCount) {
+			return false;
+		}
+		decoded.counts_[index] += count;
+		total += count;
+	}
+	// a bucket cut off or a count that does not add up means the file is damaged
+	if (!in.eof() || total != decoded.count_) {
+		return false;
+	}
+	*this = decoded;
+	return true;
+}
+
+std::string HistogramSnapshot::summary() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "count:" << count_ << " p50:" << quantile(0.5) / 1000.0 << " p90:" << quantile(0.9) / 1000.0
+	    << " p99:" << quantile(0.99) / 1000.0 << " p99.9:" << quantile(0.999) / 1000.0
+	    << " max:" << max() / 1000.0 << " (ms)";
+	return out.str();
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+	for (auto &count : counts_) {
+		count.store(0, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::record(uint64_t micros)
+{
+	counts_[indexOf(micros)].fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(micros, std::memory_order_relaxed);
+
+	uint64_t current = max_.load(std::memory_order_relaxed);
+	while (micros > current && !max_.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration latency)
+{
+	auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+	record(static_cast<uint64_t>(micros < 0 ? 0 : micros));
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+	HistogramSnapshot snapshot;
+	for (size_t i = 0; i < kBucketCount; ++i) {
+		snapshot.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+		snapshot.count_ += snapshot.counts_[i];
+	}
+	snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+	snapshot.max_ = max_.load(std::memory_order_relaxed);
+	return snapshot;
+}
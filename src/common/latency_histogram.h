@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Log-linear bucket layout shared by the recorder and its snapshots, in the spirit of HdrHistogram:
+// values below 2^kSubBucketBits get one bucket each, every following power of two is split into
+// 2^kSubBucketBits equal buckets, so any recorded value is reported within 1/128 of its true value.
+namespace histogram_layout {
+const int kSubBucketBits = 7;
+const uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+// values are microseconds, everything above 2^36us (about 19 hours) lands in the last bucket
+const int kMaxValueBits = 36;
+const size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+size_t indexOf(uint64_t value);
+// largest value that maps to the bucket at `index`
+uint64_t highestEquivalentValue(size_t index);
+} // namespace histogram_layout
+
+// Plain copy of a LatencyHistogram, used to compute quantiles and interval deltas off the hot path.
+class HistogramSnapshot {
+public:
+	HistogramSnapshot();
+
+	uint64_t count() const { return count_; }
+	uint64_t sum() const { return sum_; }
+	uint64_t max() const;
+	double mean() const { return count_ ? double(sum_) / count_ : 0; }
+	// q in [0, 1], e.g. 0.999 for p99.9
+	uint64_t quantile(double q) const;
+
+	// Counts recorded after `earlier` was taken. max() of the result is bucket precision.
+	HistogramSnapshot since(const HistogramSnapshot &earlier) const;
+	// Adds the counts of `other`, e.g. of another host of a distributed run.
+	void add(const HistogramSnapshot &other);
+
+	// "count sum max index:count ..." of the non-empty buckets, read back by decode()
+	std::string encode() const;
+	bool decode(const std::string &text);
+
+	// "count:N p50:x p90:x p99:x p99.9:x max:x" with values in milliseconds
+	std::string summary() const;
+
+private:
+	friend class LatencyHistogram;
+
+	std::array<uint64_t, histogram_layout::kBucketCount> counts_;
+	uint64_t count_ = 0;
+	uint64_t sum_ = 0;
+	uint64_t max_ = 0;
+};
+
+// Lock-free latency recorder. record() may be called from any number of threads (the SDK callback
+// threads in practice); it costs two relaxed atomic adds and, for a new maximum, one compare-exchange.
+class LatencyHistogram {
+public:
+	LatencyHistogram();
+
+	void record(uint64_t micros);
+	void record(std::chrono::steady_clock::duration latency);
+
+	HistogramSnapshot snapshot() const;
+
+private:
+	std::array<std::atomic<uint64_t>, histogram_layout::kBucketCount> counts_;
+	std::atomic<uint64_t> sum_{0};
+	std::atomic<uint64_t> max_{0};
+};
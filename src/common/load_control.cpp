@@ -0,0 +1,208 @@
+#include "load_control.h"
+
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "delivery_tracker.h"
+#include "load_profile.h"
+#include "reporter.h"
+
+namespace {
+
+volatile std::sig_atomic_t dump_signal = 0;
+volatile std::sig_atomic_t reload_signal = 0;
+
+void onControlSignal(int sig)
+{
+	if (sig == SIGUSR1) {
+		dump_signal = 1;
+	} else {
+		reload_signal = 1;
+	}
+}
+
+} // namespace
+
+void LoadControl::catchSignals()
+{
+	std::signal(SIGUSR1, onControlSignal);
+	std::signal(SIGHUP, onControlSignal);
+}
+
+LoadControl::LoadControl(const Options &options, MetricsRegion &metrics, Reporter &reporter)
+	: options_(options), metrics_(metrics), reporter_(reporter)
+{
+}
+
+bool LoadControl::start()
+{
+	control_.qps = options_.qps;
+	control_.profile = options_.profile_spec;
+	control_.profile_start = options_.profile_start;
+	metrics_.control().store(control_);
+	if (options_.control_socket_path.empty()) {
+		return true;
+	}
+	socket_.reset(new ControlSocket());
+	if (!socket_->listen(options_.control_socket_path)) {
+		std::cout << "failed to listen on " << options_.control_socket_path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void LoadControl::poll()
+{
+	if (dump_signal) {
+		dump_signal = 0;
+		std::cout << "[snapshot]" << std::endl;
+		reporter_.printTotals();
+	}
+	if (reload_signal) {
+		reload_signal = 0;
+		std::string error = reloadRateFile();
+		std::cout << "[control] reload " << options_.rate_file << ": " << (error.empty() ? describe() : error)
+			  << std::endl;
+	}
+	if (socket_) {
+		socket_->poll([this](const std::string &command) { return handle(command); });
+	}
+}
+
+void LoadControl::close()
+{
+	socket_.reset();
+}
+
+std::string LoadControl::handle(const std::string &command)
+{
+	std::stringstream stream(command);
+	std::string verb;
+	std::string argument;
+	stream >> verb >> argument;
+	RateControl::Settings next = control_;
+	if (verb == "stats") {
+		auto totals = metrics_.totals();
+		std::ostringstream reply;
+		reply << describe() << ", sent: " << totals.sent << ", acked: " << totals.acked
+		      << ", failed: " << totals.failed << ", timeouts: " << totals.timeouts
+		      << ", in flight: " << inFlight(totals) << "\n";
+		return reply.str();
+	}
+	if (verb == "qps") {
+		char *end = nullptr;
+		next.qps = std::strtod(argument.c_str(), &end);
+		if (end == argument.c_str() || *end != '\0') {
+			return "error: invalid qps " + argument + "\n";
+		}
+		next.profile.clear();
+	} else if (verb == "profile") {
+		// the same spec again starts it over
+		next.profile = argument;
+		next.profile_start = unixMicros();
+	} else if (verb == "pause" || verb == "resume") {
+		next.paused = verb == "pause";
+	} else {
+		return "error: unknown command " + verb +
+		       ", expected qps <total>, profile <spec>, pause, resume or stats\n";
+	}
+	std::string error = update(next);
+	if (!error.empty()) {
+		return "error: " + error + "\n";
+	}
+	std::cout << "[control] " << command << ": " << describe() << std::endl;
+	return "ok " + describe() + "\n";
+}
+
+std::string LoadControl::reloadRateFile()
+{
+	if (options_.rate_file.empty()) {
+		return "no --rate-file";
+	}
+	std::vector<CLI::ConfigItem> items;
+	try {
+		items = CLI::ConfigTOML().from_file(options_.rate_file);
+	} catch (const CLI::Error &e) {
+		return e.what();
+	}
+	RateControl::Settings next = control_;
+	bool has_qps = false;
+	bool has_profile = false;
+	for (const auto &item : items) {
+		if (item.name == "++" || item.name == "--") {
+			continue;
+		}
+		if (!item.parents.empty() || item.inputs.size() != 1) {
+			return "unexpected " + item.fullname();
+		}
+		const std::string &value = item.inputs.front();
+		if (item.name == "qps") {
+			char *end = nullptr;
+			next.qps = std::strtod(value.c_str(), &end);
+			if (end == value.c_str() || *end != '\0') {
+				return "invalid qps " + value;
+			}
+			has_qps = true;
+		} else if (item.name == "profile") {
+			next.profile = value;
+			has_profile = true;
+		} else if (item.name == "paused") {
+			if (value != "true" && value != "false") {
+				return "paused is not true or false";
+			}
+			next.paused = value == "true";
+		} else {
+			return "unknown key " + item.fullname();
+		}
+	}
+	if (has_qps && !has_profile) {
+		next.profile.clear();
+	}
+	return update(next);
+}
+
+std::string LoadControl::update(RateControl::Settings next)
+{
+	if (options_.role != "sender") {
+		return "only --role sender has a load to change";
+	}
+	bool load = next.qps != control_.qps || next.profile != control_.profile;
+	if (load && (options_.concurrency > 0 || !options_.workload.phases().empty())) {
+		return "--concurrency and --workload set the load themselves, only pause and resume apply";
+	}
+	int most = options_.process_qps * std::max(options_.users, 1);
+	if (next.qps <= 0 || next.qps > most) {
+		return "qps is not in (0, " + std::to_string(most) + "]";
+	}
+	LoadProfile profile;
+	bool too_long = next.profile.size() >= RateControl::kMaxProfile;
+	if (!next.profile.empty() && (too_long || !profile.parse(next.profile))) {
+		return "invalid profile " + next.profile;
+	}
+	if (next.profile != control_.profile) {
+		next.profile_start = unixMicros();
+	}
+
+	reporter_.restartProfile(next.profile, next.profile_start);
+	control_ = next;
+	metrics_.control().store(control_);
+	return std::string();
+}
+
+std::string LoadControl::describe() const
+{
+	std::ostringstream description;
+	if (control_.profile.empty()) {
+		description << "qps: " << control_.qps;
+	} else {
+		description << "profile: " << control_.profile;
+	}
+	if (control_.paused) {
+		description << ", paused";
+	}
+	return description.str();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "control_socket.h"
+#include "options.h"
+#include "shared_metrics.h"
+
+class Reporter;
+
+// --control-socket, --rate-file and the signals that change the load while running. Runs in the process
+// owning the control region, the parent of --users or a single process, the workers follow the region.
+class LoadControl {
+public:
+	// SIGUSR1 prints the totals so far, SIGHUP reloads --rate-file. Caught before forking, so a worker
+	// signalled by mistake does not die of it.
+	static void catchSignals();
+
+	LoadControl(const Options &options, MetricsRegion &metrics, Reporter &reporter);
+
+	// Publishes the load of the command line to the workers and opens --control-socket.
+	bool start();
+	// Handles the signals and the commands of --control-socket that came in since the last call.
+	void poll();
+	// drops the copy of the socket a forked worker inherits
+	void close();
+
+private:
+	std::string handle(const std::string &command);
+	// --rate-file: top-level qps, profile and paused, the keys left out keep their value. A qps without a
+	// profile ends the profile.
+	std::string reloadRateFile();
+	// Checks and applies `next` here and publishes it to the workers, returns why not.
+	std::string update(RateControl::Settings next);
+	std::string describe() const;
+
+	const Options &options_;
+	MetricsRegion &metrics_;
+	Reporter &reporter_;
+	std::unique_ptr<ControlSocket> socket_;
+	// what was applied last
+	RateControl::Settings control_;
+};
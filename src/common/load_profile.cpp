@@ -0,0 +1,104 @@
+#include "load_profile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+bool LoadProfile::parse(const std::string &spec)
+{
+	std::vector<std::string> parts;
+	std::stringstream stream(spec);
+	std::string part;
+	while (std::getline(stream, part, ':')) {
+		parts.push_back(part);
+	}
+	if (parts.empty() || parts.size() > 5) {
+		return false;
+	}
+
+	std::vector<double> values;
+	for (size_t i = 1; i < parts.size(); ++i) {
+		char *end = nullptr;
+		double value = std::strtod(parts[i].c_str(), &end);
+		if (end == parts[i].c_str() || *end != '\0' || value < 0) {
+			return false;
+		}
+		values.push_back(value);
+	}
+	// a rate of 0 would never schedule the next message
+	Kind kind;
+	if (parts[0] == "ramp" && values.size() == 3 && values[0] > 0 && values[1] > 0) {
+		kind = Ramp;
+	} else if (parts[0] == "step" && (values.size() == 3 || values.size() == 4) && values[0] > 0 &&
+		   values[2] > 0 && (values.size() == 3 || values[3] >= values[0])) {
+		kind = Step;
+	} else if (parts[0] == "sine" && values.size() == 3 && values[0] > 0 && values[0] <= values[1] &&
+		   values[2] > 0) {
+		kind = Sine;
+	} else if (parts[0] == "spike" && values.size() == 4 && values[0] > 0 && values[1] > 0) {
+		kind = Spike;
+	} else {
+		return false;
+	}
+	// a profile parsed again keeps nothing of the last one, a step without <max> has none
+	kind_ = kind;
+	std::fill(std::begin(values_), std::end(values_), 0.0);
+	std::copy(values.begin(), values.end(), values_);
+	return true;
+}
+
+double LoadProfile::qps(double seconds) const
+{
+	seconds = std::max(seconds, 0.0);
+	switch (kind_) {
+	case Ramp:
+		if (seconds >= values_[2]) {
+			return values_[1];
+		}
+		return values_[0] + (values_[1] - values_[0]) * seconds / values_[2];
+	case Step: {
+		double qps = values_[0] + values_[1] * std::floor(seconds / values_[2]);
+		return values_[3] > 0 ? std::min(qps, values_[3]) : qps;
+	}
+	case Sine: {
+		const double pi = 3.14159265358979323846;
+		double middle = (values_[0] + values_[1]) / 2;
+		return middle + (values_[1] - middle) * std::sin(2 * pi * seconds / values_[2]);
+	}
+	case Spike:
+		return seconds >= values_[2] && seconds < values_[2] + values_[3] ? values_[1] : values_[0];
+	}
+	return values_[0];
+}
+
+double LoadProfile::mean(double from, double to) const
+{
+	if (to <= from) {
+		return qps(from);
+	}
+	// sampled, the shapes are smooth or constant between the window boundaries
+	const int samples = 100;
+	double sum = 0;
+	for (int i = 0; i < samples; ++i) {
+		sum += qps(from + (to - from) * (i + 0.5) / samples);
+	}
+	return sum / samples;
+}
+
+double LoadProfile::windowEnd(double seconds) const
+{
+	double window = kind_ == Step ? values_[2] : window_;
+	double end = (std::floor(seconds / window) + 1) * window;
+	if (kind_ == Spike) {
+		// the spike gets a window of its own
+		for (double boundary : {values_[2], values_[2] + values_[3]}) {
+			if (seconds < boundary) {
+				end = std::min(end, boundary);
+			}
+		}
+	}
+	return end;
+}
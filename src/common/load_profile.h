@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+// Total qps over the run, for finding where latency starts to climb in a single run instead of one run per
+// --qps. Time is in seconds since the start of the run.
+class LoadProfile {
+public:
+	// "ramp:<from>:<to>:<seconds>" linear from `from` to `to`, then holds `to`;
+	// "step:<from>:<step>:<hold seconds>[:<max>]" from, from + step, ... each held for `hold` seconds;
+	// "sine:<min>:<max>:<period seconds>" starting at the middle and rising;
+	// "spike:<base>:<peak>:<at seconds>:<length seconds>" base with `peak` from `at` for `length` seconds.
+	// An invalid spec leaves the profile as it was.
+	bool parse(const std::string &spec);
+	// Length of the report windows of a ramp, sine or spike; a step is reported per step.
+	void setWindow(double seconds) { window_ = seconds; }
+
+	double qps(double seconds) const;
+	// mean qps over [from, to)
+	double mean(double from, double to) const;
+	// end of the report window that contains `seconds`
+	double windowEnd(double seconds) const;
+
+private:
+	enum Kind { Ramp, Step, Sine, Spike };
+
+	Kind kind_ = Ramp;
+	double values_[4] = {};
+	double window_ = 10;
+};
@@ -0,0 +1,45 @@
+#include "login_storm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "worker.h"
+
+LoginStorm::LoginStorm(Worker &worker) : worker_(worker) {}
+
+void LoginStorm::run()
+{
+	const Options &options = worker_.options();
+	std::mt19937_64 rng(std::hash<std::string>()(worker_.user()));
+	if (!worker_.waitStart()) {
+		return;
+	}
+	while (!worker_.stopped()) {
+		uint64_t now = unixMicros() / 1000;
+		uint64_t due = (now / options.login_period + 1) * options.login_period;
+		if (options.login_jitter > 0) {
+			due += rng() % options.login_jitter;
+		}
+		while (!worker_.stopped() && now < due) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(std::min<uint64_t>(50, due - now)));
+			now = unixMicros() / 1000;
+		}
+		if (worker_.stopped()) {
+			break;
+		}
+
+		worker_.zim()->logout();
+		auto done = std::make_shared<std::promise<void>>();
+		std::future<void> logged_in = done->get_future();
+		worker_.markAction();
+		worker_.login([done](const zim::ZIMError &) { done->set_value(); });
+		while (!worker_.stopped() &&
+		       logged_in.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+		}
+	}
+}
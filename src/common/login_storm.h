@@ -0,0 +1,17 @@
+#pragma once
+
+class Worker;
+
+// --role login: logs out and in again at every multiple of --login-period on the wall clock, so the users
+// of all processes, and of all machines with synchronised clocks, reconnect at the same moment. A login
+// slower than the period skips the periods it overlaps.
+class LoginStorm {
+public:
+	explicit LoginStorm(Worker &worker);
+
+	// until the end of the run
+	void run();
+
+private:
+	Worker &worker_;
+};
@@ -0,0 +1,66 @@
+#include "matrix_sweep.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "delivery_tracker.h"
+#include "send_variant.h"
+
+MatrixSweep::MatrixSweep(const Options &options, MetricsRegion &metrics)
+	: load_start_(options.load_start), seconds_(options.matrix), metrics_(metrics)
+{
+}
+
+size_t MatrixSweep::cell() const
+{
+	uint64_t now = unixMicros();
+	if (now < load_start_) {
+		return 0;
+	}
+	return std::min<size_t>((now - load_start_) / (seconds_ * 1000000ULL), SendVariant::kMatrixCells);
+}
+
+void MatrixSweep::poll(bool last)
+{
+	size_t over = SendVariant::kMatrixCells;
+	if (!last) {
+		uint64_t now = unixMicros();
+		if (now < load_start_ + 1000000) {
+			return;
+		}
+		over = std::min<size_t>((now - load_start_ - 1000000) / (seconds_ * 1000000ULL), over);
+	}
+	for (; reported_ < over; ++reported_) {
+		VariantMetrics &cell = metrics_.variant(reported_);
+		if (last && cell.sent == 0) {
+			continue;
+		}
+		auto service = cell.service.snapshot();
+		auto response = cell.response.snapshot();
+		std::cout << "[matrix][" << SendVariant::matrixCell(reported_).name()
+			  << "] sent/s: " << double(cell.sent) / seconds_
+			  << ", acked/s: " << double(cell.acked) / seconds_ << ", failed: " << cell.failed << std::endl;
+		std::cout << "[latency][matrix][service] " << service.summary() << std::endl;
+		std::cout << "[latency][matrix][response] " << response.summary() << std::endl;
+	}
+}
+
+void MatrixSweep::print()
+{
+	std::cout << "[matrix] cell acked/s failed service_p50 p99 response_p50 p99 p99.9 (ms) p99/first" << std::endl;
+	double first = 0;
+	for (size_t i = 0; i < SendVariant::kMatrixCells; ++i) {
+		VariantMetrics &cell = metrics_.variant(i);
+		auto service = cell.service.snapshot();
+		auto response = cell.response.snapshot();
+		double p99 = response.quantile(0.99) / 1000.0;
+		if (i == 0) {
+			first = p99;
+		}
+		std::cout << "[matrix] " << SendVariant::matrixCell(i).name() << " " << double(cell.acked) / seconds_
+			  << " " << cell.failed << " " << service.quantile(0.5) / 1000.0 << " "
+			  << service.quantile(0.99) / 1000.0 << " " << response.quantile(0.5) / 1000.0 << " " << p99
+			  << " " << response.quantile(0.999) / 1000.0 << " " << (first > 0 ? p99 / first : 0)
+			  << std::endl;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "options.h"
+#include "shared_metrics.h"
+
+// --matrix: a sweep over every SendVariant, one cell of --matrix seconds after the other from the start of
+// the load. The senders ask which cell they are in, the process owning the metrics region reports the cells
+// as they end.
+class MatrixSweep {
+public:
+	MatrixSweep(const Options &options, MetricsRegion &metrics);
+
+	// the cell the load is in now, kMatrixCells once it is over
+	size_t cell() const;
+	// Prints the cells that ended at least a second ago, their callbacks are in by then; at exit the rest of
+	// the cells that sent anything.
+	void poll(bool last);
+	// one line per cell, the response p99 also relative to the first cell, which sends with the defaults
+	void print();
+
+private:
+	const uint64_t load_start_;
+	// seconds per cell
+	const int seconds_;
+	MetricsRegion &metrics_;
+	// cells printed so far
+	size_t reported_ = 0;
+};
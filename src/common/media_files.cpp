@@ -0,0 +1,161 @@
+#include "media_files.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+struct KindFormat {
+	MediaKind kind;
+	const char *name;
+	const char *extension;
+	// magic bytes the file starts with
+	const char *header;
+	size_t header_size;
+	// bytes per second of audio or video, 0 without a duration
+	uint64_t byte_rate;
+};
+
+const KindFormat kFormats[] = {
+	{MediaKind::Image, "image", ".jpg", "\xFF\xD8\xFF\xE0\x00\x10JFIF\x00", 11, 0},
+	{MediaKind::File, "file", ".bin", "", 0, 0},
+	// 128 kbit/s mp3 with an ID3v2 header
+	{MediaKind::Audio, "audio", ".mp3", "ID3\x03\x00\x00\x00\x00\x00\x00", 10, 16000},
+	// 2 Mbit/s mp4, starting with its ftyp box
+	{MediaKind::Video, "video", ".mp4", "\x00\x00\x00\x18" "ftypmp42\x00\x00\x00\x00mp42isom", 24, 250000},
+};
+
+const KindFormat &format(MediaKind kind)
+{
+	return kFormats[static_cast<size_t>(kind)];
+}
+
+bool parseSize(const std::string &spec, uint64_t &size)
+{
+	char *end = nullptr;
+	double value = std::strtod(spec.c_str(), &end);
+	if (end == spec.c_str() || value < 1) {
+		return false;
+	}
+	std::string suffix(end);
+	if (suffix == "K" || suffix == "k") {
+		value *= 1024;
+	} else if (suffix == "M" || suffix == "m") {
+		value *= 1024 * 1024;
+	} else if (suffix == "G" || suffix == "g") {
+		value *= 1024.0 * 1024 * 1024;
+	} else if (!suffix.empty()) {
+		return false;
+	}
+	size = static_cast<uint64_t>(value);
+	return true;
+}
+
+// mkdir -p
+bool makeDirectory(const std::string &dir)
+{
+	for (size_t slash = dir.find('/', 1);; slash = dir.find('/', slash + 1)) {
+		std::string prefix = dir.substr(0, slash);
+		if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+			return false;
+		}
+		if (slash == std::string::npos) {
+			return true;
+		}
+	}
+}
+
+} // namespace
+
+const char *mediaKindName(MediaKind kind)
+{
+	return format(kind).name;
+}
+
+bool MediaFiles::parse(const std::string &spec)
+{
+	std::vector<File> files;
+	std::stringstream stream(spec);
+	std::string entry;
+	while (std::getline(stream, entry, ',')) {
+		size_t colon = entry.find(':');
+		if (colon == std::string::npos) {
+			return false;
+		}
+		std::string name = entry.substr(0, colon);
+		auto found = std::find_if(std::begin(kFormats), std::end(kFormats),
+					  [&name](const KindFormat &format) { return name == format.name; });
+		File file;
+		if (found == std::end(kFormats) || !parseSize(entry.substr(colon + 1), file.size)) {
+			return false;
+		}
+		file.kind = found->kind;
+		file.duration = found->byte_rate > 0 ? std::max<unsigned int>(1, file.size / found->byte_rate) : 0;
+		files.push_back(file);
+	}
+	if (files.empty()) {
+		return false;
+	}
+	files_.swap(files);
+	next_ = 0;
+	return true;
+}
+
+bool MediaFiles::create(const std::string &dir, const std::string &tag)
+{
+	if (!makeDirectory(dir)) {
+		return false;
+	}
+	for (size_t i = 0; i < files_.size(); ++i) {
+		File &file = files_[i];
+		const KindFormat &kind = format(file.kind);
+		file.path = dir + "/" + tag + "_" + std::to_string(i) + kind.extension;
+
+		// the tag keeps the content of every file different, should the server deduplicate uploads
+		std::string head(kind.header, kind.header_size);
+		head += "zimcli " + tag + " " + std::to_string(i) + "\n";
+		int fd = open(file.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			return false;
+		}
+		bool written = write(fd, head.data(), head.size()) == static_cast<ssize_t>(head.size()) &&
+			       ftruncate(fd, std::max<uint64_t>(file.size, head.size())) == 0;
+		close(fd);
+		if (!written) {
+			return false;
+		}
+		file.size = std::max<uint64_t>(file.size, head.size());
+	}
+	return true;
+}
+
+void MediaFiles::remove()
+{
+	for (const auto &file : files_) {
+		if (!file.path.empty()) {
+			unlink(file.path.c_str());
+		}
+	}
+}
+
+const MediaFiles::File &MediaFiles::next()
+{
+	const File &file = files_[next_];
+	next_ = next_ + 1 == files_.size() ? 0 : next_ + 1;
+	return file;
+}
+
+uint64_t MediaFiles::totalSize() const
+{
+	uint64_t total = 0;
+	for (const auto &file : files_) {
+		total += file.size;
+	}
+	return total;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The ZIMMediaMessage subclasses --media sends.
+enum class MediaKind {
+	Image,
+	File,
+	Audio,
+	Video,
+};
+
+const char *mediaKindName(MediaKind kind);
+
+// Synthetic files for sendMediaMessage, created once per worker before sending starts. A file is sparse:
+// a header of the right format and a tag unique to the worker and file, then a hole up to its size, so
+// large files cost neither disk nor time to create. Meant for a tmpfs directory, where reading the hole
+// back for the upload does not touch a disk either.
+class MediaFiles {
+public:
+	struct File {
+		MediaKind kind;
+		std::string path;
+		uint64_t size;
+		// seconds of audio or video at a typical bitrate for the size, 0 for images and files
+		unsigned int duration;
+	};
+
+	// "<kind>:<size>[,<kind>:<size>...]", kind image, file, audio or video, size in bytes with an optional
+	// K, M or G suffix (powers of 1024). An invalid spec leaves the files as they were.
+	bool parse(const std::string &spec);
+
+	// Creates the files in `dir`, named after `tag`. False if the directory or a file cannot be created.
+	bool create(const std::string &dir, const std::string &tag);
+	// deletes what create() made
+	void remove();
+
+	// Not thread safe, meant for the sending thread. The files in the order of the spec, over and over.
+	const File &next();
+
+	size_t count() const { return files_.size(); }
+	uint64_t totalSize() const;
+
+private:
+	std::vector<File> files_;
+	size_t next_ = 0;
+};
@@ -0,0 +1,88 @@
+#include "media_transfer.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "worker.h"
+
+MediaTransfer::MediaTransfer(Worker &worker) : worker_(worker) {}
+
+bool MediaTransfer::createFiles()
+{
+	const Options &options = worker_.options();
+	files_.parse(options.media_spec);
+	if (!files_.create(options.media_dir, options.sender)) {
+		std::cout << "failed to create the media files in " << options.media_dir << std::endl;
+		files_.remove();
+		return false;
+	}
+	if (options.verbose) {
+		std::cout << "media files: " << files_.count() << ", total size: " << files_.totalSize() << std::endl;
+	}
+	return true;
+}
+
+void MediaTransfer::removeFiles()
+{
+	files_.remove();
+}
+
+const MediaFiles::File &MediaTransfer::nextFile()
+{
+	return files_.next();
+}
+
+void MediaTransfer::download(const std::shared_ptr<zim::ZIMMediaMessage> &message)
+{
+	auto started = Worker::Clock::now();
+	++worker_.metrics().operation(Operation::DownloadMedia).issued;
+	++downloads_in_flight_;
+	uint64_t size = message->getFileSize();
+	auto progressed = std::make_shared<Worker::Clock::time_point>(started);
+	worker_.zim()->downloadMediaFile(
+		message, zim::ZIMMediaFileType::ZIM_MEDIA_FILE_TYPE_ORIGINAL_FILE,
+		[this, progressed](const std::shared_ptr<zim::ZIMMediaMessage> &, unsigned long long,
+				   unsigned long long) {
+			auto now = Worker::Clock::now();
+			worker_.metrics().downloadProgressGap().record(now - *progressed);
+			*progressed = now;
+			++worker_.slot().download_progress;
+		},
+		[this, started, size](const std::shared_ptr<zim::ZIMMediaMessage> &, const zim::ZIMError &errorInfo) {
+			if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+				worker_.slot().downloaded_bytes += size;
+				markFinished(worker_.slot().last_download);
+			}
+			worker_.recordOperation(Operation::DownloadMedia, started, errorInfo);
+			--downloads_in_flight_;
+		});
+}
+
+void MediaTransfer::finish()
+{
+	auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(worker_.options().drain_timeout);
+	while (downloads_in_flight_ > 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+bool isMedia(zim::ZIMMessageType type)
+{
+	return type == zim::ZIM_MESSAGE_TYPE_IMAGE || type == zim::ZIM_MESSAGE_TYPE_FILE ||
+	       type == zim::ZIM_MESSAGE_TYPE_AUDIO || type == zim::ZIM_MESSAGE_TYPE_VIDEO;
+}
+
+void markFinished(std::atomic<uint64_t> &last)
+{
+	uint64_t now = unixMicros();
+	uint64_t current = last.load(std::memory_order_relaxed);
+	while (now > current && !last.compare_exchange_weak(current, now, std::memory_order_relaxed)) {
+	}
+}
+
+double transferSeconds(uint64_t load_start, uint64_t last)
+{
+	return last > load_start ? (last - load_start) / 1e6 : 0;
+}
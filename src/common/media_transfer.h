@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ZIM.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "media_files.h"
+
+class Worker;
+
+// --media and --download-media: the synthetic files a sender uploads, and the downloads of the media
+// messages a receiver gets. An upload is a send like any other, see MessageSender. The progress callbacks
+// of both are timed.
+class MediaTransfer {
+public:
+	explicit MediaTransfer(Worker &worker);
+
+	// Creates the files of --media for the user, false if that fails.
+	bool createFiles();
+	void removeFiles();
+	// the file to upload next
+	const MediaFiles::File &nextFile();
+
+	// Downloads the original file of a received media message.
+	void download(const std::shared_ptr<zim::ZIMMediaMessage> &message);
+	// waits up to --drain-timeout for the downloads in flight
+	void finish();
+
+private:
+	Worker &worker_;
+	MediaFiles files_;
+	std::atomic<uint64_t> downloads_in_flight_{0};
+};
+
+bool isMedia(zim::ZIMMessageType type);
+// Moves the time of the last finished upload or download of this worker to now.
+void markFinished(std::atomic<uint64_t> &last);
+// Seconds from the start of the load at `load_start` to `last`, the last finished transfer of all workers.
+double transferSeconds(uint64_t load_start, uint64_t last);
@@ -0,0 +1,63 @@
+#include "message_pool.h"
+
+template <class Message>
+MessagePool<Message>::MessagePool(size_t capacity, const Message &prototype) : prototype_(prototype)
+{
+	messages_.reserve(capacity);
+	free_.reserve(capacity);
+	for (size_t i = 0; i < capacity; ++i) {
+		free_.push_back(create()->slot_);
+	}
+}
+
+template <class Message> std::shared_ptr<PooledMessage<Message>> MessagePool<Message>::acquire()
+{
+	std::shared_ptr<PooledMessage<Message>> message;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (free_.empty()) {
+			return create();
+		}
+		message = messages_[free_.back()];
+		free_.pop_back();
+	}
+	// the previous send's callbacks filled in IDs, sender and timestamps; copying the prototype back
+	// reuses the strings' storage
+	static_cast<Message &>(*message) = prototype_;
+	return message;
+}
+
+template <class Message> void MessagePool<Message>::release(PooledMessage<Message> *message)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	free_.push_back(message->slot_);
+}
+
+template <class Message> void MessagePool<Message>::reclaim(PooledMessage<Message> *message)
+{
+	auto fresh = std::make_shared<PooledMessage<Message>>();
+	static_cast<Message &>(*fresh) = prototype_;
+	std::lock_guard<std::mutex> lock(mutex_);
+	fresh->slot_ = message->slot_;
+	// the last reference to `message` may be this one, it is not touched after
+	messages_[fresh->slot_] = fresh;
+	free_.push_back(fresh->slot_);
+}
+
+template <class Message> size_t MessagePool<Message>::size() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return messages_.size();
+}
+
+template <class Message> std::shared_ptr<PooledMessage<Message>> MessagePool<Message>::create()
+{
+	auto message = std::make_shared<PooledMessage<Message>>();
+	static_cast<Message &>(*message) = prototype_;
+	message->slot_ = messages_.size();
+	messages_.push_back(message);
+	return message;
+}
+
+template class MessagePool<zim::ZIMTextMessage>;
+template class MessagePool<zim::ZIMBarrageMessage>;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ZIM.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+template <class Message> class MessagePool;
+
+// Text or barrage message reused across sends. It carries the timestamps of the send it is currently used
+// for, so the sent callback only captures the message pointer and fits in std::function's inline storage.
+template <class Message> class PooledMessage : public Message {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point intended;
+	Clock::time_point dispatched;
+
+private:
+	friend class MessagePool<Message>;
+
+	size_t slot_ = 0;
+};
+
+typedef PooledMessage<zim::ZIMTextMessage> PooledTextMessage;
+typedef PooledMessage<zim::ZIMBarrageMessage> PooledBarrageMessage;
+
+// Preallocated messages handed out for one send each and put back from the sent callback, or replaced
+// when the callback does not come in time.
+// The pool keeps a shared_ptr to every message, so lending one out copies a shared_ptr instead of
+// allocating an object and its control block per send. When every message is in flight the pool
+// grows by one. Instantiated for ZIMTextMessage and ZIMBarrageMessage.
+template <class Message> class MessagePool {
+public:
+	// every message starts out as a copy of `prototype`
+	MessagePool(size_t capacity, const Message &prototype);
+
+	// A message in the state of a freshly constructed one: no IDs, so the SDK updates it in place.
+	std::shared_ptr<PooledMessage<Message>> acquire();
+	// Only call once the SDK is done with the message, i.e. from its sent callback.
+	void release(PooledMessage<Message> *message);
+	// For a send that timed out: its slot gets a new message and is free again, the SDK keeps the old one
+	// until the callback it may still make. That callback must not release it.
+	void reclaim(PooledMessage<Message> *message);
+
+	size_t size() const;
+	const Message &prototype() const { return prototype_; }
+
+private:
+	std::shared_ptr<PooledMessage<Message>> create();
+
+	const Message prototype_;
+	mutable std::mutex mutex_;
+	std::vector<std::shared_ptr<PooledMessage<Message>>> messages_;
+	std::vector<size_t> free_;
+};
@@ -0,0 +1,473 @@
+#include "message_sender.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include "delivery_tracker.h"
+#include "history_cache.h"
+#include "history_walker.h"
+#include "load_profile.h"
+#include "media_files.h"
+#include "media_transfer.h"
+#include "read_receipts.h"
+#include "worker.h"
+
+MessageSender::MessageSender(Worker &worker)
+	: worker_(worker), metrics_(worker.metrics()), slot_(worker.slot()),
+	  matrix_(worker.options(), worker.metrics())
+{
+	const Options &options = worker_.options();
+	push_config_.title = "zimcli";
+	push_config_.content = "zimcli offline push";
+	for (size_t i = 0; i < SendVariant::kMatrixCells; ++i) {
+		const SendVariant &variant = options.matrix > 0 ? SendVariant::matrixCell(i) : options.send_variant;
+		variant.apply(send_configs_[i], &push_config_);
+	}
+}
+
+MessageSender::~MessageSender()
+{
+	stop();
+	if (rate_thread_.joinable()) {
+		rate_thread_.join();
+	}
+	if (timeout_thread_.joinable()) {
+		timeout_thread_.join();
+	}
+}
+
+bool MessageSender::prepare()
+{
+	const Options &options = worker_.options();
+	// seeded by the sender, so every user sends different bodies and a rerun sends the same ones
+	uint64_t seed = std::hash<std::string>()(options.sender);
+	PayloadContent content = PayloadContent::Words;
+	parsePayloadContent(options.payload_content, content);
+
+	zim::ZIMTextMessage prototype("hello world!");
+	if (!options.payload_size.empty()) {
+		payloads_.reset(new PayloadGenerator());
+		payloads_->parse(options.payload_size);
+		if (!payloads_->generate(options.payload_count, content, seed)) {
+			std::cout << "failed to read payloads from " << options.payload_size << std::endl;
+			return false;
+		}
+		if (options.verbose) {
+			std::cout << "payloads: " << payloads_->count() << ", mean size: " << payloads_->meanSize()
+				  << std::endl;
+		}
+	}
+	if (options.extended_data_size > 0) {
+		std::mt19937_64 rng(seed + 1);
+		extended_data_ = PayloadGenerator::text(options.extended_data_size, content, rng);
+		prototype.extendedData = extended_data_;
+	}
+	for (int i = 0; i < options.mentions; ++i) {
+		prototype.mentionedUserIDs.push_back(i == 0 ? options.receiver
+							    : options.user_prefix + std::to_string(i - 1));
+	}
+
+	if (!options.media_spec.empty()) {
+		media_ = true;
+		return worker_.media()->createFiles();
+	}
+
+	// enough messages for the window, or for one second of sends in open-loop mode
+	size_t capacity = options.concurrency > 0 ? options.concurrency : std::max<size_t>(64, options.rate);
+	if (options.message_type == "barrage") {
+		// a room has nobody to mention
+		zim::ZIMBarrageMessage barrage(prototype.message);
+		barrage.extendedData = prototype.extendedData;
+		barrage_pool_.reset(new MessagePool<zim::ZIMBarrageMessage>(capacity, barrage));
+	} else {
+		message_pool_.reset(new MessagePool<zim::ZIMTextMessage>(capacity, prototype));
+	}
+	return true;
+}
+
+void MessageSender::start()
+{
+	const Options &options = worker_.options();
+	PacingMode pacing_mode = PacingMode::CatchUp;
+	parsePacingMode(options.pacing, pacing_mode);
+	double rate = options.rate;
+	if (!options.profile_spec.empty()) {
+		double seconds = (unixMicros() - options.profile_start) / 1e6;
+		rate = std::min<double>(options.process_qps, options.profile.qps(seconds) / options.sending_users);
+	}
+	scheduler_.reset(new RateScheduler(rate, pacing_mode));
+	rate_thread_ = std::thread(&MessageSender::rateLoop, this);
+	if (options.concurrency > 0) {
+		window_.reset(new InflightWindow(options.concurrency));
+	}
+	if (options.callback_timeout > 0) {
+		CompletionTracker::Clock::duration timeout = std::chrono::milliseconds(options.callback_timeout);
+		// timeouts are noticed up to a tick late, a tenth of the timeout but at most 1s
+		CompletionTracker::Clock::duration tick = std::chrono::seconds(1);
+		completions_.reset(new CompletionTracker(timeout, std::min(tick, timeout / 10)));
+		timeout_thread_ = std::thread(&MessageSender::timeoutLoop, this);
+	}
+}
+
+bool MessageSender::begin()
+{
+	if (!worker_.waitStart()) {
+		return false;
+	}
+	started_ = Clock::now();
+	epoch_ = unixMicros() / 1000;
+	return true;
+}
+
+void MessageSender::loop(const std::vector<std::string> &targets, zim::ZIMConversationType type)
+{
+	if (!begin()) {
+		return;
+	}
+	const Options &options = worker_.options();
+	std::vector<uint64_t> sequences(targets.size(), 0);
+	size_t next = 0;
+	// the intended send times of the slots taken at once, --batch of them in open-loop mode
+	std::vector<Clock::time_point> due;
+	while (!worker_.stopped()) {
+		if (window_) {
+			// closed loop: the next send is due as soon as a slot of the window frees up
+			if (!scheduler_->waitResumed() || !window_->acquire()) {
+				break;
+			}
+			due.assign(1, Clock::now());
+		} else if (!scheduler_->acquire(options.batch, due)) {
+			break;
+		}
+		if (options.matrix > 0 && matrix_.cell() >= SendVariant::kMatrixCells) {
+			break;
+		}
+
+		for (auto intended : due) {
+			size_t target = next;
+			next = (next + 1) % targets.size();
+			send(targets[target], type, ++sequences[target], intended);
+		}
+	}
+}
+
+void MessageSender::send(const std::string &target, zim::ZIMConversationType type, uint64_t sequence,
+			 Clock::time_point intended)
+{
+	worker_.markAction();
+	if (media_) {
+		sendMedia(target, type, sequence, intended);
+	} else if (barrage_pool_) {
+		sendPooled(*barrage_pool_, target, type, sequence, intended);
+	} else {
+		sendPooled(*message_pool_, target, type, sequence, intended);
+	}
+}
+
+template <class Message>
+void MessageSender::sendPooled(MessagePool<Message> &pool, const std::string &target, zim::ZIMConversationType type,
+			       uint64_t sequence, Clock::time_point intended)
+{
+	bool sweeping = worker_.options().matrix > 0;
+	size_t cell = sweeping ? std::min(matrix_.cell(), SendVariant::kMatrixCells - 1) : 0;
+	VariantMetrics *variant = sweeping ? &metrics_.variant(cell) : nullptr;
+	auto message = pool.acquire();
+	MessageStamp stamp;
+	stamp.epoch = epoch_;
+	stamp.sequence = sequence;
+	++slot_.sent;
+	if (variant) {
+		++variant->sent;
+	}
+	stamp.sent_micros = unixMicros();
+	char header[MessageStamp::kMaxLength];
+	size_t length = stamp.write(header);
+	message->message.assign(header, length);
+	if (payloads_) {
+		// the stamp takes the place of the end of the body, so the body keeps the sampled size
+		const std::string &body = payloads_->next();
+		message->message.append(body, 0, body.size() > length ? body.size() - length : 0);
+	} else {
+		message->message.append(pool.prototype().message);
+	}
+	message->intended = intended;
+	message->dispatched = Clock::now();
+
+	PooledMessage<Message> *pooled = message.get();
+	MessagePool<Message> *owner = &pool;
+	uint64_t token = completions_ ? completions_->start(message->dispatched, pooled) : 0;
+	const zim::ZIMMessageSendConfig &sendConfig = send_configs_[cell];
+	ReadReceipts *receipts = worker_.receipts();
+	bool receipt = receipts && receipts->timing() && sendConfig.hasReceipt;
+	worker_.zim()->sendMessage(
+		std::static_pointer_cast<zim::ZIMMessage>(message), target, type, sendConfig, nullptr,
+		[this, owner, pooled, token, variant, receipt](const std::shared_ptr<zim::ZIMMessage> &message,
+							       const zim::ZIMError &errorInfo) {
+			auto now = Clock::now();
+			auto dispatched = pooled->dispatched;
+			auto intended = pooled->intended;
+			if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS && receipt) {
+				// the receipts name the message by the ID it got from the server
+				worker_.receipts()->sent(message->getMessageID(), dispatched);
+			}
+			if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS && worker_.history()) {
+				worker_.history()->cache().add(*message);
+			}
+			// a timed out send's message was replaced in the pool, see expire()
+			bool late = completions_ && !completions_->complete(token);
+			if (!late) {
+				owner->release(pooled);
+			}
+			completed(now, dispatched, intended, late, variant, errorInfo, "sendMessage");
+		});
+}
+
+// The stamp goes into extendedData, a media message has no body, and the gaps between the progress callbacks
+// of the upload are recorded.
+void MessageSender::sendMedia(const std::string &target, zim::ZIMConversationType type, uint64_t sequence,
+			      Clock::time_point intended)
+{
+	bool sweeping = worker_.options().matrix > 0;
+	size_t cell = sweeping ? std::min(matrix_.cell(), SendVariant::kMatrixCells - 1) : 0;
+	VariantMetrics *variant = sweeping ? &metrics_.variant(cell) : nullptr;
+	const MediaFiles::File &file = worker_.media()->nextFile();
+	std::shared_ptr<zim::ZIMMediaMessage> message;
+	switch (file.kind) {
+	case MediaKind::Image:
+		message = std::make_shared<zim::ZIMImageMessage>(file.path);
+		break;
+	case MediaKind::File:
+		message = std::make_shared<zim::ZIMFileMessage>(file.path);
+		break;
+	case MediaKind::Audio:
+		message = std::make_shared<zim::ZIMAudioMessage>(file.path, file.duration);
+		break;
+	case MediaKind::Video:
+		message = std::make_shared<zim::ZIMVideoMessage>(file.path, file.duration);
+		break;
+	}
+	MessageStamp stamp;
+	stamp.epoch = epoch_;
+	stamp.sequence = sequence;
+	++slot_.sent;
+	if (variant) {
+		++variant->sent;
+	}
+	stamp.sent_micros = unixMicros();
+	char header[MessageStamp::kMaxLength];
+	size_t length = stamp.write(header);
+	// like the body of a text message, the stamp counts towards --extended-data-size
+	size_t padding = extended_data_.size() > length ? extended_data_.size() - length : 0;
+	message->extendedData.assign(header, length).append(extended_data_, 0, padding);
+	auto dispatched = Clock::now();
+
+	// the progress callbacks of one upload come one after the other
+	auto progressed = std::make_shared<Clock::time_point>(dispatched);
+	auto notification = std::make_shared<zim::ZIMMediaMessageSendNotification>(
+		nullptr, [this, progressed](const std::shared_ptr<zim::ZIMMediaMessage> &, unsigned long long,
+					    unsigned long long) {
+			auto now = Clock::now();
+			metrics_.uploadProgressGap().record(now - *progressed);
+			*progressed = now;
+			++slot_.upload_progress;
+		});
+	uint64_t token = completions_ ? completions_->start(dispatched) : 0;
+	const zim::ZIMMessageSendConfig &sendConfig = send_configs_[cell];
+	ReadReceipts *receipts = worker_.receipts();
+	bool receipt = receipts && receipts->timing() && sendConfig.hasReceipt;
+	uint64_t size = file.size;
+	auto sent = [this, dispatched, intended, token, variant, receipt, size](
+			    const std::shared_ptr<zim::ZIMMessage> &message, const zim::ZIMError &errorInfo) {
+		auto now = Clock::now();
+		if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+			slot_.uploaded_bytes += size;
+			markFinished(slot_.last_upload);
+			if (receipt) {
+				worker_.receipts()->sent(message->getMessageID(), dispatched);
+			}
+		}
+		bool late = completions_ && !completions_->complete(token);
+		completed(now, dispatched, intended, late, variant, errorInfo, "sendMediaMessage");
+	};
+	worker_.zim()->sendMediaMessage(message, target, type, sendConfig, notification, sent);
+}
+
+void MessageSender::completed(Clock::time_point now, Clock::time_point dispatched, Clock::time_point intended,
+			      bool late, VariantMetrics *variant, const zim::ZIMError &errorInfo, const char *api)
+{
+	metrics_.serviceLatency().record(now - dispatched);
+	metrics_.responseLatency().record(now - intended);
+	if (variant) {
+		variant->service.record(now - dispatched);
+		variant->response.record(now - intended);
+	}
+	bool succeeded = errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS;
+	if (succeeded) {
+		++slot_.acked;
+	} else {
+		++slot_.failed;
+		metrics_.errors().record(static_cast<int>(errorInfo.code));
+	}
+	if (variant) {
+		++(succeeded ? variant->acked : variant->failed);
+	}
+	// a timed out send already gave its slot back
+	if (late) {
+		++slot_.late_callbacks;
+	} else if (window_) {
+		window_->release();
+	}
+	if (worker_.options().debug != 0) {
+		std::cout << "[callback][" << api << "] code:" << errorInfo.code << ",message:" << errorInfo.message
+			  << std::endl;
+	}
+}
+
+// Follows the control region: moves the rate of this worker along the profile or to the qps, and pauses it.
+// A --workload sets the rate of its phases itself and a --concurrency window has none, both only pause.
+void MessageSender::rateLoop()
+{
+	const Options &options = worker_.options();
+	RateControl &control = metrics_.control();
+	RateControl::Settings settings;
+	uint64_t version = control.load(settings);
+	LoadProfile profile;
+	profile.parse(settings.profile);
+	bool paced = options.workload.phases().empty() && !window_;
+	bool paused = false;
+	double current = scheduler_->rate();
+	while (!worker_.stopped()) {
+		if (control.version() != version) {
+			version = control.load(settings);
+			profile.parse(settings.profile);
+		}
+		if (settings.paused != paused) {
+			paused = settings.paused;
+			if (paused) {
+				scheduler_->pause();
+			} else {
+				scheduler_->resume();
+			}
+		}
+		if (paced) {
+			double next = settings.qps / options.sending_users;
+			if (!settings.profile.empty()) {
+				double seconds = (unixMicros() - settings.profile_start) / 1e6;
+				double share = profile.qps(seconds) / options.sending_users;
+				next = std::min<double>(options.process_qps, share);
+			}
+			if (std::abs(next - current) > current * 0.001) {
+				scheduler_->setRate(next);
+				current = next;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+}
+
+// Expires the sends whose callback is overdue. The SDK may still call back, its own state for the send
+// is out of our reach.
+void MessageSender::timeoutLoop()
+{
+	while (!worker_.stopped()) {
+		expire();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+}
+
+void MessageSender::expire()
+{
+	std::vector<void *> messages;
+	size_t expired = completions_->expire(CompletionTracker::Clock::now(), &messages);
+	slot_.timeouts += expired;
+	// the SDK may still call back with them, their pool slots get new ones
+	for (void *message : messages) {
+		if (barrage_pool_) {
+			barrage_pool_->reclaim(static_cast<PooledBarrageMessage *>(message));
+		} else if (message_pool_) {
+			message_pool_->reclaim(static_cast<PooledTextMessage *>(message));
+		}
+	}
+	for (size_t i = 0; window_ && i < expired; ++i) {
+		window_->release();
+	}
+	if (expired > 0 && worker_.options().debug != 0) {
+		std::cout << "[timeout][sendMessage] expired: " << expired
+			  << ", outstanding: " << completions_->outstanding() << std::endl;
+	}
+}
+
+void MessageSender::stop()
+{
+	if (scheduler_) {
+		scheduler_->stop();
+	}
+	if (window_) {
+		window_->stop();
+	}
+}
+
+void MessageSender::finish()
+{
+	if (rate_thread_.joinable()) {
+		rate_thread_.join();
+	}
+	if (timeout_thread_.joinable()) {
+		timeout_thread_.join();
+	}
+	const Options &options = worker_.options();
+	auto started = std::chrono::steady_clock::now();
+	uint64_t missing = drain();
+	if (options.verbose || missing > 0) {
+		std::cout << "[drain] " << options.sender << " missing callbacks: " << missing << " after "
+			  << std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() << "s"
+			  << std::endl;
+	}
+	if (media_) {
+		worker_.media()->removeFiles();
+	}
+}
+
+uint64_t MessageSender::drain()
+{
+	auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(worker_.options().drain_timeout);
+	while (true) {
+		uint64_t outstanding;
+		if (completions_) {
+			expire();
+			outstanding = completions_->outstanding();
+		} else {
+			outstanding = inFlight(slot_);
+		}
+		if (outstanding == 0 || std::chrono::steady_clock::now() >= deadline) {
+			return outstanding;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void MessageSender::printSummary(Clock::time_point stopped) const
+{
+	if (window_) {
+		double seconds = std::chrono::duration<double>(stopped - started_).count();
+		std::cout << "sent: " << slot_.sent
+			  << ", achieved qps: " << (seconds > 0 ? slot_.acked / seconds : 0) << std::endl;
+	} else if (scheduler_) {
+		double seconds = std::chrono::duration<double>(scheduler_->elapsed()).count();
+		const Workload &workload = worker_.options().workload;
+		if (!workload.phases().empty()) {
+			// nothing is issued after the last phase, the rest of --execution-time only waits for callbacks
+			seconds = std::min(seconds, std::chrono::duration<double>(workload.duration()).count());
+		}
+		// the slots of a --workload are also spent on queries, the messages are counted on their own
+		std::cout << "sent: " << slot_.sent << ", slots: " << scheduler_->issued()
+			  << ", skipped: " << scheduler_->skipped()
+			  << ", max lag(ms): "
+			  << std::chrono::duration<double, std::milli>(scheduler_->maxLag()).count()
+			  << ", achieved qps: " << (seconds > 0 ? scheduler_->issued() / seconds : 0) << std::endl;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ZIM.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "completion_tracker.h"
+#include "inflight_window.h"
+#include "matrix_sweep.h"
+#include "message_pool.h"
+#include "payload_generator.h"
+#include "rate_scheduler.h"
+#include "send_variant.h"
+#include "shared_metrics.h"
+
+class Worker;
+
+// The sending half of a worker that every scenario of a sender goes through: the schedule of --qps and
+// --profile, which follows the control region, the --concurrency window, the --callback-timeout of the
+// sends, and the stamped text, barrage or media messages. loop() is the scenario of --conversation peer,
+// room and group.
+class MessageSender {
+public:
+	typedef RateScheduler::Clock Clock;
+
+	explicit MessageSender(Worker &worker);
+	~MessageSender();
+
+	// The bodies, extendedData and mentions of the user, or the files of --media. False if they cannot be
+	// had, the worker has nothing to send then.
+	bool prepare();
+	// starts the schedule and the --callback-timeout tracking
+	void start();
+	// Waits for --start-at and starts the epoch of the stamps, false if the run was stopped meanwhile.
+	bool begin();
+	// Sends to `targets` in turn until the end, open loop at the rate of the schedule or closed loop as
+	// the window frees up.
+	void loop(const std::vector<std::string> &targets, zim::ZIMConversationType type);
+	// Sends the next body with the `sequence`-th stamp to `target`, `intended` is when the schedule wanted
+	// it sent.
+	void send(const std::string &target, zim::ZIMConversationType type, uint64_t sequence,
+		  Clock::time_point intended);
+	// makes loop() and the other scenarios waiting for a slot return
+	void stop();
+	// Waits up to --drain-timeout for the callbacks of the sends in flight, so the last seconds of the run
+	// are in the numbers, and deletes the files of --media.
+	void finish();
+	// sends and rate of the run, which ended at `stopped`
+	void printSummary(Clock::time_point stopped) const;
+
+	RateScheduler &scheduler() { return *scheduler_; }
+	// when begin() was done
+	Clock::time_point started() const { return started_; }
+
+private:
+	template <class Message>
+	void sendPooled(MessagePool<Message> &pool, const std::string &target, zim::ZIMConversationType type,
+			uint64_t sequence, Clock::time_point intended);
+	// Uploads the next file of --media with sendMediaMessage.
+	void sendMedia(const std::string &target, zim::ZIMConversationType type, uint64_t sequence,
+		       Clock::time_point intended);
+	// The bookkeeping of every sent callback, `now` is when it came, `late` after --callback-timeout.
+	void completed(Clock::time_point now, Clock::time_point dispatched, Clock::time_point intended, bool late,
+		       VariantMetrics *variant, const zim::ZIMError &errorInfo, const char *api);
+	void rateLoop();
+	void timeoutLoop();
+	void expire();
+	// Returns how many callbacks are still missing at --drain-timeout. Sends that time out meanwhile are
+	// not waited for.
+	uint64_t drain();
+
+	Worker &worker_;
+	MetricsRegion &metrics_;
+	WorkerMetrics &slot_;
+	MatrixSweep matrix_;
+	std::unique_ptr<RateScheduler> scheduler_;
+	// follows the qps, profile and pause of the control region
+	std::thread rate_thread_;
+	std::unique_ptr<InflightWindow> window_;
+	// sends whose callback is still due, checked every tick by timeoutLoop
+	std::unique_ptr<CompletionTracker> completions_;
+	std::thread timeout_thread_;
+	// text messages, or barrages into the room with --message-type barrage
+	std::unique_ptr<MessagePool<zim::ZIMTextMessage>> message_pool_;
+	std::unique_ptr<MessagePool<zim::ZIMBarrageMessage>> barrage_pool_;
+	// --media files instead of either
+	bool media_ = false;
+	std::unique_ptr<PayloadGenerator> payloads_;
+	// extendedData of every message, generated once
+	std::string extended_data_;
+	// ZIMMessageSendConfig of every message, or of every cell of --matrix
+	zim::ZIMPushConfig push_config_;
+	zim::ZIMMessageSendConfig send_configs_[SendVariant::kMatrixCells];
+	// start of the sending run in unix ms, stamped into every message so receivers can tell reruns apart
+	uint64_t epoch_ = 0;
+	Clock::time_point started_;
+};
@@ -0,0 +1,497 @@
+#include "metrics_emitter.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+struct LatencyKind {
+	const char *name;
+	LatencyHistogram &(MetricsRegion::*histogram)();
+};
+
+// the send latencies first, then the delivery latency of the receiving side, the login latency, the
+// read receipt latency and the gaps between the progress callbacks of media uploads and downloads
+const LatencyKind kLatencyKinds[] = {
+	{"service", &MetricsRegion::serviceLatency},
+	{"response", &MetricsRegion::responseLatency},
+	{"delivery", &MetricsRegion::deliveryLatency},
+	{"login", &MetricsRegion::loginLatency},
+	{"receipt", &MetricsRegion::receiptLatency},
+	{"upload_progress", &MetricsRegion::uploadProgressGap},
+	{"download_progress", &MetricsRegion::downloadProgressGap},
+};
+const size_t kSendLatencyKinds = 2;
+const size_t kDelivery = 2;
+const size_t kLogin = 3;
+const size_t kReceipt = 4;
+const size_t kUploadProgress = 5;
+const size_t kDownloadProgress = 6;
+
+double rate(uint64_t now, uint64_t before, double seconds)
+{
+	return seconds > 0 ? double(now - before) / seconds : 0;
+}
+
+uint64_t unixMillis()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		       std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+} // namespace
+
+bool parseMetricsFormat(const std::string &name, MetricsFormat &format)
+{
+	if (name == "json") {
+		format = MetricsFormat::JsonLines;
+	} else if (name == "prometheus") {
+		format = MetricsFormat::Prometheus;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+MetricsEmitter::MetricsEmitter(MetricsRegion *region, std::chrono::milliseconds interval)
+	: region_(region), interval_(interval), start_(Clock::now()), last_emit_(start_)
+{
+}
+
+MetricsEmitter::~MetricsEmitter()
+{
+	if (listen_fd_ >= 0) {
+		close(listen_fd_);
+	}
+}
+
+bool MetricsEmitter::openFile(const std::string &path, MetricsFormat format)
+{
+	path_ = path;
+	format_ = format;
+	if (format_ == MetricsFormat::JsonLines) {
+		json_.open(path_, std::ios::out | std::ios::app);
+		return json_.good();
+	}
+	std::ofstream probe(path_ + ".tmp");
+	return probe.good();
+}
+
+bool MetricsEmitter::listen(int port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return false;
+	}
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<uint16_t>(port));
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, 16) != 0) {
+		close(fd);
+		return false;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	listen_fd_ = fd;
+	return true;
+}
+
+void MetricsEmitter::poll()
+{
+	auto now = Clock::now();
+	if (now - last_emit_ >= interval_) {
+		emit(now);
+	}
+	serve();
+}
+
+void MetricsEmitter::flush() { emit(Clock::now()); }
+
+void MetricsEmitter::emit(Clock::time_point now)
+{
+	Sample sample;
+	sample.totals = region_->totals();
+	sample.errors = region_->errors().snapshot();
+	sample.login_errors = region_->loginErrors().snapshot();
+	for (size_t state = 0; state < ConnectionChanges::kStates; ++state) {
+		for (size_t event = 0; event < ConnectionChanges::kEvents; ++event) {
+			sample.connection_changes[state][event] = region_->connectionChanges().count(state, event);
+		}
+	}
+	for (size_t i = 0; i < kLatencyKindCount; ++i) {
+		sample.latency[i] = (region_->*kLatencyKinds[i].histogram)().snapshot();
+	}
+	for (size_t i = 0; i < kOperationCount; ++i) {
+		OperationMetrics &operation = region_->operation(static_cast<Operation>(i));
+		sample.operations[i].issued = operation.issued.load(std::memory_order_relaxed);
+		sample.operations[i].succeeded = operation.succeeded.load(std::memory_order_relaxed);
+		sample.operations[i].failed = operation.failed.load(std::memory_order_relaxed);
+		sample.operations[i].latency = operation.latency.snapshot();
+	}
+	sample.operation_errors = region_->operationErrors().snapshot();
+	double seconds = std::chrono::duration<double>(now - last_emit_).count();
+
+	if (json_.is_open()) {
+		json_ << renderJson(sample, seconds) << std::endl;
+	}
+	if (listen_fd_ >= 0 || (!path_.empty() && format_ == MetricsFormat::Prometheus)) {
+		exposition_ = renderPrometheus(sample, seconds);
+	}
+	if (!path_.empty() && format_ == MetricsFormat::Prometheus) {
+		std::string temporary = path_ + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+			file << exposition_;
+		}
+		std::rename(temporary.c_str(), path_.c_str());
+	}
+
+	last_emit_ = now;
+	last_ = std::move(sample);
+}
+
+// Counters are totals since the start, rates and latencies cover the time since the previous line.
+std::string MetricsEmitter::renderJson(const Sample &sample, double seconds)
+{
+	const MetricsTotals &totals = sample.totals;
+	const MetricsTotals &last = last_.totals;
+
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "{\"timestamp_ms\":" << unixMillis()
+	    << ",\"elapsed_s\":" << std::chrono::duration<double>(Clock::now() - start_).count()
+	    << ",\"interval_s\":" << seconds << ",\"sent\":" << totals.sent << ",\"acked\":" << totals.acked
+	    << ",\"failed\":" << totals.failed << ",\"failed_by_code\":{";
+	for (size_t i = 0; i < sample.errors.size(); ++i) {
+		out << (i == 0 ? "" : ",") << "\"" << sample.errors[i].first << "\":" << sample.errors[i].second;
+	}
+	out << "},\"in_flight\":" << inFlight(totals) << ",\"timeouts\":" << totals.timeouts
+	    << ",\"late_callbacks\":" << totals.late_callbacks
+	    << ",\"sent_qps\":" << rate(totals.sent, last.sent, seconds)
+	    << ",\"acked_qps\":" << rate(totals.acked, last.acked, seconds)
+	    << ",\"failed_qps\":" << rate(totals.failed, last.failed, seconds);
+
+	out << ",\"received\":" << totals.received << ",\"duplicates\":" << totals.duplicates
+	    << ",\"reordered\":" << totals.reordered << ",\"missing\":" << totals.missing
+	    << ",\"received_qps\":" << rate(totals.received, last.received, seconds);
+
+	out << ",\"receipts\":{\"read\":" << totals.receipts_read << ",\"received\":" << totals.receipts
+	    << ",\"unmatched\":" << totals.receipts_unmatched << "}";
+
+	out << ",\"media\":{\"uploaded_bytes\":" << totals.uploaded_bytes
+	    << ",\"upload_bytes_per_s\":" << rate(totals.uploaded_bytes, last.uploaded_bytes, seconds)
+	    << ",\"upload_progress\":" << totals.upload_progress << ",\"downloaded_bytes\":" << totals.downloaded_bytes
+	    << ",\"download_bytes_per_s\":" << rate(totals.downloaded_bytes, last.downloaded_bytes, seconds)
+	    << ",\"download_progress\":" << totals.download_progress << "}";
+
+	out << ",\"history\":{\"messages\":" << totals.history_messages
+	    << ",\"messages_per_s\":" << rate(totals.history_messages, last.history_messages, seconds)
+	    << ",\"walks\":" << totals.history_walks << "}";
+
+	out << ",\"users\":{\"starting\":" << totals.starting << ",\"logged_in\":" << totals.logged_in
+	    << ",\"login_failed\":" << totals.login_failed << ",\"finished\":" << totals.finished << "}";
+
+	out << ",\"groups\":{\"ready\":" << totals.groups_ready << ",\"failed\":" << totals.groups_failed << "}";
+
+	out << ",\"logins\":" << totals.logins << ",\"logins_failed\":" << totals.logins_failed
+	    << ",\"login_failed_by_code\":{";
+	for (size_t i = 0; i < sample.login_errors.size(); ++i) {
+		out << (i == 0 ? "" : ",") << "\"" << sample.login_errors[i].first
+		    << "\":" << sample.login_errors[i].second;
+	}
+	out << "},\"login_qps\":" << rate(totals.logins, last.logins, seconds) << ",\"connection_changes\":{";
+	bool first = true;
+	for (size_t state = 0; state < ConnectionChanges::kStates; ++state) {
+		for (size_t event = 0; event < ConnectionChanges::kEvents; ++event) {
+			if (sample.connection_changes[state][event] > 0) {
+				out << (first ? "" : ",") << "\"" << ConnectionChanges::stateName(state) << "/"
+				    << ConnectionChanges::eventName(event)
+				    << "\":" << sample.connection_changes[state][event];
+				first = false;
+			}
+		}
+	}
+	out << "}";
+
+	out << ",\"operations\":{";
+	for (size_t i = 0; i < kOperationCount; ++i) {
+		const OperationSample &operation = sample.operations[i];
+		HistogramSnapshot interval = operation.latency.since(last_.operations[i].latency);
+		out << (i == 0 ? "" : ",") << "\"" << operationName(static_cast<Operation>(i))
+		    << "\":{\"issued\":" << operation.issued << ",\"succeeded\":" << operation.succeeded
+		    << ",\"failed\":" << operation.failed
+		    << ",\"qps\":" << rate(operation.issued, last_.operations[i].issued, seconds)
+		    << ",\"latency_ms\":{\"count\":" << interval.count()
+		    << ",\"p50\":" << interval.quantile(0.5) / 1000.0 << ",\"p99\":" << interval.quantile(0.99) / 1000.0
+		    << ",\"max\":" << interval.max() / 1000.0 << "}}";
+	}
+	out << "},\"operation_failed_by_code\":{";
+	for (size_t i = 0; i < sample.operation_errors.size(); ++i) {
+		out << (i == 0 ? "" : ",") << "\"" << sample.operation_errors[i].first
+		    << "\":" << sample.operation_errors[i].second;
+	}
+	out << "}";
+
+	out << ",\"latency_ms\":{";
+	for (size_t i = 0; i < kLatencyKindCount; ++i) {
+		HistogramSnapshot interval = sample.latency[i].since(last_.latency[i]);
+		out << (i == 0 ? "" : ",") << "\"" << kLatencyKinds[i].name << "\":{\"count\":" << interval.count()
+		    << ",\"p50\":" << interval.quantile(0.5) / 1000.0 << ",\"p90\":" << interval.quantile(0.9) / 1000.0
+		    << ",\"p99\":" << interval.quantile(0.99) / 1000.0 << ",\"p999\":" << interval.quantile(0.999) / 1000.0
+		    << ",\"max\":" << interval.max() / 1000.0 << "}";
+	}
+	out << "}}";
+	return out.str();
+}
+
+// Counters and latency summaries are cumulative as Prometheus expects, the qps gauges cover the last
+// interval.
+std::string MetricsEmitter::renderPrometheus(const Sample &sample, double seconds)
+{
+	const MetricsTotals &totals = sample.totals;
+	const MetricsTotals &last = last_.totals;
+
+	std::ostringstream out;
+	out << "# HELP zimcli_messages_sent_total Messages handed to sendMessage.\n"
+	    << "# TYPE zimcli_messages_sent_total counter\n"
+	    << "zimcli_messages_sent_total " << totals.sent << "\n"
+	    << "# HELP zimcli_messages_acked_total Messages whose sent callback reported success.\n"
+	    << "# TYPE zimcli_messages_acked_total counter\n"
+	    << "zimcli_messages_acked_total " << totals.acked << "\n"
+	    << "# HELP zimcli_messages_failed_total Messages whose sent callback reported an error, by ZIMErrorCode.\n"
+	    << "# TYPE zimcli_messages_failed_total counter\n";
+	for (const auto &error : sample.errors) {
+		out << "zimcli_messages_failed_total{code=\"" << error.first << "\"} " << error.second << "\n";
+	}
+	out << "# HELP zimcli_messages_in_flight Messages sent and neither called back nor timed out.\n"
+	    << "# TYPE zimcli_messages_in_flight gauge\n"
+	    << "zimcli_messages_in_flight " << inFlight(totals) << "\n"
+	    << "# HELP zimcli_messages_timeouts_total Messages without a sent callback within --callback-timeout.\n"
+	    << "# TYPE zimcli_messages_timeouts_total counter\n"
+	    << "zimcli_messages_timeouts_total " << totals.timeouts << "\n"
+	    << "# HELP zimcli_late_callbacks_total Sent callbacks that came after --callback-timeout.\n"
+	    << "# TYPE zimcli_late_callbacks_total counter\n"
+	    << "zimcli_late_callbacks_total " << totals.late_callbacks << "\n";
+
+	out << std::fixed << std::setprecision(3) << "# HELP zimcli_qps Achieved rate over the last interval.\n"
+	    << "# TYPE zimcli_qps gauge\n"
+	    << "zimcli_qps{kind=\"sent\"} " << rate(totals.sent, last.sent, seconds) << "\n"
+	    << "zimcli_qps{kind=\"acked\"} " << rate(totals.acked, last.acked, seconds) << "\n"
+	    << "zimcli_qps{kind=\"failed\"} " << rate(totals.failed, last.failed, seconds) << "\n"
+	    << "zimcli_qps{kind=\"received\"} " << rate(totals.received, last.received, seconds) << "\n"
+	    << "zimcli_qps{kind=\"login\"} " << rate(totals.logins, last.logins, seconds) << "\n";
+
+	out << "# HELP zimcli_messages_received_total Messages raised by the receive events of --role receiver.\n"
+	    << "# TYPE zimcli_messages_received_total counter\n"
+	    << "zimcli_messages_received_total " << totals.received << "\n"
+	    << "# HELP zimcli_messages_duplicated_total Received messages whose sequence had arrived before.\n"
+	    << "# TYPE zimcli_messages_duplicated_total counter\n"
+	    << "zimcli_messages_duplicated_total " << totals.duplicates << "\n"
+	    << "# HELP zimcli_messages_reordered_total Received messages that arrived after a later sequence.\n"
+	    << "# TYPE zimcli_messages_reordered_total counter\n"
+	    << "zimcli_messages_reordered_total " << totals.reordered << "\n"
+	    << "# HELP zimcli_messages_missing Sequences skipped by the received messages and not arrived since.\n"
+	    << "# TYPE zimcli_messages_missing gauge\n"
+	    << "zimcli_messages_missing " << totals.missing << "\n";
+
+	out << "# HELP zimcli_users Simulated users by state.\n"
+	    << "# TYPE zimcli_users gauge\n"
+	    << "zimcli_users{state=\"starting\"} " << totals.starting << "\n"
+	    << "zimcli_users{state=\"logged_in\"} " << totals.logged_in << "\n"
+	    << "zimcli_users{state=\"login_failed\"} " << totals.login_failed << "\n"
+	    << "zimcli_users{state=\"finished\"} " << totals.finished << "\n";
+
+	out << "# HELP zimcli_groups Groups of --conversation group by provisioning state.\n"
+	    << "# TYPE zimcli_groups gauge\n"
+	    << "zimcli_groups{state=\"ready\"} " << totals.groups_ready << "\n"
+	    << "zimcli_groups{state=\"failed\"} " << totals.groups_failed << "\n";
+
+	out << "# HELP zimcli_logins_total login calls, including the relogins of --role login.\n"
+	    << "# TYPE zimcli_logins_total counter\n"
+	    << "zimcli_logins_total " << totals.logins << "\n"
+	    << "# HELP zimcli_logins_failed_total Logins whose callback reported an error, by ZIMErrorCode.\n"
+	    << "# TYPE zimcli_logins_failed_total counter\n";
+	for (const auto &error : sample.login_errors) {
+		out << "zimcli_logins_failed_total{code=\"" << error.first << "\"} " << error.second << "\n";
+	}
+	out << "# HELP zimcli_connection_changes_total onConnectionStateChanged calls by state entered and event.\n"
+	    << "# TYPE zimcli_connection_changes_total counter\n";
+	for (size_t state = 0; state < ConnectionChanges::kStates; ++state) {
+		for (size_t event = 0; event < ConnectionChanges::kEvents; ++event) {
+			if (sample.connection_changes[state][event] > 0) {
+				out << "zimcli_connection_changes_total{state=\"" << ConnectionChanges::stateName(state)
+				    << "\",event=\"" << ConnectionChanges::eventName(event) << "\"} "
+				    << sample.connection_changes[state][event] << "\n";
+			}
+		}
+	}
+
+	out << std::setprecision(6)
+	    << "# HELP zimcli_send_latency_seconds sendMessage latency, service: dispatch to callback, response: "
+	       "scheduled send time to callback.\n"
+	    << "# TYPE zimcli_send_latency_seconds summary\n";
+	for (size_t i = 0; i < kSendLatencyKinds; ++i) {
+		const HistogramSnapshot &latency = sample.latency[i];
+		const char *kind = kLatencyKinds[i].name;
+		for (double q : kQuantiles) {
+			out << "zimcli_send_latency_seconds{kind=\"" << kind << "\",quantile=\"" << std::defaultfloat << q
+			    << std::fixed << "\"} " << latency.quantile(q) / 1e6 << "\n";
+		}
+		out << "zimcli_send_latency_seconds_sum{kind=\"" << kind << "\"} " << latency.sum() / 1e6 << "\n"
+		    << "zimcli_send_latency_seconds_count{kind=\"" << kind << "\"} " << latency.count() << "\n";
+	}
+
+	const HistogramSnapshot &delivery = sample.latency[kDelivery];
+	out << "# HELP zimcli_delivery_latency_seconds Send time stamped into the message to its receive event.\n"
+	    << "# TYPE zimcli_delivery_latency_seconds summary\n";
+	for (double q : kQuantiles) {
+		out << "zimcli_delivery_latency_seconds{quantile=\"" << std::defaultfloat << q << std::fixed << "\"} "
+		    << delivery.quantile(q) / 1e6 << "\n";
+	}
+	out << "zimcli_delivery_latency_seconds_sum " << delivery.sum() / 1e6 << "\n"
+	    << "zimcli_delivery_latency_seconds_count " << delivery.count() << "\n";
+
+	out << "# HELP zimcli_operations_total API calls of --workload other than sendMessage, of --read-receipts, "
+	       "--download-media and --history-walkers, by result.\n"
+	    << "# TYPE zimcli_operations_total counter\n";
+	for (size_t i = 0; i < kOperationCount; ++i) {
+		const char *name = operationName(static_cast<Operation>(i));
+		out << "zimcli_operations_total{operation=\"" << name << "\",result=\"succeeded\"} "
+		    << sample.operations[i].succeeded << "\n"
+		    << "zimcli_operations_total{operation=\"" << name << "\",result=\"failed\"} "
+		    << sample.operations[i].failed << "\n";
+	}
+	out << "# HELP zimcli_operation_latency_seconds API call to its callback.\n"
+	    << "# TYPE zimcli_operation_latency_seconds summary\n";
+	for (size_t i = 0; i < kOperationCount; ++i) {
+		const HistogramSnapshot &latency = sample.operations[i].latency;
+		const char *name = operationName(static_cast<Operation>(i));
+		for (double q : kQuantiles) {
+			out << "zimcli_operation_latency_seconds{operation=\"" << name << "\",quantile=\""
+			    << std::defaultfloat << q << std::fixed << "\"} " << latency.quantile(q) / 1e6 << "\n";
+		}
+		out << "zimcli_operation_latency_seconds_sum{operation=\"" << name << "\"} " << latency.sum() / 1e6
+		    << "\n"
+		    << "zimcli_operation_latency_seconds_count{operation=\"" << name << "\"} " << latency.count()
+		    << "\n";
+	}
+
+	const HistogramSnapshot &login = sample.latency[kLogin];
+	out << "# HELP zimcli_login_latency_seconds login to the logged in callback.\n"
+	    << "# TYPE zimcli_login_latency_seconds summary\n";
+	for (double q : kQuantiles) {
+		out << "zimcli_login_latency_seconds{quantile=\"" << std::defaultfloat << q << std::fixed << "\"} "
+		    << login.quantile(q) / 1e6 << "\n";
+	}
+	out << "zimcli_login_latency_seconds_sum " << login.sum() / 1e6 << "\n"
+	    << "zimcli_login_latency_seconds_count " << login.count() << "\n";
+
+	out << "# HELP zimcli_receipts_total Messages marked read by receivers, and receipts the senders got for "
+	       "their messages or for unknown ones.\n"
+	    << "# TYPE zimcli_receipts_total counter\n"
+	    << "zimcli_receipts_total{kind=\"read\"} " << totals.receipts_read << "\n"
+	    << "zimcli_receipts_total{kind=\"received\"} " << totals.receipts << "\n"
+	    << "zimcli_receipts_total{kind=\"unmatched\"} " << totals.receipts_unmatched << "\n";
+	const HistogramSnapshot &receipt = sample.latency[kReceipt];
+	out << "# HELP zimcli_receipt_latency_seconds Dispatch of a message with hasReceipt to a read receipt.\n"
+	    << "# TYPE zimcli_receipt_latency_seconds summary\n";
+	for (double q : kQuantiles) {
+		out << "zimcli_receipt_latency_seconds{quantile=\"" << std::defaultfloat << q << std::fixed << "\"} "
+		    << receipt.quantile(q) / 1e6 << "\n";
+	}
+	out << "zimcli_receipt_latency_seconds_sum " << receipt.sum() / 1e6 << "\n"
+	    << "zimcli_receipt_latency_seconds_count " << receipt.count() << "\n";
+
+	out << "# HELP zimcli_media_bytes_total File bytes of the acked media messages and of the finished downloads.\n"
+	    << "# TYPE zimcli_media_bytes_total counter\n"
+	    << "zimcli_media_bytes_total{direction=\"upload\"} " << totals.uploaded_bytes << "\n"
+	    << "zimcli_media_bytes_total{direction=\"download\"} " << totals.downloaded_bytes << "\n";
+	out << "# HELP zimcli_media_progress_total Uploading and downloading progress callbacks.\n"
+	    << "# TYPE zimcli_media_progress_total counter\n"
+	    << "zimcli_media_progress_total{direction=\"upload\"} " << totals.upload_progress << "\n"
+	    << "zimcli_media_progress_total{direction=\"download\"} " << totals.download_progress << "\n";
+	out << "# HELP zimcli_media_progress_gap_seconds The start of a transfer or a progress callback to the next "
+	       "one.\n"
+	    << "# TYPE zimcli_media_progress_gap_seconds summary\n";
+	const size_t progress_kinds[] = {kUploadProgress, kDownloadProgress};
+	for (size_t i : progress_kinds) {
+		const HistogramSnapshot &gap = sample.latency[i];
+		const char *direction = i == kUploadProgress ? "upload" : "download";
+		for (double q : kQuantiles) {
+			out << "zimcli_media_progress_gap_seconds{direction=\"" << direction << "\",quantile=\""
+			    << std::defaultfloat << q << std::fixed << "\"} " << gap.quantile(q) / 1e6 << "\n";
+		}
+		out << "zimcli_media_progress_gap_seconds_sum{direction=\"" << direction << "\"} " << gap.sum() / 1e6
+		    << "\n"
+		    << "zimcli_media_progress_gap_seconds_count{direction=\"" << direction << "\"} " << gap.count()
+		    << "\n";
+	}
+
+	out << "# HELP zimcli_history_messages_total Messages on the queryHistoryMessage pages of --history-walkers.\n"
+	    << "# TYPE zimcli_history_messages_total counter\n"
+	    << "zimcli_history_messages_total " << totals.history_messages << "\n";
+	out << "# HELP zimcli_history_walks_total Walks of --history-walkers that reached the end of the "
+	       "conversation.\n"
+	    << "# TYPE zimcli_history_walks_total counter\n"
+	    << "zimcli_history_walks_total " << totals.history_walks << "\n";
+	return out.str();
+}
+
+void MetricsEmitter::serve()
+{
+	if (listen_fd_ < 0) {
+		return;
+	}
+	for (;;) {
+		int client = accept(listen_fd_, nullptr, nullptr);
+		if (client < 0) {
+			return;
+		}
+		// a scraper sends its request right away, don't let a silent client stall the caller's loop
+		timeval timeout{0, 100 * 1000};
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		std::string request;
+		char buffer[1024];
+		while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+			ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+			if (received <= 0) {
+				break;
+			}
+			request.append(buffer, received);
+		}
+
+		bool found = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0;
+		const std::string &body = found ? exposition_ : std::string("not found\n");
+		std::ostringstream response;
+		response << "HTTP/1.1 " << (found ? "200 OK" : "404 Not Found") << "\r\n"
+			 << "Content-Type: text/plain; version=0.0.4\r\n"
+			 << "Content-Length: " << body.size() << "\r\n"
+			 << "Connection: close\r\n\r\n"
+			 << body;
+		std::string data = response.str();
+		size_t offset = 0;
+		while (offset < data.size()) {
+			ssize_t written = send(client, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+			if (written <= 0) {
+				break;
+			}
+			offset += written;
+		}
+		close(client);
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.h"
+#include "shared_metrics.h"
+
+enum class MetricsFormat {
+	// one JSON object per interval, appended to the file
+	JsonLines,
+	// Prometheus text exposition format, the file is replaced on every interval
+	Prometheus,
+};
+
+bool parseMetricsFormat(const std::string &name, MetricsFormat &format);
+
+// Periodically renders a MetricsRegion for dashboards: to a file, to a local HTTP endpoint, or both.
+// Nothing runs on its own, poll() does all the work without blocking so the fan-out parent can call
+// it from its supervision loop and stay single threaded.
+class MetricsEmitter {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	MetricsEmitter(MetricsRegion *region, std::chrono::milliseconds interval);
+	~MetricsEmitter();
+
+	// Prometheus files are written next to `path` and renamed over it, so a node_exporter textfile
+	// collector never reads a partial file.
+	bool openFile(const std::string &path, MetricsFormat format);
+	// Serves GET /metrics in the Prometheus text format on 127.0.0.1:port.
+	bool listen(int port);
+
+	// Emits when the interval has elapsed and answers pending HTTP requests.
+	void poll();
+	// Emits the current state regardless of the interval, for the end of the run.
+	void flush();
+
+private:
+	MetricsEmitter(const MetricsEmitter &) = delete;
+	MetricsEmitter &operator=(const MetricsEmitter &) = delete;
+
+	// service, response, delivery, login, receipt, upload_progress and download_progress
+	static const size_t kLatencyKindCount = 7;
+
+	static const size_t kOperationCount = static_cast<size_t>(Operation::Count);
+
+	struct OperationSample {
+		uint64_t issued = 0;
+		uint64_t succeeded = 0;
+		uint64_t failed = 0;
+		HistogramSnapshot latency;
+	};
+
+	// the state of the region at one point in time, latency[] is indexed like kLatencyKinds
+	struct Sample {
+		MetricsTotals totals;
+		std::vector<std::pair<int, uint64_t>> errors;
+		std::vector<std::pair<int, uint64_t>> login_errors;
+		uint64_t connection_changes[ConnectionChanges::kStates][ConnectionChanges::kEvents];
+		HistogramSnapshot latency[kLatencyKindCount];
+		OperationSample operations[kOperationCount];
+		std::vector<std::pair<int, uint64_t>> operation_errors;
+	};
+
+	void emit(Clock::time_point now);
+	std::string renderJson(const Sample &sample, double seconds);
+	std::string renderPrometheus(const Sample &sample, double seconds);
+	void serve();
+
+	MetricsRegion *const region_;
+	const Clock::duration interval_;
+	const Clock::time_point start_;
+
+	std::string path_;
+	MetricsFormat format_ = MetricsFormat::JsonLines;
+	std::ofstream json_;
+	int listen_fd_ = -1;
+	// the latest Prometheus text, served until the next interval replaces it
+	std::string exposition_;
+
+	Clock::time_point last_emit_;
+	Sample last_;
+};
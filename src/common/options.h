@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "load_profile.h"
+#include "send_variant.h"
+#include "workload.h"
+
+// The command line, checked and completed by main(). Every worker of --users runs on a copy with its own
+// user and share of the load.
+struct Options {
+	// of the app, filled in at the top of main.cpp
+	int appid = 0;
+	std::string appsign;
+
+	std::string sender;
+	std::string receiver;
+	// sender: send to the receiver, receiver: log in as the receiver and check what arrives, login: log out
+	// and in again every --login-period
+	std::string role = "sender";
+	int login_period = 10000;
+	int login_jitter = 0;
+	// peer: send to the receiver, room: every user enters the room and the senders send to it, group: the
+	// senders create groups and send to them
+	std::string conversation = "peer";
+	std::string room_id = "zimcli_room";
+	int senders = 0;
+	int groups = 1;
+	int group_size = 10;
+	std::string group_prefix = "zimcli_group_";
+	int provision_concurrency = 16;
+	int qps = 1;
+	std::string pacing = "catchup";
+	// slots of the schedule sent per wake-up of the open loop
+	int batch = 1;
+	// --profile: the total qps follows this shape over the run instead of --qps
+	std::string profile_spec;
+	int profile_window = 10;
+	int concurrency = 0;
+	// ms after which a send without callback counts as a timeout, 0 does not track the callbacks
+	int callback_timeout = 30000;
+	// text messages, or barrages into the room with --message-type barrage
+	std::string message_type = "text";
+	// empty keeps the classic "hello world!" body
+	std::string payload_size;
+	std::string payload_content = "words";
+	int payload_count = 1024;
+	int extended_data_size = 0;
+	int mentions = 0;
+	// ZIMMessageSendConfig of every message, --matrix sweeps all variants one after the other instead
+	std::string priority = "low";
+	int receipt = 0;
+	int push = 0;
+	int matrix = 0;
+	// --read-receipts: receivers mark the messages sent with a receipt read in batches, senders time the
+	// receipts that come back
+	int read_receipts = 0;
+	int receipt_delay = 1000;
+	// --media: senders upload synthetic files with sendMediaMessage, receivers with --download-media download
+	// what they receive
+	std::string media_spec;
+	std::string media_dir = "/dev/shm/zimcli_media";
+	int download_media = 0;
+	// --history-walkers: senders seed their conversation with --history-seed messages, then keep walking it
+	// with queryHistoryMessage
+	int history_walkers = 0;
+	int history_seed = 0;
+	int page_size = 20;
+	int history_reverse = 1;
+	int report_interval = 10;
+	std::string metrics_out;
+	std::string metrics_format = "json";
+	int metrics_port = 0;
+	int metrics_interval = 1000;
+	int users = 0;
+	std::string user_prefix = "zimcli_user_";
+	std::string receiver_prefix;
+	int user_start = 0;
+	int spawn_rate = 100;
+	int execution_time = 300; //default is 300s
+	// --start-at: unix seconds every host of a distributed run starts sending at, 0 right after login
+	int64_t start_at = 0;
+	// --histogram-out writes what --merge adds up over the hosts
+	std::string histogram_out;
+	std::vector<std::string> merge_files;
+	int drain_timeout = 5000;
+	// --control-socket and --rate-file change the load while running
+	std::string control_socket_path;
+	std::string rate_file;
+	int debug = 0;
+	std::string logpath = "/root/ZIMLogs";
+	int logsize = 0;
+
+	// phases of --workload, empty for a single kind of message at --qps
+	Workload workload;
+	LoadProfile profile;
+	// start of the profile in unix us, taken before forking so all workers follow the same timeline
+	uint64_t profile_start = 0;
+	// highest qps of one process
+	int process_qps = 5000;
+	// unix us the load starts at, --start-at or the start of this run
+	uint64_t load_start = 0;
+	SendVariant send_variant;
+
+	// what this process does, from --role, --conversation and --senders, and again for every worker
+	bool sending = true;
+	bool receiving = false;
+	bool timing_receipts = false;
+	// worker of --users, -1 for a single process
+	int index = -1;
+	// qps of this process, qps / users in fan-out mode
+	double rate = 1;
+	// users sharing the qps of a --workload phase
+	int sending_users = 1;
+	bool verbose = true;
+};
@@ -0,0 +1,161 @@
+#include "payload_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+bool parsePayloadContent(const std::string &name, PayloadContent &content)
+{
+	if (name == "words") {
+		content = PayloadContent::Words;
+	} else if (name == "random") {
+		content = PayloadContent::Random;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool PayloadGenerator::parse(const std::string &spec)
+{
+	const std::string file_prefix = "file:";
+	if (spec.compare(0, file_prefix.size(), file_prefix) == 0) {
+		if (spec.size() == file_prefix.size()) {
+			return false;
+		}
+		path_ = spec.substr(file_prefix.size());
+		kind_ = File;
+		return true;
+	}
+
+	std::vector<std::string> parts;
+	std::stringstream stream(spec);
+	std::string part;
+	while (std::getline(stream, part, ':')) {
+		parts.push_back(part);
+	}
+	if (parts.empty()) {
+		return false;
+	}
+
+	std::vector<double> values;
+	for (size_t i = 1; i < parts.size(); ++i) {
+		char *end = nullptr;
+		double value = std::strtod(parts[i].c_str(), &end);
+		if (end == parts[i].c_str() || *end != '\0' || value < 0) {
+			return false;
+		}
+		values.push_back(value);
+	}
+
+	if (parts[0] == "fixed" && values.size() == 1 && values[0] >= 1) {
+		kind_ = Fixed;
+		a_ = values[0];
+	} else if (parts[0] == "uniform" && values.size() == 2 && values[0] >= 1 && values[0] <= values[1]) {
+		kind_ = Uniform;
+		a_ = values[0];
+		b_ = values[1];
+	} else if (parts[0] == "lognormal" && values.size() == 2 && values[0] >= 1) {
+		kind_ = LogNormal;
+		a_ = values[0];
+		b_ = values[1];
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool PayloadGenerator::generate(size_t count, PayloadContent content, uint64_t seed)
+{
+	payloads_.clear();
+	next_ = 0;
+
+	if (kind_ == File) {
+		std::ifstream file(path_);
+		if (!file) {
+			return false;
+		}
+		std::string line;
+		while (std::getline(file, line)) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (!line.empty()) {
+				payloads_.push_back(line.substr(0, kMaxPayloadSize));
+			}
+		}
+		return !payloads_.empty();
+	}
+
+	std::mt19937_64 rng(seed);
+	payloads_.reserve(std::max<size_t>(count, 1));
+	for (size_t i = 0; i < std::max<size_t>(count, 1); ++i) {
+		payloads_.push_back(text(sampleSize(rng), content, rng));
+	}
+	return true;
+}
+
+const std::string &PayloadGenerator::next()
+{
+	const std::string &payload = payloads_[next_];
+	next_ = next_ + 1 == payloads_.size() ? 0 : next_ + 1;
+	return payload;
+}
+
+double PayloadGenerator::meanSize() const
+{
+	if (payloads_.empty()) {
+		return 0;
+	}
+	double total = 0;
+	for (const auto &payload : payloads_) {
+		total += payload.size();
+	}
+	return total / payloads_.size();
+}
+
+std::string PayloadGenerator::text(size_t size, PayloadContent content, std::mt19937_64 &rng)
+{
+	static const char *const kWords[] = {
+		"the",     "be",    "to",    "of",      "and",    "a",       "in",     "that",   "have",  "it",
+		"for",     "not",   "on",    "with",    "he",     "as",      "you",    "do",     "at",    "this",
+		"but",     "his",   "by",    "from",    "they",   "we",      "say",    "her",    "she",   "or",
+		"an",      "will",  "my",    "one",     "all",    "would",   "there",  "their",  "what",  "so",
+		"up",      "out",   "if",    "about",   "who",    "get",     "which",  "go",     "me",    "when",
+		"make",    "can",   "like",  "time",    "no",     "just",    "him",    "know",   "take",  "people",
+		"message", "room",  "group", "tonight", "thanks", "meeting", "hello",  "ok",     "sure",  "later",
+	};
+	static const char kAlphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+	std::string result;
+	result.reserve(size + 16);
+	if (content == PayloadContent::Random) {
+		std::uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+		while (result.size() < size) {
+			result.push_back(kAlphabet[pick(rng)]);
+		}
+	} else {
+		std::uniform_int_distribution<size_t> pick(0, sizeof(kWords) / sizeof(kWords[0]) - 1);
+		while (result.size() < size) {
+			if (!result.empty()) {
+				result.push_back(' ');
+			}
+			result += kWords[pick(rng)];
+		}
+		result.resize(size);
+	}
+	return result;
+}
+
+size_t PayloadGenerator::sampleSize(std::mt19937_64 &rng) const
+{
+	double size = a_;
+	if (kind_ == Uniform) {
+		size = std::uniform_real_distribution<double>(a_, b_)(rng);
+	} else if (kind_ == LogNormal) {
+		size = std::lognormal_distribution<double>(std::log(a_), b_)(rng);
+	}
+	return static_cast<size_t>(std::min<double>(std::max(std::round(size), 1.0), kMaxPayloadSize));
+}
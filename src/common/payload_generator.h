@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// What the generated payload bytes look like.
+enum class PayloadContent {
+	// words from a small English corpus separated by spaces, compresses like chat text
+	Words,
+	// uniformly random alphanumerics, close to incompressible
+	Random,
+};
+
+bool parsePayloadContent(const std::string &name, PayloadContent &content);
+
+// Message bodies for the load. Payloads are generated once per worker before sending starts and
+// next() cycles through them, so the send loop only copies a prepared buffer.
+class PayloadGenerator {
+public:
+	// larger sizes are clamped, the server rejects text messages over its own limit anyway
+	static const size_t kMaxPayloadSize = 1 << 20;
+
+	// "fixed:<bytes>", "uniform:<min bytes>:<max bytes>", "lognormal:<median bytes>:<sigma>" or
+	// "file:<path>" to replay the non-empty lines of a file.
+	bool parse(const std::string &spec);
+
+	// Prepares `count` payloads (every line of the file when replaying one). Returns false if the
+	// file cannot be read or has no payload in it.
+	bool generate(size_t count, PayloadContent content, uint64_t seed);
+
+	// Not thread safe, meant for the sending thread.
+	const std::string &next();
+
+	size_t count() const { return payloads_.size(); }
+	double meanSize() const;
+
+	// `size` bytes of `content`
+	static std::string text(size_t size, PayloadContent content, std::mt19937_64 &rng);
+
+private:
+	enum Kind { Fixed, Uniform, LogNormal, File };
+
+	size_t sampleSize(std::mt19937_64 &rng) const;
+
+	Kind kind_ = Fixed;
+	double a_ = 12;
+	double b_ = 0;
+	std::string path_;
+	std::vector<std::string> payloads_;
+	size_t next_ = 0;
+};
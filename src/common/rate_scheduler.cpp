@@ -0,0 +1,181 @@
+#include "rate_scheduler.h"
+
+#include <algorithm>
+
+bool parsePacingMode(const std::string &name, PacingMode &mode)
+{
+	if (name == "catchup") {
+		mode = PacingMode::CatchUp;
+	} else if (name == "skip") {
+		mode = PacingMode::Skip;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+RateScheduler::RateScheduler(double rate, PacingMode mode)
+	: rate_(rate),
+	  mode_(mode),
+	  interval_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate)))
+{
+}
+
+void RateScheduler::start()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!started_) {
+		started_ = true;
+		start_ = Clock::now();
+		anchor_ = start_;
+	}
+}
+
+void RateScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!stopped_) {
+			stopped_ = true;
+			stopped_at_ = Clock::now();
+		}
+	}
+	cv_.notify_all();
+}
+
+void RateScheduler::setRate(double rate)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+		if (started_) {
+			// a higher rate pulls a distant next slot in to one new interval after the last one, a late
+			// slot stays late so catchup still makes up for it
+			auto now = Clock::now();
+			auto earliest = slot_ > 0 ? deadline(slot_ - 1) + interval : now + interval;
+			anchor_ = std::min(deadline(slot_), std::max(now, earliest));
+			slot_ = 0;
+		}
+		rate_ = rate;
+		interval_ = interval;
+	}
+	// a waiter may be sleeping towards a deadline of the old rate
+	cv_.notify_all();
+}
+
+void RateScheduler::pause()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	paused_ = true;
+}
+
+void RateScheduler::resume()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!paused_) {
+			return;
+		}
+		paused_ = false;
+		if (started_) {
+			anchor_ = Clock::now();
+			slot_ = 0;
+		}
+	}
+	cv_.notify_all();
+}
+
+bool RateScheduler::waitResumed()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	cv_.wait(lock, [this]() { return stopped_ || !paused_; });
+	return !stopped_;
+}
+
+double RateScheduler::rate() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return rate_;
+}
+
+RateScheduler::Clock::duration RateScheduler::elapsed() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!started_) {
+		return Clock::duration::zero();
+	}
+	return (stopped_ ? stopped_at_ : Clock::now()) - start_;
+}
+
+RateScheduler::Clock::time_point RateScheduler::deadline(uint64_t slot) const
+{
+	// computed from the slot index rather than accumulated, so rounding of the interval never drifts
+	return anchor_ + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(slot / rate_));
+}
+
+bool RateScheduler::acquire(Clock::time_point &intended)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (!wait(lock, 1)) {
+		return false;
+	}
+	intended = deadline(slot_);
+	++slot_;
+	issued_.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool RateScheduler::acquire(size_t count, std::vector<Clock::time_point> &intended)
+{
+	count = std::max<size_t>(count, 1);
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (!wait(lock, count)) {
+		return false;
+	}
+	intended.clear();
+	for (size_t i = 0; i < count; ++i) {
+		intended.push_back(deadline(slot_ + i));
+	}
+	slot_ += count;
+	issued_.fetch_add(count, std::memory_order_relaxed);
+	return true;
+}
+
+bool RateScheduler::wait(std::unique_lock<std::mutex> &lock, size_t count)
+{
+	if (!started_) {
+		started_ = true;
+		start_ = Clock::now();
+		anchor_ = start_;
+	}
+
+	while (!stopped_) {
+		if (paused_) {
+			cv_.wait(lock);
+			continue;
+		}
+		// the last slot of the batch
+		auto due = deadline(slot_ + count - 1);
+		auto now = Clock::now();
+		if (now < due) {
+			cv_.wait_until(lock, due);
+			continue;
+		}
+
+		if (mode_ == PacingMode::Skip && now - due >= interval_) {
+			// jump to the last batch that is already due, everything before it is dropped
+			auto behind = static_cast<uint64_t>(std::chrono::duration<double>(now - anchor_).count() * rate_);
+			uint64_t first = behind + 1 - count;
+			skipped_.fetch_add(first - slot_, std::memory_order_relaxed);
+			slot_ = first;
+			due = deadline(slot_ + count - 1);
+		}
+
+		auto lag = (now - due).count();
+		if (lag > max_lag_.load(std::memory_order_relaxed)) {
+			max_lag_.store(lag, std::memory_order_relaxed);
+		}
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// How the scheduler reacts when the caller falls behind the timeline.
+enum class PacingMode {
+	// Fire every late slot back to back until the timeline is caught up. Combined with measuring latency
+	// from the intended send time this keeps the numbers free of coordinated omission.
+	CatchUp,
+	// Drop slots that are more than one interval late and count them as skipped.
+	Skip,
+};
+
+bool parsePacingMode(const std::string &name, PacingMode &mode);
+
+// Open-loop rate scheduler driven by absolute deadlines on a steady_clock timeline.
+// Slot n is due at start + n / rate, so time spent by the caller between two slots does not push the
+// following slots back and the achieved rate converges to the target.
+class RateScheduler {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	RateScheduler(double rate, PacingMode mode);
+
+	// Anchors the timeline at now. Called implicitly by the first acquire().
+	void start();
+	// Wakes up all waiters; every following acquire() returns false.
+	void stop();
+	// Continues the timeline at `rate`: the next slot is due one new interval after the last one but not
+	// before now, or when it would have been under the old rate if that is earlier, and the following ones
+	// are spaced by the new interval.
+	void setRate(double rate);
+	// acquire() blocks while paused. Resuming restarts the timeline at now, the paused time is not
+	// caught up.
+	void pause();
+	void resume();
+	// Blocks while paused, for callers pacing themselves; false once stopped.
+	bool waitResumed();
+
+	// Blocks until the next slot is due and stores its scheduled time in `intended`.
+	// Returns false once the scheduler has been stopped.
+	bool acquire(Clock::time_point &intended);
+	// Blocks until the next `count` slots are all due and stores their scheduled times in `intended`, one
+	// wake-up for the lot. The first ones are handed out late by up to count - 1 intervals.
+	bool acquire(size_t count, std::vector<Clock::time_point> &intended);
+
+	double rate() const;
+	uint64_t issued() const { return issued_.load(std::memory_order_relaxed); }
+	uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+	// Largest distance between a slot's deadline and the moment it was handed out.
+	Clock::duration maxLag() const { return Clock::duration(max_lag_.load(std::memory_order_relaxed)); }
+	// Since the first slot, up to stop().
+	Clock::duration elapsed() const;
+
+private:
+	Clock::time_point deadline(uint64_t slot) const;
+	// waits until slots [slot_, slot_ + count) are due, false once stopped
+	bool wait(std::unique_lock<std::mutex> &lock, size_t count);
+
+	double rate_;
+	const PacingMode mode_;
+	Clock::duration interval_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+	bool started_ = false;
+	bool stopped_ = false;
+	bool paused_ = false;
+	// deadlines are counted from anchor_, which setRate() moves; elapsed() is counted from start_
+	Clock::time_point start_;
+	Clock::time_point stopped_at_;
+	Clock::time_point anchor_;
+	uint64_t slot_ = 0;
+
+	std::atomic<uint64_t> issued_{0};
+	std::atomic<uint64_t> skipped_{0};
+	std::atomic<Clock::rep> max_lag_{0};
+};
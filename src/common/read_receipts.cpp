@@ -0,0 +1,130 @@
+#include "read_receipts.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "worker.h"
+
+ReadReceipts::ReadReceipts(Worker &worker) : worker_(worker)
+{
+	const Options &options = worker_.options();
+	if (options.receiving && options.read_receipts > 0) {
+		std::chrono::milliseconds delay(options.receipt_delay);
+		batcher_.reset(new ReceiptBatcher(options.read_receipts, delay));
+	}
+	if (options.sending && options.timing_receipts) {
+		// a reader's --receipt-delay plus a round trip, a minute is plenty for any batching
+		tracker_.reset(new ReceiptTracker(std::chrono::seconds(60)));
+	}
+}
+
+ReadReceipts::~ReadReceipts()
+{
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+void ReadReceipts::start()
+{
+	if (batcher_) {
+		thread_ = std::thread(&ReadReceipts::loop, this);
+	}
+}
+
+void ReadReceipts::finish()
+{
+	if (!thread_.joinable()) {
+		return;
+	}
+	// sends what is left in the batches, their callbacks are waited for like those of the sends
+	thread_.join();
+	auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(worker_.options().drain_timeout);
+	while (in_flight_ > 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void ReadReceipts::markRead(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+			    const std::string &conversationID, zim::ZIMConversationType type)
+{
+	if (!batcher_) {
+		return;
+	}
+	auto now = ReceiptBatcher::Clock::now();
+	for (const auto &message : messageList) {
+		// only messages sent with hasReceipt wait for one
+		auto status = message->getReceiptStatus();
+		if (status != zim::ZIMMessageReceiptStatus::ZIM_MESSAGE_RECEIPT_STATUS_PROCESSING) {
+			continue;
+		}
+		ReceiptBatcher::Batch full;
+		if (batcher_->add(conversationID, type, message, now, full)) {
+			send(full);
+		}
+	}
+}
+
+void ReadReceipts::sent(long long message_id, ReceiptTracker::Clock::time_point dispatched)
+{
+	tracker_->sent(message_id, dispatched);
+}
+
+void ReadReceipts::changed(const std::vector<zim::ZIMMessageReceiptInfo> &infos)
+{
+	if (!tracker_) {
+		return;
+	}
+	auto now = ReceiptTracker::Clock::now();
+	for (const auto &info : infos) {
+		if (info.isSelfOperated) {
+			// read on another device of the sender, not a receipt of a reader
+			continue;
+		}
+		ReceiptTracker::Clock::time_point dispatched;
+		if (tracker_->find(info.messageID, now, dispatched)) {
+			worker_.metrics().receiptLatency().record(now - dispatched);
+			++worker_.slot().receipts;
+		} else {
+			++worker_.slot().receipts_unmatched;
+		}
+		if (worker_.options().debug != 0) {
+			std::cout << "[event][onMessageReceiptChanged] conversation:" << info.conversationID
+				  << ",messageID:" << info.messageID << ",status:" << info.status
+				  << ",read:" << info.readMemberCount << std::endl;
+		}
+	}
+}
+
+void ReadReceipts::loop()
+{
+	while (!worker_.stopped()) {
+		for (const auto &batch : batcher_->due(ReceiptBatcher::Clock::now())) {
+			send(batch);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	for (const auto &batch : batcher_->drain()) {
+		send(batch);
+	}
+}
+
+void ReadReceipts::send(const ReceiptBatcher::Batch &batch)
+{
+	auto started = Worker::Clock::now();
+	size_t count = batch.messages.size();
+	++worker_.metrics().operation(Operation::ReceiptsRead).issued;
+	++in_flight_;
+	worker_.zim()->sendMessageReceiptsRead(
+		batch.messages, batch.conversation_id, batch.type,
+		[this, started, count](const std::string &, zim::ZIMConversationType,
+				       const std::vector<long long> &errorMessageIDs, const zim::ZIMError &errorInfo) {
+			if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+				worker_.slot().receipts_read += count - std::min(count, errorMessageIDs.size());
+			}
+			worker_.recordOperation(Operation::ReceiptsRead, started, errorInfo);
+			--in_flight_;
+		});
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ZIM.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "receipt_batcher.h"
+#include "receipt_tracker.h"
+
+class Worker;
+
+// --read-receipts: receivers and group members mark the messages sent with a receipt read, in batches per
+// conversation that are sent when full or after --receipt-delay. Senders of --receipt and --matrix time the
+// receipts that come back for their messages.
+class ReadReceipts {
+public:
+	explicit ReadReceipts(Worker &worker);
+	~ReadReceipts();
+
+	// starts sending the batches of a receiver
+	void start();
+	// Sends what is left in the batches and waits up to --drain-timeout for their callbacks.
+	void finish();
+
+	// queues the messages that wait for a receipt, a full batch is sent right away
+	void markRead(const std::vector<std::shared_ptr<zim::ZIMMessage>> &messageList,
+		      const std::string &conversationID, zim::ZIMConversationType type);
+
+	// the receipts of this sender are timed
+	bool timing() const { return tracker_ != nullptr; }
+	// from the sent callback of a message with hasReceipt, once it has its ID
+	void sent(long long message_id, ReceiptTracker::Clock::time_point dispatched);
+	// times the receipts of onMessageReceiptChanged
+	void changed(const std::vector<zim::ZIMMessageReceiptInfo> &infos);
+
+private:
+	// Sends the batches whose first message waited --receipt-delay, at the end the rest of them.
+	void loop();
+	void send(const ReceiptBatcher::Batch &batch);
+
+	Worker &worker_;
+	std::unique_ptr<ReceiptBatcher> batcher_;
+	std::thread thread_;
+	std::atomic<uint64_t> in_flight_{0};
+	std::unique_ptr<ReceiptTracker> tracker_;
+};
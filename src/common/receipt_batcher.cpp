@@ -0,0 +1,52 @@
+#include "receipt_batcher.h"
+
+#include <utility>
+
+bool ReceiptBatcher::add(const std::string &conversation_id, zim::ZIMConversationType type,
+			 const std::shared_ptr<zim::ZIMMessage> &message, Clock::time_point now, Batch &full)
+{
+	std::string key = std::to_string(static_cast<int>(type)) + ":" + conversation_id;
+	std::lock_guard<std::mutex> lock(mutex_);
+	Batch &batch = batches_[key];
+	if (batch.messages.empty()) {
+		batch.conversation_id = conversation_id;
+		batch.type = type;
+		batch.opened = now;
+	}
+	batch.messages.push_back(message);
+	if (batch.messages.size() < size_) {
+		return false;
+	}
+	full = std::move(batch);
+	batches_.erase(key);
+	return true;
+}
+
+std::vector<ReceiptBatcher::Batch> ReceiptBatcher::due(Clock::time_point now)
+{
+	std::vector<Batch> due;
+	if (delay_ == Clock::duration::zero()) {
+		return due;
+	}
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto it = batches_.begin(); it != batches_.end();) {
+		if (now - it->second.opened >= delay_) {
+			due.push_back(std::move(it->second));
+			it = batches_.erase(it);
+		} else {
+			++it;
+		}
+	}
+	return due;
+}
+
+std::vector<ReceiptBatcher::Batch> ReceiptBatcher::drain()
+{
+	std::vector<Batch> drained;
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto &batch : batches_) {
+		drained.push_back(std::move(batch.second));
+	}
+	batches_.clear();
+	return drained;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ZIM.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Received messages waiting to be marked read with sendMessageReceiptsRead, batched per conversation the
+// way a client marks what scrolled into view. A batch goes out once it holds `size` messages or once its
+// first message waited `delay`.
+class ReceiptBatcher {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Batch {
+		std::string conversation_id;
+		zim::ZIMConversationType type = zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER;
+		std::vector<std::shared_ptr<zim::ZIMMessage>> messages;
+		Clock::time_point opened;
+	};
+
+	// a zero `delay` only sends full batches
+	ReceiptBatcher(size_t size, Clock::duration delay) : size_(size), delay_(delay) {}
+
+	// Adds a message of the conversation. True with the batch in `full` when it reached the size.
+	bool add(const std::string &conversation_id, zim::ZIMConversationType type,
+		 const std::shared_ptr<zim::ZIMMessage> &message, Clock::time_point now, Batch &full);
+	// the batches whose first message waited the delay by `now`
+	std::vector<Batch> due(Clock::time_point now);
+	// every batch, whatever its size, at the end of the run
+	std::vector<Batch> drain();
+
+private:
+	const size_t size_;
+	const Clock::duration delay_;
+
+	std::mutex mutex_;
+	// keyed by the conversation type and ID
+	std::unordered_map<std::string, Batch> batches_;
+};
@@ -0,0 +1,39 @@
+#include "receipt_tracker.h"
+
+void ReceiptTracker::sent(long long message_id, Clock::time_point dispatched)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	expire(dispatched);
+	dispatched_[message_id] = dispatched;
+	order_.emplace_back(dispatched, message_id);
+}
+
+bool ReceiptTracker::find(long long message_id, Clock::time_point now, Clock::time_point &dispatched)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	expire(now);
+	auto it = dispatched_.find(message_id);
+	if (it == dispatched_.end()) {
+		return false;
+	}
+	dispatched = it->second;
+	return true;
+}
+
+size_t ReceiptTracker::size() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return dispatched_.size();
+}
+
+void ReceiptTracker::expire(Clock::time_point now)
+{
+	while (!order_.empty() && now - order_.front().first > horizon_) {
+		auto it = dispatched_.find(order_.front().second);
+		// an ID sent again since keeps its newer entry
+		if (it != dispatched_.end() && it->second == order_.front().first) {
+			dispatched_.erase(it);
+		}
+		order_.pop_front();
+	}
+}
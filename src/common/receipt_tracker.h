@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Sending side of read receipts: when every message sent with hasReceipt was dispatched, so the
+// onMessageReceiptChanged of each reader can be timed against it. A group message is read once per member
+// and matches every time. Messages are forgotten after `horizon`, a receipt for one of them is unmatched.
+class ReceiptTracker {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	explicit ReceiptTracker(Clock::duration horizon) : horizon_(horizon) {}
+
+	// from the sent callback, once the message has its ID
+	void sent(long long message_id, Clock::time_point dispatched);
+	// false for a message this sender did not send within the horizon
+	bool find(long long message_id, Clock::time_point now, Clock::time_point &dispatched);
+	size_t size() const;
+
+private:
+	// the caller holds the lock
+	void expire(Clock::time_point now);
+
+	const Clock::duration horizon_;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<long long, Clock::time_point> dispatched_;
+	// (dispatched, message ID) in the order the sent callbacks came, about the order of dispatch
+	std::deque<std::pair<Clock::time_point, long long>> order_;
+};
@@ -0,0 +1,530 @@
+#include "reporter.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "delivery_tracker.h"
+#include "media_transfer.h"
+#include "room_session.h"
+#include "run_summary.h"
+#include "send_variant.h"
+
+Reporter::Reporter(const Options &options, MetricsRegion &metrics)
+	: options_(options), metrics_(metrics), matrix_(options, metrics), profile_spec_(options.profile_spec),
+	  profile_start_(options.profile_start), profile_(options.profile)
+{
+}
+
+Reporter::~Reporter()
+{
+	stop();
+}
+
+void Reporter::start()
+{
+	if (options_.report_interval <= 0) {
+		return;
+	}
+	ticker_.reset(new RateScheduler(1.0 / options_.report_interval, PacingMode::Skip));
+	thread_ = std::thread(&Reporter::reportLoop, this);
+}
+
+void Reporter::stop()
+{
+	if (ticker_) {
+		ticker_->stop();
+	}
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+void Reporter::reportLoop()
+{
+	IntervalReport last;
+	RateScheduler::Clock::time_point tick;
+	// the first slot is due immediately, skip it so every report covers a full interval
+	ticker_->acquire(tick);
+	while (ticker_->acquire(tick)) {
+		printInterval(last);
+	}
+}
+
+void Reporter::poll(bool last)
+{
+	if (!profile_spec_.empty()) {
+		pollProfile(last);
+	}
+	if (options_.matrix > 0) {
+		matrix_.poll(last);
+	}
+}
+
+void Reporter::restartProfile(const std::string &spec, uint64_t start)
+{
+	if (spec == profile_spec_ && start == profile_start_) {
+		return;
+	}
+	if (!profile_spec_.empty()) {
+		pollProfile(true);
+	}
+	// the windows of the new profile are counted from its start
+	profile_spec_ = spec;
+	profile_start_ = start;
+	profile_.parse(profile_spec_);
+	ProfileReport &report = profile_report_;
+	report.start = 0;
+	report.end = 0;
+	report.closed = 0;
+	report.last.totals = metrics_.totals();
+	report.last.service = metrics_.serviceLatency().snapshot();
+	report.last.response = metrics_.responseLatency().snapshot();
+}
+
+void Reporter::pollProfile(bool last)
+{
+	ProfileReport &report = profile_report_;
+	double seconds = (unixMicros() - profile_start_) / 1e6;
+	if (report.end == 0) {
+		report.end = profile_.windowEnd(0);
+	}
+	if (last ? seconds - report.closed < 0.5 : seconds < report.end) {
+		return;
+	}
+
+	IntervalReport now;
+	now.totals = metrics_.totals();
+	now.service = metrics_.serviceLatency().snapshot();
+	now.response = metrics_.responseLatency().snapshot();
+	double covered = seconds - report.closed;
+	ProfileReport::Window window;
+	window.start = report.start;
+	window.end = last ? seconds : report.end;
+	window.target = profile_.mean(window.start, window.end);
+	window.acked = double(now.totals.acked - report.last.totals.acked) / covered;
+	window.failed = double(now.totals.failed - report.last.totals.failed) / covered;
+	window.response = now.response.since(report.last.response);
+	report.windows.push_back(window);
+
+	std::cout << "[profile][" << window.start << "~" << window.end << "s] target qps: " << window.target
+		  << ", sent/s: " << double(now.totals.sent - report.last.totals.sent) / covered
+		  << ", acked/s: " << window.acked << ", failed/s: " << window.failed << std::endl;
+	std::cout << "[latency][profile][service] " << now.service.since(report.last.service).summary() << std::endl;
+	std::cout << "[latency][profile][response] " << window.response.summary() << std::endl;
+
+	report.last = now;
+	report.closed = seconds;
+	report.start = report.end;
+	report.end = profile_.windowEnd(report.end);
+}
+
+void Reporter::printProfile()
+{
+	std::cout << "[profile] window(s) target_qps acked/s failed/s response_p50 p99 p99.9 (ms)" << std::endl;
+	for (const auto &window : profile_report_.windows) {
+		std::cout << "[profile] " << window.start << "~" << window.end << " " << window.target << " "
+			  << window.acked << " " << window.failed << " " << window.response.quantile(0.5) / 1000.0
+			  << " " << window.response.quantile(0.99) / 1000.0 << " "
+			  << window.response.quantile(0.999) / 1000.0 << std::endl;
+	}
+}
+
+void Reporter::printInterval(IntervalReport &last)
+{
+	const Options &options = options_;
+	const int interval = options.report_interval;
+	IntervalReport now;
+	now.totals = metrics_.totals();
+	if (options.role == "sender") {
+		now.service = metrics_.serviceLatency().snapshot();
+		now.response = metrics_.responseLatency().snapshot();
+		std::cout << "[throughput] sent/s: " << double(now.totals.sent - last.totals.sent) / interval
+			  << ", acked/s: " << double(now.totals.acked - last.totals.acked) / interval
+			  << ", failed/s: " << double(now.totals.failed - last.totals.failed) / interval
+			  << ", in-flight: " << inFlight(now.totals)
+			  << ", timeouts: " << now.totals.timeouts << std::endl;
+		std::cout << "[latency][interval][service] " << now.service.since(last.service).summary()
+			  << std::endl;
+		std::cout << "[latency][interval][response] " << now.response.since(last.response).summary()
+			  << std::endl;
+	}
+	if (options.sending && !options.media_spec.empty()) {
+		now.upload_progress = metrics_.uploadProgressGap().snapshot();
+		double uploaded = now.totals.uploaded_bytes - last.totals.uploaded_bytes;
+		std::cout << "[media] upload MiB/s: " << uploaded / interval / (1 << 20) << ", progress/s: "
+			  << double(now.totals.upload_progress - last.totals.upload_progress) / interval << std::endl;
+		std::cout << "[latency][interval][upload_progress] "
+			  << now.upload_progress.since(last.upload_progress).summary() << std::endl;
+	}
+	if (options.timing_receipts) {
+		now.receipt = metrics_.receiptLatency().snapshot();
+		std::cout << "[receipt] receipts/s: " << double(now.totals.receipts - last.totals.receipts) / interval
+			  << ", unmatched: " << now.totals.receipts_unmatched << std::endl;
+		std::cout << "[latency][interval][receipt] " << now.receipt.since(last.receipt).summary()
+			  << std::endl;
+	}
+	for (size_t i = 0; i < static_cast<size_t>(Operation::Count); ++i) {
+		if (!reportsOperation(static_cast<Operation>(i))) {
+			continue;
+		}
+		OperationMetrics &operation = metrics_.operation(static_cast<Operation>(i));
+		now.issued[i] = operation.issued;
+		now.failed[i] = operation.failed;
+		now.operations[i] = operation.latency.snapshot();
+		std::cout << "[op][interval][" << operationName(static_cast<Operation>(i))
+			  << "] calls/s: " << double(now.issued[i] - last.issued[i]) / interval
+			  << ", failed/s: " << double(now.failed[i] - last.failed[i]) / interval << ", "
+			  << now.operations[i].since(last.operations[i]).summary() << std::endl;
+	}
+	if (options.history_walkers > 0 && options.sending) {
+		size_t server = static_cast<size_t>(Operation::HistoryServer);
+		size_t cache = static_cast<size_t>(Operation::HistoryCache);
+		double pages = now.issued[server] + now.issued[cache] - last.issued[server] - last.issued[cache];
+		double messages = now.totals.history_messages - last.totals.history_messages;
+		std::cout << "[history] pages/s: " << pages / interval << ", messages/s: " << messages / interval
+			  << ", walks: " << now.totals.history_walks - last.totals.history_walks << std::endl;
+	}
+	if (options.role == "login") {
+		now.login = metrics_.loginLatency().snapshot();
+		std::cout << "[login] logins/s: " << double(now.totals.logins - last.totals.logins) / interval
+			  << ", failed/s: " << double(now.totals.logins_failed - last.totals.logins_failed) / interval
+			  << ", logged in: " << now.totals.logged_in << std::endl;
+		std::cout << "[latency][interval][login] " << now.login.since(last.login).summary() << std::endl;
+	}
+	if (options.receiving) {
+		now.delivery = metrics_.deliveryLatency().snapshot();
+		double received = double(now.totals.received - last.totals.received) / interval;
+		std::cout << "[delivery] received/s: " << received
+			  << ", per receiver: " << received / std::max<size_t>(1, now.totals.logged_in)
+			  << ", duplicates/s: " << double(now.totals.duplicates - last.totals.duplicates) / interval
+			  << ", reordered/s: " << double(now.totals.reordered - last.totals.reordered) / interval
+			  << ", missing: " << now.totals.missing << std::endl;
+		if (options.message_type == "barrage") {
+			std::cout << "[barrage] drop rate: " << dropRate(now.totals) * 100 << "%" << std::endl;
+		}
+		std::cout << "[latency][interval][delivery] " << now.delivery.since(last.delivery).summary()
+			  << std::endl;
+		if (options.read_receipts > 0) {
+			double read = now.totals.receipts_read - last.totals.receipts_read;
+			std::cout << "[receipt] read/s: " << read / interval << std::endl;
+		}
+		if (options.download_media > 0) {
+			now.download_progress = metrics_.downloadProgressGap().snapshot();
+			double downloaded = now.totals.downloaded_bytes - last.totals.downloaded_bytes;
+			double progressed = now.totals.download_progress - last.totals.download_progress;
+			std::cout << "[media] download MiB/s: " << downloaded / interval / (1 << 20)
+				  << ", progress/s: " << progressed / interval << std::endl;
+			std::cout << "[latency][interval][download_progress] "
+				  << now.download_progress.since(last.download_progress).summary() << std::endl;
+		}
+	}
+	last = now;
+}
+
+void Reporter::printTotals()
+{
+	const Options &options = options_;
+	auto totals = metrics_.totals();
+	if (options.role == "sender") {
+		std::cout << "sent: " << totals.sent << ", acked: " << totals.acked << ", failed: " << totals.failed
+			  << ", timeouts: " << totals.timeouts << ", late callbacks: " << totals.late_callbacks
+			  << std::endl;
+		auto errors = metrics_.errors().snapshot();
+		if (!errors.empty()) {
+			std::cout << "failed by code:";
+			for (const auto &error : errors) {
+				std::cout << " " << error.first << ": " << error.second;
+			}
+			std::cout << std::endl;
+		}
+		std::cout << "[latency][total][service] " << metrics_.serviceLatency().snapshot().summary()
+			  << std::endl;
+		std::cout << "[latency][total][response] " << metrics_.responseLatency().snapshot().summary()
+			  << std::endl;
+	}
+	// the span of the load, for the page rate
+	double seconds = std::min<double>(options.execution_time, (unixMicros() - options.load_start) / 1e6);
+	if (options.sending && !options.media_spec.empty()) {
+		// the bytes include the uploads that finished after the load, while draining
+		double uploading = transferSeconds(options.load_start, totals.last_upload);
+		std::cout << "uploaded: " << totals.uploaded_bytes << " bytes, MiB/s: "
+			  << (uploading > 0 ? totals.uploaded_bytes / uploading / (1 << 20) : 0)
+			  << ", progress callbacks: " << totals.upload_progress << std::endl;
+		std::cout << "[latency][total][upload_progress] " << metrics_.uploadProgressGap().snapshot().summary()
+			  << std::endl;
+	}
+	if (options.timing_receipts) {
+		std::cout << "receipts: " << totals.receipts << ", unmatched: " << totals.receipts_unmatched
+			  << std::endl;
+		std::cout << "[latency][total][receipt] " << metrics_.receiptLatency().snapshot().summary()
+			  << std::endl;
+	}
+	if (options.receiving) {
+		std::cout << "received: " << totals.received << ", missing: " << totals.missing
+			  << ", duplicates: " << totals.duplicates << ", reordered: " << totals.reordered << std::endl;
+		if (options.message_type == "barrage") {
+			std::cout << "barrage drop rate: " << dropRate(totals) * 100 << "%, expected: "
+				  << expectedBarrages(totals) << ", arrived: " << totals.received - totals.duplicates
+				  << ", missing in sequence: " << totals.missing << std::endl;
+		}
+		std::cout << "[latency][total][delivery] " << metrics_.deliveryLatency().snapshot().summary()
+			  << std::endl;
+		if (options.read_receipts > 0) {
+			std::cout << "receipts read: " << totals.receipts_read << std::endl;
+		}
+		if (options.download_media > 0) {
+			double downloading = transferSeconds(options.load_start, totals.last_download);
+			std::cout << "downloaded: " << totals.downloaded_bytes << " bytes, MiB/s: "
+				  << (downloading > 0 ? totals.downloaded_bytes / downloading / (1 << 20) : 0)
+				  << ", progress callbacks: " << totals.download_progress << std::endl;
+			std::cout << "[latency][total][download_progress] "
+				  << metrics_.downloadProgressGap().snapshot().summary() << std::endl;
+		}
+	}
+	if (options.role == "login") {
+		std::cout << "logins: " << totals.logins << ", failed: " << totals.logins_failed << std::endl;
+		auto errors = metrics_.loginErrors().snapshot();
+		if (!errors.empty()) {
+			std::cout << "login failed by code:";
+			for (const auto &error : errors) {
+				std::cout << " " << error.first << ": " << error.second;
+			}
+			std::cout << std::endl;
+		}
+		std::cout << "[latency][total][login] " << metrics_.loginLatency().snapshot().summary() << std::endl;
+	}
+	printConnectionChanges();
+	// a profile replaced at run time keeps its windows
+	if (!profile_report_.windows.empty()) {
+		printProfile();
+	}
+	if (options.matrix > 0) {
+		matrix_.print();
+	}
+	for (size_t i = 0; i < static_cast<size_t>(Operation::Count); ++i) {
+		if (!reportsOperation(static_cast<Operation>(i))) {
+			continue;
+		}
+		OperationMetrics &operation = metrics_.operation(static_cast<Operation>(i));
+		std::cout << "[op][total][" << operationName(static_cast<Operation>(i))
+			  << "] issued: " << operation.issued << ", succeeded: " << operation.succeeded
+			  << ", failed: " << operation.failed << ", " << operation.latency.snapshot().summary()
+			  << std::endl;
+	}
+	if (options.history_walkers > 0 && options.sending) {
+		uint64_t server = metrics_.operation(Operation::HistoryServer).issued;
+		uint64_t cache = metrics_.operation(Operation::HistoryCache).issued;
+		std::cout << "history pages: " << server + cache << " (server: " << server << ", cache: " << cache
+			  << "), pages/s: " << (seconds > 0 ? (server + cache) / seconds : 0)
+			  << ", messages: " << totals.history_messages << ", walks: " << totals.history_walks
+			  << std::endl;
+	}
+	auto operation_errors = metrics_.operationErrors().snapshot();
+	if (!operation_errors.empty()) {
+		std::cout << "op failed by code:";
+		for (const auto &error : operation_errors) {
+			std::cout << " " << error.first << ": " << error.second;
+		}
+		std::cout << std::endl;
+	}
+	if (options.conversation == "group" && options.role == "sender") {
+		std::cout << "groups ready: " << totals.groups_ready << ", failed: " << totals.groups_failed
+			  << std::endl;
+		std::cout << "[latency][total][provision] " << metrics_.provisionLatency().snapshot().summary()
+			  << std::endl;
+	}
+}
+
+void Reporter::printConnectionChanges()
+{
+	std::cout << "[connection]";
+	const char *separator = " ";
+	for (size_t state = 0; state < ConnectionChanges::kStates; ++state) {
+		for (size_t event = 0; event < ConnectionChanges::kEvents; ++event) {
+			uint64_t count = metrics_.connectionChanges().count(state, event);
+			if (count > 0) {
+				std::cout << separator << ConnectionChanges::stateName(state) << "/"
+					  << ConnectionChanges::eventName(event) << ": " << count;
+				separator = ", ";
+			}
+		}
+	}
+	std::cout << std::endl;
+}
+
+// the calls of a --workload, sendMessageReceiptsRead of the receivers of --read-receipts, downloadMediaFile of
+// --download-media and the pages of --history-walkers
+bool Reporter::reportsOperation(Operation operation) const
+{
+	if (operation == Operation::ReceiptsRead) {
+		return options_.read_receipts > 0 && options_.receiving;
+	}
+	if (operation == Operation::DownloadMedia) {
+		return options_.download_media > 0 && options_.receiving;
+	}
+	if (operation == Operation::HistoryServer || operation == Operation::HistoryCache ||
+	    operation == Operation::HistoryFailed) {
+		return options_.history_walkers > 0 && options_.sending;
+	}
+	return !options_.workload.phases().empty();
+}
+
+void Reporter::writeSummary()
+{
+	RunSummary summary;
+	char host[256] = {};
+	gethostname(host, sizeof(host) - 1);
+	summary.setHost(host[0] != '\0' ? host : "unknown");
+	auto totals = metrics_.totals();
+	uint64_t load_start = options_.load_start;
+	uint64_t end = std::min<uint64_t>(unixMicros(), load_start + options_.execution_time * 1000000ULL);
+	// the first call shows how late this host really started, --start-at is the same everywhere
+	uint64_t started = totals.first_action != 0 ? totals.first_action : load_start;
+	summary.setSpan(started / 1000, std::max(started, end) / 1000);
+
+	summary.addCounter("sent", totals.sent);
+	summary.addCounter("acked", totals.acked);
+	summary.addCounter("failed", totals.failed);
+	summary.addCounter("timeouts", totals.timeouts);
+	summary.addCounter("late_callbacks", totals.late_callbacks);
+	summary.addCounter("received", totals.received);
+	summary.addCounter("missing", totals.missing);
+	summary.addCounter("duplicates", totals.duplicates);
+	summary.addCounter("reordered", totals.reordered);
+	summary.addCounter("logins", totals.logins);
+	summary.addCounter("logins_failed", totals.logins_failed);
+	summary.addCounter("receipts_read", totals.receipts_read);
+	summary.addCounter("receipts", totals.receipts);
+	summary.addCounter("receipts_unmatched", totals.receipts_unmatched);
+	summary.addCounter("uploaded_bytes", totals.uploaded_bytes);
+	summary.addCounter("upload_progress", totals.upload_progress);
+	summary.addCounter("downloaded_bytes", totals.downloaded_bytes);
+	summary.addCounter("download_progress", totals.download_progress);
+	summary.addCounter("history_messages", totals.history_messages);
+	summary.addCounter("history_walks", totals.history_walks);
+	for (const auto &error : metrics_.errors().snapshot()) {
+		summary.addCounter("failed." + std::to_string(error.first), error.second);
+	}
+	for (const auto &error : metrics_.loginErrors().snapshot()) {
+		summary.addCounter("logins_failed." + std::to_string(error.first), error.second);
+	}
+	summary.addHistogram("service", metrics_.serviceLatency().snapshot());
+	summary.addHistogram("response", metrics_.responseLatency().snapshot());
+	summary.addHistogram("delivery", metrics_.deliveryLatency().snapshot());
+	summary.addHistogram("login", metrics_.loginLatency().snapshot());
+	summary.addHistogram("provision", metrics_.provisionLatency().snapshot());
+	summary.addHistogram("receipt", metrics_.receiptLatency().snapshot());
+	summary.addHistogram("upload_progress", metrics_.uploadProgressGap().snapshot());
+	summary.addHistogram("download_progress", metrics_.downloadProgressGap().snapshot());
+	for (size_t i = 0; i < static_cast<size_t>(Operation::Count); ++i) {
+		std::string name = operationName(static_cast<Operation>(i));
+		OperationMetrics &operation = metrics_.operation(static_cast<Operation>(i));
+		summary.addCounter("op." + name + ".issued", operation.issued);
+		summary.addCounter("op." + name + ".failed", operation.failed);
+		summary.addHistogram("op." + name, operation.latency.snapshot());
+	}
+	for (size_t i = 0; options_.matrix > 0 && i < SendVariant::kMatrixCells; ++i) {
+		std::string name = "matrix." + SendVariant::matrixCell(i).name();
+		VariantMetrics &cell = metrics_.variant(i);
+		summary.addCounter(name + ".sent", cell.sent);
+		summary.addCounter(name + ".acked", cell.acked);
+		summary.addCounter(name + ".failed", cell.failed);
+		summary.addHistogram(name + ".response", cell.response.snapshot());
+	}
+
+	std::string error;
+	if (!summary.write(options_.histogram_out, error)) {
+		std::cout << "failed to write the summary: " << error << std::endl;
+	}
+}
+
+int runMerge(const std::vector<std::string> &files)
+{
+	std::vector<RunSummary> summaries(files.size());
+	RunSummary merged;
+	for (size_t i = 0; i < files.size(); ++i) {
+		std::string error;
+		if (!summaries[i].read(files[i], error)) {
+			std::cout << "invalid summary: " << error << std::endl;
+			return 1;
+		}
+		merged.merge(summaries[i]);
+	}
+
+	std::cout << "[merge] host start(s) sent acked failed received response_p99 delivery_p99 (ms)" << std::endl;
+	for (const auto &summary : summaries) {
+		HistogramSnapshot response;
+		HistogramSnapshot delivery;
+		for (const auto &entry : summary.histograms()) {
+			if (entry.first == "response") {
+				response = entry.second;
+			} else if (entry.first == "delivery") {
+				delivery = entry.second;
+			}
+		}
+		std::cout << "[merge] " << summary.host() << " +" << (summary.started() - merged.started()) / 1000.0
+			  << " " << summary.counter("sent") << " " << summary.counter("acked") << " "
+			  << summary.counter("failed") << " " << summary.counter("received") << " "
+			  << response.quantile(0.99) / 1000.0 << " " << delivery.quantile(0.99) / 1000.0 << std::endl;
+	}
+
+	double seconds = (merged.finished() - merged.started()) / 1000.0;
+	std::cout << "hosts: " << summaries.size() << ", span: " << seconds << "s" << std::endl;
+	std::cout << "sent: " << merged.counter("sent") << ", acked: " << merged.counter("acked")
+		  << ", failed: " << merged.counter("failed") << ", timeouts: " << merged.counter("timeouts")
+		  << ", late callbacks: " << merged.counter("late_callbacks")
+		  << ", acked/s: " << (seconds > 0 ? merged.counter("acked") / seconds : 0) << std::endl;
+	if (merged.counter("received") > 0) {
+		std::cout << "received: " << merged.counter("received") << ", missing: " << merged.counter("missing")
+			  << ", duplicates: " << merged.counter("duplicates")
+			  << ", reordered: " << merged.counter("reordered") << std::endl;
+	}
+	if (merged.counter("logins") > 0) {
+		std::cout << "logins: " << merged.counter("logins") << ", failed: " << merged.counter("logins_failed")
+			  << std::endl;
+	}
+	if (merged.counter("receipts_read") > 0 || merged.counter("receipts") > 0) {
+		std::cout << "receipts read: " << merged.counter("receipts_read")
+			  << ", receipts: " << merged.counter("receipts")
+			  << ", unmatched: " << merged.counter("receipts_unmatched") << std::endl;
+	}
+	if (merged.counter("uploaded_bytes") > 0 || merged.counter("downloaded_bytes") > 0) {
+		double uploaded = merged.counter("uploaded_bytes");
+		double downloaded = merged.counter("downloaded_bytes");
+		std::cout << "uploaded: " << uploaded
+			  << " bytes, MiB/s: " << (seconds > 0 ? uploaded / seconds / (1 << 20) : 0)
+			  << ", downloaded: " << downloaded
+			  << " bytes, MiB/s: " << (seconds > 0 ? downloaded / seconds / (1 << 20) : 0) << std::endl;
+	}
+	if (merged.counter("history_messages") > 0 || merged.counter("history_walks") > 0) {
+		uint64_t server = merged.counter("op.history_server.issued");
+		uint64_t cache = merged.counter("op.history_cache.issued");
+		std::cout << "history pages: " << server + cache << " (server: " << server << ", cache: " << cache
+			  << "), pages/s: " << (seconds > 0 ? (server + cache) / seconds : 0)
+			  << ", messages: " << merged.counter("history_messages")
+			  << ", walks: " << merged.counter("history_walks") << std::endl;
+	}
+	const std::pair<const char *, const char *> by_code[] = {{"failed.", "failed by code:"},
+								 {"logins_failed.", "login failed by code:"}};
+	for (const auto &codes : by_code) {
+		size_t length = std::strlen(codes.first);
+		std::string line;
+		for (const auto &counter : merged.counters()) {
+			if (counter.first.compare(0, length, codes.first) == 0) {
+				line += " " + counter.first.substr(length) + ": " + std::to_string(counter.second);
+			}
+		}
+		if (!line.empty()) {
+			std::cout << codes.second << line << std::endl;
+		}
+	}
+	for (const auto &entry : merged.histograms()) {
+		if (entry.second.count() > 0) {
+			std::cout << "[latency][total][" << entry.first << "] " << entry.second.summary() << std::endl;
+		}
+	}
+	return 0;
+}
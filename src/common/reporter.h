@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latency_histogram.h"
+#include "load_profile.h"
+#include "matrix_sweep.h"
+#include "options.h"
+#include "rate_scheduler.h"
+#include "shared_metrics.h"
+
+// state of the previous periodic report, the next one prints the difference
+struct IntervalReport {
+	MetricsTotals totals;
+	HistogramSnapshot service;
+	HistogramSnapshot response;
+	HistogramSnapshot delivery;
+	HistogramSnapshot login;
+	HistogramSnapshot receipt;
+	HistogramSnapshot upload_progress;
+	HistogramSnapshot download_progress;
+	uint64_t issued[static_cast<size_t>(Operation::Count)] = {};
+	uint64_t failed[static_cast<size_t>(Operation::Count)] = {};
+	HistogramSnapshot operations[static_cast<size_t>(Operation::Count)];
+};
+
+// report windows of --profile, the current one is closed by poll() once its end has passed
+struct ProfileReport {
+	struct Window {
+		double start;
+		double end;
+		double target;
+		double acked;
+		double failed;
+		HistogramSnapshot response;
+	};
+
+	// seconds since the profile started
+	double start = 0;
+	double end = 0;
+	double closed = 0;
+	IntervalReport last;
+	std::vector<Window> windows;
+};
+
+// What the process owning the metrics region prints about the run, the parent of --users or a single
+// process: the periodic reports, the windows of --profile and the cells of --matrix as they end, the totals
+// at exit and the --histogram-out summary for --merge.
+class Reporter {
+public:
+	Reporter(const Options &options, MetricsRegion &metrics);
+	~Reporter();
+
+	// prints an interval every --report-interval on a thread of its own
+	void start();
+	void stop();
+	// Prints the profile windows and matrix cells that ended, at exit the rest of them.
+	void poll(bool last);
+	// A profile set while running replaces the one reported on, its windows are counted from `start`. The
+	// windows of the earlier ones are kept.
+	void restartProfile(const std::string &spec, uint64_t start);
+
+	void printInterval(IntervalReport &last);
+	void printTotals();
+	// --histogram-out: the counters and histograms of this host, the span is from its first call to the end
+	// of the load
+	void writeSummary();
+
+private:
+	void reportLoop();
+	// Prints the window that has ended, or at exit the one still open. The rates are over the time actually
+	// covered, the polls are up to 50ms late.
+	void pollProfile(bool last);
+	// one line per window, the load against the latency
+	void printProfile();
+	// state/event: count of every combination seen so far
+	void printConnectionChanges();
+	bool reportsOperation(Operation operation) const;
+
+	const Options &options_;
+	MetricsRegion &metrics_;
+	MatrixSweep matrix_;
+	std::unique_ptr<RateScheduler> ticker_;
+	std::thread thread_;
+	// the profile reported on, --profile or the last one of the control socket or --rate-file
+	std::string profile_spec_;
+	uint64_t profile_start_;
+	LoadProfile profile_;
+	ProfileReport profile_report_;
+};
+
+// --merge: one report over the --histogram-out files of all hosts. The start offsets show how far apart
+// the hosts began, the latencies are quantiles of all their samples together.
+int runMerge(const std::vector<std::string> &files);
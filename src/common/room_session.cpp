@@ -0,0 +1,62 @@
+#include "room_session.h"
+
+#include <ZIM.h>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+
+#include "worker.h"
+
+RoomSession::RoomSession(Worker &worker) : worker_(worker) {}
+
+void RoomSession::enter(const std::function<void()> &entered)
+{
+	const std::string &room_id = worker_.options().room_id;
+	zim::ZIMRoomInfo roomInfo;
+	roomInfo.roomID = room_id;
+	roomInfo.roomName = room_id;
+	worker_.zim()->enterRoom(
+		roomInfo, zim::ZIMRoomAdvancedConfig(),
+		[this, entered](const zim::ZIMRoomFullInfo &roomInfo, const zim::ZIMError &errorInfo) {
+			bool succeeded = errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS;
+			if (worker_.options().verbose || !succeeded) {
+				std::cout << "[callback][ZIMRoomEnteredCallback] " << worker_.user()
+					  << " code:" << errorInfo.code << ",message:" << errorInfo.message
+					  << std::endl;
+			}
+			if (!succeeded) {
+				worker_.slot().state = static_cast<int>(WorkerState::LoginFailed);
+				return;
+			}
+			worker_.slot().sent_before_join = worker_.metrics().totals().sent;
+			entered();
+		});
+}
+
+void RoomSession::leave()
+{
+	auto left = std::make_shared<std::promise<void>>();
+	std::future<void> done = left->get_future();
+	worker_.zim()->leaveRoom(worker_.options().room_id,
+				 [left](const std::string &, const zim::ZIMError &) { left->set_value(); });
+	done.wait_for(std::chrono::seconds(2));
+}
+
+uint64_t expectedBarrages(const MetricsTotals &totals)
+{
+	uint64_t members = totals.logged_in + totals.finished;
+	// the senders entered before their first barrage and do not get their own
+	uint64_t unreachable = totals.sent_before_join + totals.sent;
+	if (totals.sent > 0 && members > 1 && totals.sent * members > unreachable) {
+		return totals.sent * members - unreachable;
+	}
+	return totals.received - totals.duplicates + totals.missing;
+}
+
+double dropRate(const MetricsTotals &totals)
+{
+	uint64_t arrived = totals.received - totals.duplicates;
+	uint64_t expected = expectedBarrages(totals);
+	return expected > arrived ? double(expected - arrived) / expected : 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "shared_metrics.h"
+
+class Worker;
+
+// The room of --conversation room, and of the room calls of a --workload: every user enters it after the
+// login and leaves it before the logout. Senders send into it once they are in, text messages or
+// --message-type barrage.
+class RoomSession {
+public:
+	explicit RoomSession(Worker &worker);
+
+	// enterRoom creates the room for the first member and joins it for everyone else, `entered` runs on
+	// the callback thread of the SDK once this user is in
+	void enter(const std::function<void()> &entered);
+	// leave explicitly, the other members see the leave before the logout
+	void leave();
+
+private:
+	Worker &worker_;
+};
+
+// The barrages the receivers should have got. With the senders in this process tree every member should
+// have got what the others sent after it entered the room. Receivers whose senders run elsewhere only know
+// the gaps in the sequences, which miss what was lost after the last barrage of a sender that did arrive.
+uint64_t expectedBarrages(const MetricsTotals &totals);
+// The share of the expected barrages that never arrived, what the server and the SDK dropped under load.
+double dropRate(const MetricsTotals &totals);
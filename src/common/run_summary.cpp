@@ -0,0 +1,141 @@
+#include "run_summary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static const char *kMagic = "zimcli-summary";
+static const int kVersion = 1;
+
+void RunSummary::setSpan(uint64_t started, uint64_t finished)
+{
+	started_ = started;
+	finished_ = finished;
+}
+
+void RunSummary::addCounter(const std::string &name, uint64_t value)
+{
+	for (auto &counter : counters_) {
+		if (counter.first == name) {
+			counter.second += value;
+			return;
+		}
+	}
+	counters_.emplace_back(name, value);
+}
+
+void RunSummary::addHistogram(const std::string &name, const HistogramSnapshot &histogram)
+{
+	for (auto &entry : histograms_) {
+		if (entry.first == name) {
+			entry.second.add(histogram);
+			return;
+		}
+	}
+	histograms_.emplace_back(name, histogram);
+}
+
+void RunSummary::merge(const RunSummary &other)
+{
+	if (started_ == 0 || (other.started_ != 0 && other.started_ < started_)) {
+		started_ = other.started_;
+	}
+	finished_ = std::max(finished_, other.finished_);
+	for (const auto &counter : other.counters_) {
+		addCounter(counter.first, counter.second);
+	}
+	for (const auto &entry : other.histograms_) {
+		addHistogram(entry.first, entry.second);
+	}
+}
+
+uint64_t RunSummary::counter(const std::string &name) const
+{
+	for (const auto &counter : counters_) {
+		if (counter.first == name) {
+			return counter.second;
+		}
+	}
+	return 0;
+}
+
+bool RunSummary::write(const std::string &path, std::string &error) const
+{
+	// renamed into place, a merge started early never reads half a file
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+		file << kMagic << " " << kVersion << "\n";
+		file << "host " << host_ << "\n";
+		file << "started " << started_ << "\n";
+		file << "finished " << finished_ << "\n";
+		for (const auto &counter : counters_) {
+			file << "counter " << counter.first << " " << counter.second << "\n";
+		}
+		for (const auto &entry : histograms_) {
+			file << "histogram " << entry.first << " " << entry.second.encode() << "\n";
+		}
+		if (!file.flush()) {
+			error = "cannot write " + temporary;
+			return false;
+		}
+	}
+	if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+		error = "cannot rename " + temporary + " to " + path;
+		return false;
+	}
+	return true;
+}
+
+bool RunSummary::read(const std::string &path, std::string &error)
+{
+	std::ifstream file(path);
+	if (!file) {
+		error = "cannot open " + path;
+		return false;
+	}
+	std::string line;
+	std::string magic;
+	int version = 0;
+	if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) || magic != kMagic ||
+	    version != kVersion) {
+		error = path + " is not a zimcli summary";
+		return false;
+	}
+
+	RunSummary summary;
+	size_t number = 1;
+	while (std::getline(file, line)) {
+		++number;
+		std::istringstream in(line);
+		std::string kind;
+		std::string name;
+		in >> kind;
+		bool ok = true;
+		if (kind == "host") {
+			ok = static_cast<bool>(in >> summary.host_);
+		} else if (kind == "started") {
+			ok = static_cast<bool>(in >> summary.started_);
+		} else if (kind == "finished") {
+			ok = static_cast<bool>(in >> summary.finished_);
+		} else if (kind == "counter") {
+			uint64_t value = 0;
+			ok = static_cast<bool>(in >> name >> value);
+			summary.addCounter(name, value);
+		} else if (kind == "histogram") {
+			HistogramSnapshot histogram;
+			std::string encoded;
+			ok = static_cast<bool>(in >> name) && std::getline(in, encoded) && histogram.decode(encoded);
+			summary.addHistogram(name, histogram);
+		} else if (!kind.empty()) {
+			ok = false;
+		}
+		if (!ok) {
+			error = path + ":" + std::to_string(number) + ": cannot parse " + line.substr(0, 40);
+			return false;
+		}
+	}
+	*this = summary;
+	return true;
+}
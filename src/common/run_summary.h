@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.h"
+
+// The final counters and full latency histograms of one run, written by --histogram-out on every host
+// of a distributed run and read back by --merge, which adds them up into the report of the whole run.
+// Quantiles cannot be averaged, the buckets can be summed. One item per line:
+//
+//     zimcli-summary 1
+//     host tx-01
+//     started 1700000000000
+//     finished 1700000300000
+//     counter sent 600000
+//     histogram response <count> <sum> <max> <bucket>:<count> ...
+class RunSummary {
+public:
+	void setHost(const std::string &host) { host_ = host; }
+	// unix ms this host started its load and the run ended
+	void setSpan(uint64_t started, uint64_t finished);
+	// items keep the order they were added in, a second one of the same name is added to the first
+	void addCounter(const std::string &name, uint64_t value);
+	void addHistogram(const std::string &name, const HistogramSnapshot &histogram);
+	// Adds the counters and histograms of another host, the span covers both.
+	void merge(const RunSummary &other);
+
+	// false with the reason in `error`
+	bool write(const std::string &path, std::string &error) const;
+	bool read(const std::string &path, std::string &error);
+
+	const std::string &host() const { return host_; }
+	uint64_t started() const { return started_; }
+	uint64_t finished() const { return finished_; }
+	// 0 for a counter the run did not have
+	uint64_t counter(const std::string &name) const;
+	const std::vector<std::pair<std::string, uint64_t>> &counters() const { return counters_; }
+	const std::vector<std::pair<std::string, HistogramSnapshot>> &histograms() const { return histograms_; }
+
+private:
+	std::string host_;
+	uint64_t started_ = 0;
+	uint64_t finished_ = 0;
+	std::vector<std::pair<std::string, uint64_t>> counters_;
+	std::vector<std::pair<std::string, HistogramSnapshot>> histograms_;
+};
@@ -0,0 +1,261 @@
+#include "runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "load_control.h"
+#include "metrics_emitter.h"
+#include "reporter.h"
+#include "worker.h"
+#include "worker_pool.h"
+
+namespace {
+
+// --metrics-out and --metrics-port, null if neither is set
+bool startMetrics(const Options &options, MetricsRegion *metrics, std::unique_ptr<MetricsEmitter> &emitter)
+{
+	if (options.metrics_out.empty() && options.metrics_port <= 0) {
+		return true;
+	}
+	emitter.reset(new MetricsEmitter(metrics, std::chrono::milliseconds(options.metrics_interval)));
+	MetricsFormat format = MetricsFormat::JsonLines;
+	parseMetricsFormat(options.metrics_format, format);
+	if (!options.metrics_out.empty() && !emitter->openFile(options.metrics_out, format)) {
+		std::cout << "failed to open " << options.metrics_out << std::endl;
+		return false;
+	}
+	if (options.metrics_port > 0 && !emitter->listen(options.metrics_port)) {
+		std::cout << "failed to listen on 127.0.0.1:" << options.metrics_port << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// what the workers of --users are to do, printed once by the parent instead of by every worker
+void printFanOut(const Options &options, int sending_users)
+{
+	const std::string &role = options.role;
+	const std::string &conversation = options.conversation;
+	std::cout << "users: " << options.users << " (" << options.user_prefix << options.user_start << " ~ "
+		  << options.user_prefix << options.user_start + options.users - 1 << ")" << std::endl;
+	std::cout << "role: " << role << std::endl;
+	if (conversation == "room") {
+		std::cout << "room: " << options.room_id << ", senders: " << (role == "sender" ? sending_users : 0)
+			  << std::endl;
+	}
+	if (conversation == "group" && role == "sender") {
+		std::cout << "groups: " << options.groups << " (" << options.group_prefix << "0 ~ "
+			  << options.group_prefix << options.groups - 1 << "), group_size: " << options.group_size
+			  << ", senders: " << sending_users << std::endl;
+	}
+	if (role == "sender") {
+		if (conversation == "peer") {
+			std::cout << "receiver: " << (options.receiver.empty() ? "next user" : options.receiver)
+				  << std::endl;
+		}
+		if (options.concurrency > 0) {
+			std::cout << "concurrency: " << options.concurrency << std::endl;
+		} else if (!options.profile_spec.empty()) {
+			std::cout << "profile: " << options.profile_spec << std::endl;
+		} else if (options.workload.phases().empty()) {
+			std::cout << "qps: " << options.qps << std::endl;
+		}
+		if (options.message_type != "text" || options.batch > 1) {
+			std::cout << "message_type: " << options.message_type << ", batch: " << options.batch
+				  << std::endl;
+		}
+		if (!options.media_spec.empty()) {
+			std::cout << "media: " << options.media_spec << ", media_dir: " << options.media_dir
+				  << std::endl;
+		}
+		if (options.history_walkers > 0) {
+			std::cout << "history_walkers: " << options.history_walkers
+				  << ", history_seed: " << options.history_seed << ", page_size: " << options.page_size
+				  << ", history_reverse: " << options.history_reverse << std::endl;
+		}
+		if (options.matrix > 0) {
+			std::cout << "matrix: " << SendVariant::kMatrixCells << " cells of " << options.matrix << "s"
+				  << std::endl;
+		} else if (options.priority != "low" || options.receipt != 0 || options.push != 0) {
+			std::cout << "send_config: " << options.send_variant.name() << std::endl;
+		}
+		for (const auto &phase : options.workload.phases()) {
+			std::cout << "phase " << phase.name << ": " << phase.duration.count()
+				  << "s, qps: " << phase.qps;
+			for (const auto &weight : phase.weights) {
+				std::cout << ", " << workloadOpName(weight.first) << ": " << weight.second;
+			}
+			std::cout << std::endl;
+		}
+	}
+	if (role == "login") {
+		std::cout << "login_period: " << options.login_period << "ms, login_jitter: " << options.login_jitter
+			  << "ms" << std::endl;
+	}
+	if (options.read_receipts > 0 && options.receiving) {
+		std::cout << "read_receipts: " << options.read_receipts << ", receipt_delay: " << options.receipt_delay
+			  << "ms" << std::endl;
+	}
+	if (options.download_media > 0 && options.receiving) {
+		std::cout << "download_media: " << options.download_media << std::endl;
+	}
+	std::cout << "spawn_rate: " << options.spawn_rate << std::endl;
+	if (!options.payload_size.empty()) {
+		std::cout << "payload_size: " << options.payload_size
+			  << ", payload_content: " << options.payload_content << std::endl;
+	}
+	std::cout << "execution_time: " << options.execution_time << std::endl;
+	if (options.start_at != 0) {
+		std::cout << "start_at: " << options.start_at << std::endl;
+	}
+}
+
+} // namespace
+
+int runSingle(const Options &options)
+{
+	MetricsRegion *metrics = MetricsRegion::create(1);
+	std::unique_ptr<MetricsEmitter> emitter;
+	Reporter reporter(options, *metrics);
+	LoadControl control(options, *metrics, reporter);
+	if (!startMetrics(options, metrics, emitter) || !control.start()) {
+		return 1;
+	}
+	std::atomic<bool> metrics_stopped{false};
+	std::thread metrics_thread;
+	if (emitter) {
+		metrics_thread = std::thread([&]() {
+			while (!metrics_stopped) {
+				emitter->poll();
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			}
+		});
+	}
+	reporter.start();
+
+	Worker worker(options, metrics, metrics->worker(0));
+	// a single process is its own parent
+	int code = worker.run([&]() {
+		control.poll();
+		reporter.poll(false);
+	});
+	reporter.poll(true);
+
+	reporter.stop();
+	metrics_stopped = true;
+	if (metrics_thread.joinable()) {
+		metrics_thread.join();
+	}
+	if (emitter) {
+		emitter->flush();
+	}
+	reporter.printTotals();
+	if (!options.histogram_out.empty()) {
+		reporter.writeSummary();
+	}
+	worker.shutdown();
+	return code;
+}
+
+int runFanOut(const Options &options)
+{
+	const int users = options.users;
+	// in a room only the first --senders users send, in groups only the owners
+	int sending_users =
+		options.conversation == "room" && options.senders > 0 ? std::min(options.senders, users) : users;
+	if (options.conversation == "group") {
+		sending_users = std::min(options.groups, users);
+	}
+	printFanOut(options, sending_users);
+
+	MetricsRegion *metrics = MetricsRegion::create(users);
+	if (!metrics) {
+		std::cout << "failed to map the shared metrics region." << std::endl;
+		return 1;
+	}
+	std::unique_ptr<MetricsEmitter> emitter;
+	Reporter reporter(options, *metrics);
+	LoadControl control(options, *metrics, reporter);
+	if (!startMetrics(options, metrics, emitter) || !control.start()) {
+		return 1;
+	}
+
+	const std::string &next_prefix =
+		options.receiver_prefix.empty() ? options.user_prefix : options.receiver_prefix;
+	WorkerPool pool(users, options.spawn_rate, [&](size_t index) {
+		Options worker_options = options;
+		std::string user = options.user_prefix + std::to_string(options.user_start + index);
+		if (options.role == "receiver") {
+			worker_options.receiver = user;
+		} else {
+			worker_options.sender = user;
+			worker_options.receiver =
+				options.receiver.empty()
+					? next_prefix + std::to_string(options.user_start + (index + 1) % users)
+					: options.receiver;
+		}
+		worker_options.sending = options.role == "sender" && int(index) < sending_users;
+		worker_options.index = int(index);
+		worker_options.rate = double(options.qps) / sending_users;
+		worker_options.sending_users = sending_users;
+		if (options.concurrency > 0) {
+			worker_options.concurrency = std::max(1, options.concurrency / sending_users);
+		}
+		worker_options.verbose = options.debug != 0;
+		// the parent emits and is controlled for everyone, drop the copies of its files and sockets
+		emitter.reset();
+		control.close();
+		Worker worker(worker_options, metrics, metrics->worker(index));
+		int code = worker.run(nullptr);
+		worker.shutdown();
+		return code;
+	});
+
+	IntervalReport last;
+	catchStopSignals();
+	auto drain =
+		std::chrono::duration_cast<std::chrono::seconds>(std::chrono::milliseconds(options.drain_timeout));
+	// the workers wait for --start-at before their --execution-time begins
+	auto wait = std::chrono::duration_cast<std::chrono::seconds>(
+		std::max(steadyAt(options.load_start) - std::chrono::steady_clock::now(),
+			 std::chrono::steady_clock::duration()));
+	auto timeout = std::chrono::seconds(options.execution_time + 30) + drain + wait;
+	auto abnormal = pool.run(timeout, options.report_interval, [&]() {
+		auto totals = metrics->totals();
+		std::cout << "[workers] alive: " << pool.alive() << "/" << pool.spawned()
+			  << ", logged in: " << totals.logged_in << ", login failed: " << totals.login_failed;
+		if (options.conversation == "group" && options.role == "sender") {
+			std::cout << ", groups ready: " << totals.groups_ready << "/" << options.groups
+				  << ", groups failed: " << totals.groups_failed;
+		}
+		std::cout << std::endl;
+		reporter.printInterval(last);
+	}, [&]() {
+		if (stopSignalled()) {
+			pool.stop();
+		}
+		control.poll();
+		if (emitter) {
+			emitter->poll();
+		}
+		reporter.poll(false);
+	});
+	reporter.poll(true);
+
+	std::cout << "workers exited abnormally: " << abnormal << ", login failed: " << metrics->totals().login_failed
+		  << std::endl;
+	if (emitter) {
+		emitter->flush();
+		emitter.reset();
+	}
+	reporter.printTotals();
+	if (!options.histogram_out.empty()) {
+		reporter.writeSummary();
+	}
+	MetricsRegion::release(metrics);
+	return abnormal == 0 ? 0 : 1;
+}
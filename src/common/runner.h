@@ -0,0 +1,11 @@
+#pragma once
+
+#include "options.h"
+
+// A single process: one Worker, which is also its own parent and reports, emits the metrics and takes
+// the control commands in its end loop. Returns the exit code.
+int runSingle(const Options &options);
+
+// --users: forks a Worker per user at --spawn-rate, each on a copy of the options with its own user and
+// share of the load. The parent reports, emits and is controlled for all of them.
+int runFanOut(const Options &options);
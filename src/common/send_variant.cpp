@@ -0,0 +1,58 @@
+#include "send_variant.h"
+
+#include "shared_metrics.h"
+
+static_assert(SendVariant::kMatrixCells == MetricsRegion::kSendVariants, "one VariantMetrics per matrix cell");
+
+const size_t SendVariant::kMatrixCells;
+
+static const zim::ZIMMessagePriority kPriorities[] = {
+	zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_LOW,
+	zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_MEDIUM,
+	zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_HIGH,
+};
+
+bool parseMessagePriority(const std::string &name, zim::ZIMMessagePriority &priority)
+{
+	for (auto candidate : kPriorities) {
+		if (name == messagePriorityName(candidate)) {
+			priority = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *messagePriorityName(zim::ZIMMessagePriority priority)
+{
+	switch (priority) {
+	case zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_LOW:
+		return "low";
+	case zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_MEDIUM:
+		return "medium";
+	case zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_HIGH:
+		return "high";
+	}
+	return "unknown";
+}
+
+SendVariant SendVariant::matrixCell(size_t index)
+{
+	SendVariant variant;
+	variant.priority = kPriorities[index / 4 % 3];
+	variant.receipt = index / 2 % 2 != 0;
+	variant.push = index % 2 != 0;
+	return variant;
+}
+
+std::string SendVariant::name() const
+{
+	return std::string(messagePriorityName(priority)) + (receipt ? "/receipt" : "/-") + (push ? "/push" : "/-");
+}
+
+void SendVariant::apply(zim::ZIMMessageSendConfig &config, zim::ZIMPushConfig *push_config) const
+{
+	config.priority = priority;
+	config.hasReceipt = receipt;
+	config.pushConfig = push ? push_config : nullptr;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ZIM.h>
+#include <cstddef>
+#include <string>
+
+bool parseMessagePriority(const std::string &name, zim::ZIMMessagePriority &priority);
+const char *messagePriorityName(zim::ZIMMessagePriority priority);
+
+// The ZIMMessageSendConfig options that may cost the backend extra work per message: the priority, a
+// read receipt and an offline push. --priority, --receipt and --push pick one variant, --matrix sweeps
+// all of them.
+struct SendVariant {
+	// every priority with and without receipt and push, the cheapest first
+	static const size_t kMatrixCells = 12;
+
+	zim::ZIMMessagePriority priority = zim::ZIMMessagePriority::ZIM_MESSAGE_PRIORITY_LOW;
+	bool receipt = false;
+	bool push = false;
+
+	static SendVariant matrixCell(size_t index);
+
+	// "high/receipt/push", "-" for an option that is off
+	std::string name() const;
+	// Sets the options of this variant in `config`, `push_config` is sent along when push is on and
+	// has to outlive the sends.
+	void apply(zim::ZIMMessageSendConfig &config, zim::ZIMPushConfig *push_config) const;
+};
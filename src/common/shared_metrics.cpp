@@ -0,0 +1,320 @@
+#include "shared_metrics.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if ATOMIC_LLONG_LOCK_FREE != 2 || ATOMIC_INT_LOCK_FREE != 2 || ATOMIC_CHAR_LOCK_FREE != 2
+#error "MetricsRegion needs lock-free atomics to share them between processes"
+#endif
+
+static_assert(sizeof(MetricsRegion) % alignof(WorkerMetrics) == 0, "WorkerMetrics array would be misaligned");
+
+const size_t MetricsRegion::kSendVariants;
+
+MetricsRegion *MetricsRegion::create(size_t workers)
+{
+	size_t size = sizeof(MetricsRegion) + workers * sizeof(WorkerMetrics);
+	void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		return nullptr;
+	}
+	return new (memory) MetricsRegion(workers, size);
+}
+
+void MetricsRegion::release(MetricsRegion *region)
+{
+	if (!region) {
+		return;
+	}
+	size_t size = region->mapped_size_;
+	region->~MetricsRegion();
+	munmap(region, size);
+}
+
+MetricsRegion::MetricsRegion(size_t workers, size_t mapped_size) : worker_count_(workers), mapped_size_(mapped_size)
+{
+	for (size_t i = 0; i < workers; ++i) {
+		WorkerMetrics *slot = new (&this->workers()[i]) WorkerMetrics;
+		slot->state.store(static_cast<int>(WorkerState::Starting), std::memory_order_relaxed);
+		slot->sent.store(0, std::memory_order_relaxed);
+		slot->acked.store(0, std::memory_order_relaxed);
+		slot->failed.store(0, std::memory_order_relaxed);
+		slot->timeouts.store(0, std::memory_order_relaxed);
+		slot->late_callbacks.store(0, std::memory_order_relaxed);
+		slot->received.store(0, std::memory_order_relaxed);
+		slot->duplicates.store(0, std::memory_order_relaxed);
+		slot->reordered.store(0, std::memory_order_relaxed);
+		slot->missing.store(0, std::memory_order_relaxed);
+		slot->sent_before_join.store(0, std::memory_order_relaxed);
+		slot->groups_ready.store(0, std::memory_order_relaxed);
+		slot->groups_failed.store(0, std::memory_order_relaxed);
+		slot->logins.store(0, std::memory_order_relaxed);
+		slot->logins_failed.store(0, std::memory_order_relaxed);
+		slot->receipts_read.store(0, std::memory_order_relaxed);
+		slot->receipts.store(0, std::memory_order_relaxed);
+		slot->receipts_unmatched.store(0, std::memory_order_relaxed);
+		slot->uploaded_bytes.store(0, std::memory_order_relaxed);
+		slot->upload_progress.store(0, std::memory_order_relaxed);
+		slot->downloaded_bytes.store(0, std::memory_order_relaxed);
+		slot->download_progress.store(0, std::memory_order_relaxed);
+		slot->last_upload.store(0, std::memory_order_relaxed);
+		slot->last_download.store(0, std::memory_order_relaxed);
+		slot->history_messages.store(0, std::memory_order_relaxed);
+		slot->history_walks.store(0, std::memory_order_relaxed);
+		slot->first_action.store(0, std::memory_order_relaxed);
+	}
+}
+
+MetricsTotals MetricsRegion::totals()
+{
+	MetricsTotals totals;
+	for (size_t i = 0; i < worker_count_; ++i) {
+		WorkerMetrics &slot = workers()[i];
+		totals.sent += slot.sent.load(std::memory_order_relaxed);
+		totals.acked += slot.acked.load(std::memory_order_relaxed);
+		totals.failed += slot.failed.load(std::memory_order_relaxed);
+		totals.timeouts += slot.timeouts.load(std::memory_order_relaxed);
+		totals.late_callbacks += slot.late_callbacks.load(std::memory_order_relaxed);
+		totals.received += slot.received.load(std::memory_order_relaxed);
+		totals.duplicates += slot.duplicates.load(std::memory_order_relaxed);
+		totals.reordered += slot.reordered.load(std::memory_order_relaxed);
+		totals.missing += slot.missing.load(std::memory_order_relaxed);
+		totals.sent_before_join += slot.sent_before_join.load(std::memory_order_relaxed);
+		totals.groups_ready += slot.groups_ready.load(std::memory_order_relaxed);
+		totals.groups_failed += slot.groups_failed.load(std::memory_order_relaxed);
+		totals.logins += slot.logins.load(std::memory_order_relaxed);
+		totals.logins_failed += slot.logins_failed.load(std::memory_order_relaxed);
+		totals.receipts_read += slot.receipts_read.load(std::memory_order_relaxed);
+		totals.receipts += slot.receipts.load(std::memory_order_relaxed);
+		totals.receipts_unmatched += slot.receipts_unmatched.load(std::memory_order_relaxed);
+		totals.uploaded_bytes += slot.uploaded_bytes.load(std::memory_order_relaxed);
+		totals.upload_progress += slot.upload_progress.load(std::memory_order_relaxed);
+		totals.downloaded_bytes += slot.downloaded_bytes.load(std::memory_order_relaxed);
+		totals.download_progress += slot.download_progress.load(std::memory_order_relaxed);
+		totals.last_upload = std::max(totals.last_upload, slot.last_upload.load(std::memory_order_relaxed));
+		totals.last_download =
+			std::max(totals.last_download, slot.last_download.load(std::memory_order_relaxed));
+		totals.history_messages += slot.history_messages.load(std::memory_order_relaxed);
+		totals.history_walks += slot.history_walks.load(std::memory_order_relaxed);
+		uint64_t first_action = slot.first_action.load(std::memory_order_relaxed);
+		if (first_action != 0 && (totals.first_action == 0 || first_action < totals.first_action)) {
+			totals.first_action = first_action;
+		}
+		switch (static_cast<WorkerState>(slot.state.load(std::memory_order_relaxed))) {
+		case WorkerState::Starting:
+			++totals.starting;
+			break;
+		case WorkerState::LoggedIn:
+			++totals.logged_in;
+			break;
+		case WorkerState::LoginFailed:
+			++totals.login_failed;
+			break;
+		case WorkerState::Finished:
+			++totals.finished;
+			break;
+		}
+	}
+	return totals;
+}
+
+ErrorCounts::ErrorCounts()
+{
+	for (auto &slot : slots_) {
+		slot.code.store(0, std::memory_order_relaxed);
+		slot.count.store(0, std::memory_order_relaxed);
+	}
+	overflow_.store(0, std::memory_order_relaxed);
+}
+
+void ErrorCounts::record(int code)
+{
+	if (code != 0) {
+		size_t index = static_cast<unsigned int>(code) % kSlots;
+		for (size_t probe = 0; probe < kSlots; ++probe) {
+			Slot &slot = slots_[(index + probe) % kSlots];
+			int current = slot.code.load(std::memory_order_acquire);
+			if (current == 0 && slot.code.compare_exchange_strong(current, code, std::memory_order_acq_rel)) {
+				current = code;
+			}
+			if (current == code) {
+				slot.count.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+	}
+	overflow_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<int, uint64_t>> ErrorCounts::snapshot() const
+{
+	std::vector<std::pair<int, uint64_t>> counts;
+	for (const auto &slot : slots_) {
+		int code = slot.code.load(std::memory_order_acquire);
+		uint64_t count = slot.count.load(std::memory_order_relaxed);
+		if (code != 0 && count > 0) {
+			counts.emplace_back(code, count);
+		}
+	}
+	uint64_t overflow = overflow_.load(std::memory_order_relaxed);
+	if (overflow > 0) {
+		counts.emplace_back(0, overflow);
+	}
+	std::sort(counts.begin(), counts.end());
+	return counts;
+}
+
+ConnectionChanges::ConnectionChanges()
+{
+	for (auto &state : counts_) {
+		for (auto &count : state) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void ConnectionChanges::record(int state, int event)
+{
+	if (state < 0 || size_t(state) >= kStates) {
+		return;
+	}
+	size_t index = event < 0 || size_t(event) >= kEvents - 1 ? kEvents - 1 : size_t(event);
+	counts_[state][index].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ConnectionChanges::count(size_t state, size_t event) const
+{
+	return counts_[state][event].load(std::memory_order_relaxed);
+}
+
+const char *ConnectionChanges::stateName(size_t state)
+{
+	static const char *const names[kStates] = {"disconnected", "connecting", "connected", "reconnecting"};
+	return state < kStates ? names[state] : "unknown";
+}
+
+const char *ConnectionChanges::eventName(size_t event)
+{
+	static const char *const names[kEvents] = {
+		"success", "active_login", "login_timeout", "login_interrupted",
+		"kicked_out", "token_expired", "unregistered", "other",
+	};
+	return event < kEvents ? names[event] : "other";
+}
+
+const size_t RateControl::kMaxProfile;
+
+RateControl::RateControl()
+{
+	sequence_.store(0, std::memory_order_relaxed);
+	qps_bits_.store(0, std::memory_order_relaxed);
+	profile_start_.store(0, std::memory_order_relaxed);
+	paused_.store(0, std::memory_order_relaxed);
+	for (auto &c : profile_) {
+		c.store('\0', std::memory_order_relaxed);
+	}
+}
+
+void RateControl::store(const Settings &settings)
+{
+	sequence_.fetch_add(1, std::memory_order_acq_rel);
+	std::atomic_thread_fence(std::memory_order_release);
+	uint64_t bits;
+	std::memcpy(&bits, &settings.qps, sizeof(bits));
+	qps_bits_.store(bits, std::memory_order_relaxed);
+	profile_start_.store(settings.profile_start, std::memory_order_relaxed);
+	paused_.store(settings.paused ? 1 : 0, std::memory_order_relaxed);
+	size_t length = std::min(settings.profile.size(), kMaxProfile - 1);
+	for (size_t i = 0; i < kMaxProfile; ++i) {
+		profile_[i].store(i < length ? settings.profile[i] : '\0', std::memory_order_relaxed);
+	}
+	sequence_.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t RateControl::load(Settings &settings) const
+{
+	for (;;) {
+		uint64_t before = sequence_.load(std::memory_order_acquire);
+		if (before % 2 != 0) {
+			continue;
+		}
+		uint64_t bits = qps_bits_.load(std::memory_order_relaxed);
+		std::memcpy(&settings.qps, &bits, sizeof(bits));
+		settings.profile_start = profile_start_.load(std::memory_order_relaxed);
+		settings.paused = paused_.load(std::memory_order_relaxed) != 0;
+		settings.profile.clear();
+		for (size_t i = 0; i < kMaxProfile; ++i) {
+			char c = profile_[i].load(std::memory_order_relaxed);
+			if (c == '\0') {
+				break;
+			}
+			settings.profile.push_back(c);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence_.load(std::memory_order_relaxed) == before) {
+			return before;
+		}
+	}
+}
+
+uint64_t inFlight(uint64_t sent, uint64_t acked, uint64_t failed, uint64_t timeouts, uint64_t late_callbacks)
+{
+	uint64_t done = acked + failed + timeouts;
+	done = done > late_callbacks ? done - late_callbacks : 0;
+	return sent > done ? sent - done : 0;
+}
+
+uint64_t inFlight(const MetricsTotals &totals)
+{
+	return inFlight(totals.sent, totals.acked, totals.failed, totals.timeouts, totals.late_callbacks);
+}
+
+uint64_t inFlight(const WorkerMetrics &slot)
+{
+	// the outcomes before the sends, so a send that completes in between is not counted as done and not sent
+	uint64_t late_callbacks = slot.late_callbacks.load(std::memory_order_relaxed);
+	uint64_t acked = slot.acked.load(std::memory_order_relaxed);
+	uint64_t failed = slot.failed.load(std::memory_order_relaxed);
+	uint64_t timeouts = slot.timeouts.load(std::memory_order_relaxed);
+	return inFlight(slot.sent.load(std::memory_order_relaxed), acked, failed, timeouts, late_callbacks);
+}
+
+const char *operationName(Operation operation)
+{
+	switch (operation) {
+	case Operation::QueryHistory:
+		return "history";
+	case Operation::QueryConversations:
+		return "conversations";
+	case Operation::ReceiptsRead:
+		return "receipts_read";
+	case Operation::DownloadMedia:
+		return "download_media";
+	case Operation::HistoryServer:
+		return "history_server";
+	case Operation::HistoryCache:
+		return "history_cache";
+	case Operation::HistoryFailed:
+		return "history_failed";
+	case Operation::Count:
+		break;
+	}
+	return "unknown";
+}
+
+OperationMetrics::OperationMetrics()
+{
+	issued.store(0, std::memory_order_relaxed);
+	succeeded.store(0, std::memory_order_relaxed);
+	failed.store(0, std::memory_order_relaxed);
+}
+
+VariantMetrics::VariantMetrics()
+{
+	sent.store(0, std::memory_order_relaxed);
+	acked.store(0, std::memory_order_relaxed);
+	failed.store(0, std::memory_order_relaxed);
+}
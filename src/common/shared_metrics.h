@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.h"
+
+enum class WorkerState : int {
+	Starting = 0,
+	LoggedIn,
+	LoginFailed,
+	Finished,
+};
+
+// Counters of a single simulated user.
+struct WorkerMetrics {
+	std::atomic<int> state;
+	std::atomic<uint64_t> sent;
+	std::atomic<uint64_t> acked;
+	std::atomic<uint64_t> failed;
+	// sends without a callback within --callback-timeout, and callbacks that came after it
+	std::atomic<uint64_t> timeouts;
+	std::atomic<uint64_t> late_callbacks;
+	// receiving side, see DeliveryTracker
+	std::atomic<uint64_t> received;
+	std::atomic<uint64_t> duplicates;
+	std::atomic<uint64_t> reordered;
+	std::atomic<uint64_t> missing;
+	// --conversation room: what all workers had sent when this one entered the room, it cannot get those
+	std::atomic<uint64_t> sent_before_join;
+	// --conversation group, groups of this user that are complete or failed to be set up
+	std::atomic<uint64_t> groups_ready;
+	std::atomic<uint64_t> groups_failed;
+	// login calls and those whose callback reported an error, see --role login
+	std::atomic<uint64_t> logins;
+	std::atomic<uint64_t> logins_failed;
+	// messages a receiver marked read with sendMessageReceiptsRead, see --read-receipts
+	std::atomic<uint64_t> receipts_read;
+	// receipts a sender got for its messages, and those for messages it does not know (any more)
+	std::atomic<uint64_t> receipts;
+	std::atomic<uint64_t> receipts_unmatched;
+	// --media: file bytes of the acked sends and progress callbacks of the uploads, and with --download-media
+	// file bytes and progress callbacks of the finished downloads
+	std::atomic<uint64_t> uploaded_bytes;
+	std::atomic<uint64_t> upload_progress;
+	std::atomic<uint64_t> downloaded_bytes;
+	std::atomic<uint64_t> download_progress;
+	// unix us the last of those uploads and downloads finished
+	std::atomic<uint64_t> last_upload;
+	std::atomic<uint64_t> last_download;
+	// --history-walkers: messages on the pages queried and walks that reached the end of the conversation
+	std::atomic<uint64_t> history_messages;
+	std::atomic<uint64_t> history_walks;
+	// unix us of the first send, query or login after the start, 0 before it
+	std::atomic<uint64_t> first_action;
+};
+
+// Sum of all WorkerMetrics at one point in time.
+struct MetricsTotals {
+	uint64_t sent = 0;
+	uint64_t acked = 0;
+	uint64_t failed = 0;
+	uint64_t timeouts = 0;
+	uint64_t late_callbacks = 0;
+	uint64_t received = 0;
+	uint64_t duplicates = 0;
+	uint64_t reordered = 0;
+	uint64_t missing = 0;
+	uint64_t sent_before_join = 0;
+	uint64_t groups_ready = 0;
+	uint64_t groups_failed = 0;
+	uint64_t logins = 0;
+	uint64_t logins_failed = 0;
+	uint64_t receipts_read = 0;
+	uint64_t receipts = 0;
+	uint64_t receipts_unmatched = 0;
+	uint64_t uploaded_bytes = 0;
+	uint64_t upload_progress = 0;
+	uint64_t downloaded_bytes = 0;
+	uint64_t download_progress = 0;
+	// the latest of the workers
+	uint64_t last_upload = 0;
+	uint64_t last_download = 0;
+	uint64_t history_messages = 0;
+	uint64_t history_walks = 0;
+	// the earliest of the workers, 0 if none of them did anything yet
+	uint64_t first_action = 0;
+	size_t starting = 0;
+	size_t logged_in = 0;
+	size_t login_failed = 0;
+	size_t finished = 0;
+};
+
+// Sends that were neither called back nor timed out. A late callback was counted as acked or failed after its
+// timeout, so it is taken off once; the counters move while they are read, so it never goes below 0.
+uint64_t inFlight(uint64_t sent, uint64_t acked, uint64_t failed, uint64_t timeouts, uint64_t late_callbacks);
+uint64_t inFlight(const MetricsTotals &totals);
+uint64_t inFlight(const WorkerMetrics &slot);
+
+// Failure counts by error code. Slots are claimed with a compare-exchange on the code, so workers add
+// codes they have not seen before without a lock.
+class ErrorCounts {
+public:
+	static const size_t kSlots = 64;
+
+	ErrorCounts();
+
+	// codes beyond the first kSlots distinct ones are counted under code 0
+	void record(int code);
+	// (code, count) of every code recorded so far, sorted by code
+	std::vector<std::pair<int, uint64_t>> snapshot() const;
+
+private:
+	struct Slot {
+		std::atomic<int> code;
+		std::atomic<uint64_t> count;
+	};
+
+	Slot slots_[kSlots];
+	std::atomic<uint64_t> overflow_;
+};
+
+// API calls other than sendMessage and login, issued by --workload, the sendMessageReceiptsRead calls
+// of --read-receipts, the downloadMediaFile calls of --download-media and the queryHistoryMessage pages of
+// --history-walkers. Those are told apart by where the page could come from once it is there, so they
+// count as issued when their callback comes, failed pages on their own.
+enum class Operation : int {
+	QueryHistory = 0,
+	QueryConversations,
+	ReceiptsRead,
+	DownloadMedia,
+	HistoryServer,
+	HistoryCache,
+	HistoryFailed,
+	Count,
+};
+
+const char *operationName(Operation operation);
+
+// Calls of one Operation.
+struct OperationMetrics {
+	OperationMetrics();
+
+	std::atomic<uint64_t> issued;
+	std::atomic<uint64_t> succeeded;
+	std::atomic<uint64_t> failed;
+	// call -> callback
+	LatencyHistogram latency;
+};
+
+// Sends of one ZIMMessageSendConfig variant of --matrix, counted by the variant they were sent with
+// rather than by when their callback came.
+struct VariantMetrics {
+	VariantMetrics();
+
+	std::atomic<uint64_t> sent;
+	std::atomic<uint64_t> acked;
+	std::atomic<uint64_t> failed;
+	LatencyHistogram service;
+	LatencyHistogram response;
+};
+
+// onConnectionStateChanged calls by the state entered and the event that caused it.
+class ConnectionChanges {
+public:
+	// ZIMConnectionState and ZIMConnectionEvent, events the SDK adds later are counted as "other"
+	static const size_t kStates = 4;
+	static const size_t kEvents = 8;
+
+	ConnectionChanges();
+
+	void record(int state, int event);
+	uint64_t count(size_t state, size_t event) const;
+
+	static const char *stateName(size_t state);
+	static const char *eventName(size_t event);
+
+private:
+	std::atomic<uint64_t> counts_[kStates][kEvents];
+};
+
+// The target load, changed at run time through --control-socket or SIGHUP by the parent (or a single
+// process) and followed by every worker. A seqlock: one writer, readers retry while a change is being
+// written.
+class RateControl {
+public:
+	static const size_t kMaxProfile = 128;
+
+	struct Settings {
+		// total qps of all senders when there is no profile
+		double qps = 0;
+		// --profile spec, empty for a constant qps
+		std::string profile;
+		// unix us the profile starts at
+		uint64_t profile_start = 0;
+		bool paused = false;
+	};
+
+	RateControl();
+
+	// profiles longer than kMaxProfile - 1 are cut off, the caller checks
+	void store(const Settings &settings);
+	// returns the version of what it read, it changes with every store()
+	uint64_t load(Settings &settings) const;
+	uint64_t version() const { return sequence_.load(std::memory_order_acquire); }
+
+private:
+	// odd while store() is writing
+	std::atomic<uint64_t> sequence_;
+	std::atomic<uint64_t> qps_bits_;
+	std::atomic<uint64_t> profile_start_;
+	std::atomic<int> paused_;
+	std::atomic<char> profile_[kMaxProfile];
+};
+
+// Metrics of a whole run, placed in an anonymous MAP_SHARED mapping so that worker processes forked
+// after create() record into the same memory the parent aggregates from. Lock-free std::atomic
+// objects are address-free, which is what makes sharing them between processes safe.
+class MetricsRegion {
+public:
+	// cells of --matrix
+	static const size_t kSendVariants = 12;
+
+	static MetricsRegion *create(size_t workers);
+	static void release(MetricsRegion *region);
+
+	// dispatch -> callback
+	LatencyHistogram &serviceLatency() { return service_latency_; }
+	// scheduled send time -> callback, includes the time a send spent waiting behind a slow one
+	LatencyHistogram &responseLatency() { return response_latency_; }
+	// send time stamped into the message -> receive event on the receiver, across machines only as
+	// good as their clock synchronisation
+	LatencyHistogram &deliveryLatency() { return delivery_latency_; }
+	// createGroup -> the last inviteUsersIntoGroup of the group completed
+	LatencyHistogram &provisionLatency() { return provision_latency_; }
+	// login -> logged in callback, failed logins included
+	LatencyHistogram &loginLatency() { return login_latency_; }
+	// dispatch of a message sent with hasReceipt -> onMessageReceiptChanged of a reader at the sender
+	LatencyHistogram &receiptLatency() { return receipt_latency_; }
+	// dispatch of a media message, or its previous uploading progress callback -> the next one
+	LatencyHistogram &uploadProgressGap() { return upload_progress_gap_; }
+	// downloadMediaFile, or its previous downloading progress callback -> the next one
+	LatencyHistogram &downloadProgressGap() { return download_progress_gap_; }
+
+	// failed sends by ZIMErrorCode
+	ErrorCounts &errors() { return errors_; }
+	// failed logins by ZIMErrorCode
+	ErrorCounts &loginErrors() { return login_errors_; }
+	ConnectionChanges &connectionChanges() { return connection_changes_; }
+	OperationMetrics &operation(Operation operation) { return operations_[static_cast<size_t>(operation)]; }
+	// failed operations of every kind by ZIMErrorCode
+	ErrorCounts &operationErrors() { return operation_errors_; }
+	RateControl &control() { return control_; }
+	VariantMetrics &variant(size_t index) { return variants_[index]; }
+
+	size_t workerCount() const { return worker_count_; }
+	WorkerMetrics &worker(size_t index) { return workers()[index]; }
+	MetricsTotals totals();
+
+private:
+	MetricsRegion(size_t workers, size_t mapped_size);
+	MetricsRegion(const MetricsRegion &) = delete;
+	MetricsRegion &operator=(const MetricsRegion &) = delete;
+
+	// the WorkerMetrics array is laid out right behind the region object
+	WorkerMetrics *workers() { return reinterpret_cast<WorkerMetrics *>(this + 1); }
+
+	LatencyHistogram service_latency_;
+	LatencyHistogram response_latency_;
+	LatencyHistogram delivery_latency_;
+	LatencyHistogram provision_latency_;
+	LatencyHistogram login_latency_;
+	LatencyHistogram receipt_latency_;
+	LatencyHistogram upload_progress_gap_;
+	LatencyHistogram download_progress_gap_;
+	ErrorCounts errors_;
+	ErrorCounts login_errors_;
+	ConnectionChanges connection_changes_;
+	OperationMetrics operations_[static_cast<size_t>(Operation::Count)];
+	ErrorCounts operation_errors_;
+	RateControl control_;
+	VariantMetrics variants_[kSendVariants];
+	const size_t worker_count_;
+	const size_t mapped_size_;
+};
@@ -0,0 +1,409 @@
+#include "worker.h"
+
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+
+#include "event_handler.h"
+#include "group_session.h"
+#include "history_walker.h"
+#include "login_storm.h"
+#include "media_transfer.h"
+#include "message_sender.h"
+#include "read_receipts.h"
+#include "room_session.h"
+#include "workload_runner.h"
+
+namespace {
+
+volatile std::sig_atomic_t stop_signal = 0;
+
+void onStopSignal(int /*sig*/)
+{
+	stop_signal = 1;
+}
+
+} // namespace
+
+void catchStopSignals()
+{
+	std::signal(SIGINT, onStopSignal);
+	std::signal(SIGTERM, onStopSignal);
+}
+
+bool stopSignalled()
+{
+	return stop_signal != 0;
+}
+
+std::chrono::steady_clock::time_point steadyAt(uint64_t micros)
+{
+	return std::chrono::steady_clock::now() + std::chrono::microseconds(int64_t(micros - unixMicros()));
+}
+
+Worker::Worker(const Options &options, MetricsRegion *metrics, WorkerMetrics &slot)
+	: options_(options), metrics_(metrics), slot_(slot),
+	  user_(options.role == "receiver" ? options.receiver : options.sender),
+	  room_member_(options.conversation == "room" || options.workload.uses(WorkloadOp::Room))
+{
+	if (options_.receiving) {
+		tracker_.reset(new DeliveryTracker(slot_));
+	}
+	if (options_.sending) {
+		sender_.reset(new MessageSender(*this));
+	}
+	if (room_member_) {
+		room_.reset(new RoomSession(*this));
+	}
+	if (options_.sending && options_.conversation == "group") {
+		groups_.reset(new GroupSession(*this));
+	}
+	if (options_.role == "login") {
+		login_storm_.reset(new LoginStorm(*this));
+	}
+	if (options_.sending && !options_.workload.phases().empty()) {
+		workload_.reset(new WorkloadRunner(*this));
+	}
+	if (options_.sending && options_.history_walkers > 0) {
+		history_.reset(new HistoryWalker(*this));
+	}
+	if ((options_.receiving && options_.read_receipts > 0) || (options_.sending && options_.timing_receipts)) {
+		receipts_.reset(new ReadReceipts(*this));
+	}
+	if ((options_.sending && !options_.media_spec.empty()) || (options_.receiving && options_.download_media > 0)) {
+		media_.reset(new MediaTransfer(*this));
+	}
+}
+
+// the scenarios go after the instance, whose callbacks use them
+Worker::~Worker()
+{
+	shutdown();
+}
+
+int Worker::run(const std::function<void()> &poll)
+{
+	setUp();
+	if (sender_ && !sender_->prepare()) {
+		return 1;
+	}
+
+	// create zim
+	if (options_.verbose) {
+		std::cout << "Create ZIM..." << std::endl;
+	}
+	zim::ZIMAppConfig app_config;
+	app_config.appID = options_.appid;
+	app_config.appSign = options_.appsign;
+	zim_ = zim::ZIM::create(app_config);
+
+	if (receipts_) {
+		receipts_->start();
+	}
+	zim_->setEventHandler(std::make_shared<EventHandler>(*this));
+	if (sender_) {
+		sender_->start();
+	}
+	if (groups_) {
+		groups_->start();
+	}
+
+	// login
+	if (options_.verbose) {
+		std::cout << "Login ZIM..." << std::endl;
+		std::cout << "waiting for login success" << std::endl;
+	}
+	login([this](const zim::ZIMError &errorInfo) { loggedIn(errorInfo); });
+
+	catchStopSignals();
+	// with --start-at every host stops at the same moment, however long its login took
+	auto end = (options_.start_at != 0 ? steadyAt(options_.load_start) : std::chrono::steady_clock::now()) +
+		   std::chrono::seconds(options_.execution_time);
+	while (!stopSignalled() && std::chrono::steady_clock::now() < end) {
+		if (poll) {
+			poll();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+
+	// stop issuing, then wait for what is in flight
+	stopped_ = true;
+	auto stopped = Clock::now();
+	finish();
+	printSummary(stopped);
+	return 0;
+}
+
+// the verbose header of the run and the log and cache paths of the user
+void Worker::setUp()
+{
+	std::string logpath = options_.logpath + "/" + user_;
+	std::string cachePath = "/root/ZIMCaches/" + user_;
+	bool sending = options_.sending;
+
+	if (options_.verbose) {
+		std::cout << "role: " << options_.role << std::endl;
+		if (options_.role == "sender") {
+			std::cout << "sender: " << options_.sender << std::endl;
+		}
+		if (!options_.workload.phases().empty()) {
+			std::cout << "workload: " << options_.workload.phases().size() << " phases" << std::endl;
+		}
+		if (room_member_) {
+			std::cout << "room: " << options_.room_id << std::endl;
+		} else if (options_.conversation == "group") {
+			std::cout << "groups: " << (groups_ ? groups_->owned() : 0)
+				  << ", group_size: " << options_.group_size << std::endl;
+		} else {
+			std::cout << "receiver: " << options_.receiver << std::endl;
+		}
+		if (sending && options_.concurrency > 0) {
+			std::cout << "concurrency: " << options_.concurrency << std::endl;
+		} else if (sending && !options_.profile_spec.empty()) {
+			std::cout << "profile: " << options_.profile_spec << std::endl;
+			std::cout << "pacing: " << options_.pacing << std::endl;
+		} else if (sending && options_.workload.phases().empty()) {
+			std::cout << "qps: " << options_.rate << std::endl;
+			std::cout << "pacing: " << options_.pacing << std::endl;
+		}
+		if (sending && (options_.message_type != "text" || options_.batch > 1)) {
+			std::cout << "message_type: " << options_.message_type << ", batch: " << options_.batch
+				  << std::endl;
+		}
+		if (sending && !options_.media_spec.empty()) {
+			std::cout << "media: " << options_.media_spec << ", media_dir: " << options_.media_dir
+				  << std::endl;
+		}
+		if (sending && options_.history_walkers > 0) {
+			std::cout << "history_walkers: " << options_.history_walkers
+				  << ", history_seed: " << options_.history_seed
+				  << ", page_size: " << options_.page_size
+				  << ", history_reverse: " << options_.history_reverse << std::endl;
+		}
+		if (sending && options_.matrix > 0) {
+			std::cout << "matrix: " << SendVariant::kMatrixCells << " cells of " << options_.matrix << "s"
+				  << std::endl;
+		} else if (sending) {
+			std::cout << "send_config: " << options_.send_variant.name() << std::endl;
+		}
+		if (options_.read_receipts > 0 && options_.receiving) {
+			std::cout << "read_receipts: " << options_.read_receipts
+				  << ", receipt_delay: " << options_.receipt_delay << "ms" << std::endl;
+		}
+		std::cout << "execution_time: " << options_.execution_time << std::endl;
+		if (options_.start_at != 0) {
+			std::cout << "start_at: " << options_.start_at << std::endl;
+		}
+		std::cout << "logpath: " << logpath << std::endl;
+		std::cout << "cachepath: " << cachePath << std::endl;
+		std::cout << "logsize: " << options_.logsize << std::endl;
+		std::cout << "ZIM version: " << zim::ZIM::getVersion() << std::endl;
+	}
+
+	// log path
+	zim::ZIMLogConfig log_config;
+	if (!logpath.empty()) {
+		log_config.logPath = logpath;
+	}
+	if (options_.logsize != 0) {
+		log_config.logSize = options_.logsize;
+	}
+	zim::ZIM::setLogConfig(log_config);
+	zim::ZIMCacheConfig cache_config;
+	cache_config.cachePath = cachePath;
+	zim::ZIM::setCacheConfig(cache_config);
+}
+
+// Starts the scenario from the login callback: the login storm, the sends to the peer, or for a room or
+// group the sends once the user is in.
+void Worker::loggedIn(const zim::ZIMError &errorInfo)
+{
+	if (login_storm_) {
+		startThread([this]() { login_storm_->run(); });
+		return;
+	}
+	if (!room_ && options_.conversation == "peer") {
+		if (sender_) {
+			startThread([this]() { send(); });
+		}
+		return;
+	}
+	if (errorInfo.code != zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+		return;
+	}
+	if (!room_) {
+		// members receive without joining anything, the owners add them to their groups
+		if (groups_) {
+			startThread([this]() {
+				if (groups_->provision()) {
+					send();
+				}
+			});
+		}
+		return;
+	}
+	room_->enter([this]() {
+		if (sender_) {
+			startThread([this]() { send(); });
+		}
+	});
+}
+
+void Worker::startThread(const std::function<void()> &body)
+{
+	std::lock_guard<std::mutex> lock(thread_mutex_);
+	// finish() took the thread already, nothing may start behind its back
+	if (!stopped_) {
+		thread_ = std::thread(body);
+	}
+}
+
+void Worker::send()
+{
+	if (workload_) {
+		workload_->run();
+		return;
+	}
+	// sent to in turn, each one numbers its messages from 1
+	std::vector<std::string> targets{options_.receiver};
+	zim::ZIMConversationType type = zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER;
+	if (options_.conversation == "room") {
+		targets = {options_.room_id};
+		type = zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_ROOM;
+	} else if (options_.conversation == "group") {
+		targets = groups_->ready();
+		type = zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_GROUP;
+	}
+	if (history_) {
+		history_->run(targets, type);
+	} else {
+		sender_->loop(targets, type);
+	}
+}
+
+void Worker::finish()
+{
+	if (sender_) {
+		sender_->stop();
+	}
+	if (groups_) {
+		groups_->stop();
+	}
+	std::thread thread;
+	{
+		std::lock_guard<std::mutex> lock(thread_mutex_);
+		thread.swap(thread_);
+	}
+	if (thread.joinable()) {
+		thread.join();
+	}
+	if (receipts_) {
+		receipts_->finish();
+	}
+	if (media_) {
+		media_->finish();
+	}
+	if (history_) {
+		history_->finish();
+	}
+	if (workload_) {
+		workload_->finish();
+	}
+	if (sender_) {
+		sender_->finish();
+	}
+	if (groups_) {
+		groups_->dismiss();
+	}
+	if (room_) {
+		room_->leave();
+	}
+	// a failed login stays visible in the final totals
+	int logged_in = static_cast<int>(WorkerState::LoggedIn);
+	slot_.state.compare_exchange_strong(logged_in, static_cast<int>(WorkerState::Finished));
+}
+
+void Worker::printSummary(Clock::time_point stopped)
+{
+	if (!options_.verbose) {
+		return;
+	}
+	if (tracker_) {
+		std::cout << "received: " << slot_.received << " from " << tracker_->senderCount() << " senders"
+			  << std::endl;
+		for (const auto &summary : tracker_->worst(10)) {
+			std::cout << "[delivery] " << summary.user_id << " received: " << summary.received
+				  << ", missing: " << summary.missing << ", duplicates: " << summary.duplicates
+				  << ", reordered: " << summary.reordered << std::endl;
+		}
+	}
+	if (sender_) {
+		sender_->printSummary(stopped);
+	}
+}
+
+void Worker::shutdown()
+{
+	if (!zim_) {
+		return;
+	}
+	zim_->logout();
+	zim_->destroy();
+	zim_ = nullptr;
+}
+
+void Worker::login(const std::function<void(const zim::ZIMError &)> &done)
+{
+	zim::ZIMUserInfo userInfo;
+	userInfo.userID = user_;
+	userInfo.userName = user_;
+	++slot_.logins;
+	auto started = Clock::now();
+	zim_->login(userInfo, [this, started, done](const zim::ZIMError &errorInfo) {
+		metrics_->loginLatency().record(Clock::now() - started);
+		bool logged_in = errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS;
+		if (!logged_in) {
+			++slot_.logins_failed;
+			metrics_->loginErrors().record(static_cast<int>(errorInfo.code));
+		}
+		if (options_.verbose || !logged_in) {
+			std::cout << "[callback][ZIMLoggedInCallback] " << user_ << " code:" << errorInfo.code
+				  << ",message:" << errorInfo.message << std::endl;
+		}
+		slot_.state = static_cast<int>(logged_in ? WorkerState::LoggedIn : WorkerState::LoginFailed);
+		done(errorInfo);
+	});
+}
+
+bool Worker::waitStart() const
+{
+	uint64_t start = options_.load_start;
+	for (uint64_t now = unixMicros(); !stopped_ && now < start; now = unixMicros()) {
+		std::this_thread::sleep_for(std::chrono::microseconds(std::min<uint64_t>(50000, start - now)));
+	}
+	return !stopped_;
+}
+
+void Worker::markAction()
+{
+	if (slot_.first_action.load(std::memory_order_relaxed) == 0) {
+		uint64_t none = 0;
+		slot_.first_action.compare_exchange_strong(none, unixMicros());
+	}
+}
+
+void Worker::recordOperation(Operation operation, Clock::time_point started, const zim::ZIMError &errorInfo)
+{
+	OperationMetrics &metrics = metrics_->operation(operation);
+	metrics.latency.record(Clock::now() - started);
+	if (errorInfo.code == zim::ZIMErrorCode::ZIM_ERROR_CODE_SUCCESS) {
+		++metrics.succeeded;
+	} else {
+		++metrics.failed;
+		metrics_->operationErrors().record(static_cast<int>(errorInfo.code));
+	}
+	if (options_.debug != 0) {
+		std::cout << "[callback][" << operationName(operation) << "] code:" << errorInfo.code
+			  << ",message:" << errorInfo.message << std::endl;
+	}
+}
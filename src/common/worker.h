@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ZIM.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "delivery_tracker.h"
+#include "options.h"
+#include "rate_scheduler.h"
+#include "shared_metrics.h"
+
+class GroupSession;
+class HistoryWalker;
+class LoginStorm;
+class MediaTransfer;
+class MessageSender;
+class ReadReceipts;
+class RoomSession;
+class WorkloadRunner;
+
+// SIGINT and SIGTERM end the run early the same way --execution-time does
+void catchStopSignals();
+bool stopSignalled();
+
+// the steady_clock time of a unix time in us, to wait for wall clock moments shared with other hosts
+std::chrono::steady_clock::time_point steadyAt(uint64_t micros);
+
+// One user of the run, a worker of --users or a single process: logs in, enters the room or creates the
+// groups, runs the scenario of its options until --execution-time and waits for what is still in flight.
+// The scenarios share the instance, the metrics and the end of the run through it.
+class Worker {
+public:
+	typedef RateScheduler::Clock Clock;
+
+	// counts into `slot` of `metrics`
+	Worker(const Options &options, MetricsRegion *metrics, WorkerMetrics &slot);
+	~Worker();
+
+	// Returns the exit code. A single process is its own parent, `poll` does its rounds every 50ms until
+	// the end.
+	int run(const std::function<void()> &poll);
+	// Logs out and destroys the instance once the metrics are out, callbacks still due are dropped.
+	void shutdown();
+
+	// Logs in and records how long it took and how it ended, `done` runs on the callback thread of the SDK.
+	void login(const std::function<void(const zim::ZIMError &)> &done);
+	// --start-at: holds the first call back until the common start, false if the run was stopped meanwhile
+	bool waitStart() const;
+	// Records the first send, query or login of this worker after the start, see Reporter::writeSummary.
+	void markAction();
+	void recordOperation(Operation operation, Clock::time_point started, const zim::ZIMError &errorInfo);
+
+	const Options &options() const { return options_; }
+	const std::string &user() const { return user_; }
+	zim::ZIM *zim() const { return zim_; }
+	MetricsRegion &metrics() const { return *metrics_; }
+	WorkerMetrics &slot() const { return slot_; }
+	bool stopped() const { return stopped_; }
+
+	// the scenarios of the options, null if they are not part of it
+	MessageSender *sender() const { return sender_.get(); }
+	ReadReceipts *receipts() const { return receipts_.get(); }
+	MediaTransfer *media() const { return media_.get(); }
+	HistoryWalker *history() const { return history_.get(); }
+	DeliveryTracker *tracker() const { return tracker_.get(); }
+
+private:
+	void setUp();
+	void loggedIn(const zim::ZIMError &errorInfo);
+	// Runs `body` on thread_, from the callback thread of the SDK. Not once the run is stopped, finish()
+	// joins the thread then.
+	void startThread(const std::function<void()> &body);
+	// the scenario of a sender once it is logged in and in its room or groups
+	void send();
+	// waits for what is in flight and leaves the room and the groups
+	void finish();
+	void printSummary(Clock::time_point stopped);
+
+	const Options &options_;
+	MetricsRegion *const metrics_;
+	WorkerMetrics &slot_;
+	const std::string user_;
+	// the user is in the room of --conversation room or of the room calls of a --workload
+	const bool room_member_;
+	zim::ZIM *zim_ = nullptr;
+	std::atomic<bool> stopped_{false};
+	// login storm, scenario of a sender or group provisioning followed by it
+	std::mutex thread_mutex_;
+	std::thread thread_;
+
+	std::unique_ptr<DeliveryTracker> tracker_;
+	std::unique_ptr<MessageSender> sender_;
+	std::unique_ptr<RoomSession> room_;
+	std::unique_ptr<GroupSession> groups_;
+	std::unique_ptr<LoginStorm> login_storm_;
+	std::unique_ptr<WorkloadRunner> workload_;
+	std::unique_ptr<HistoryWalker> history_;
+	std::unique_ptr<ReadReceipts> receipts_;
+	std::unique_ptr<MediaTransfer> media_;
+};
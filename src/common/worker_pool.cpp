@@ -0,0 +1,128 @@
+#include "worker_pool.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+WorkerPool::WorkerPool(size_t workers, double spawn_rate, WorkerMain worker_main)
+	: workers_(workers), spawn_rate_(spawn_rate), worker_main_(std::move(worker_main)), pids_(workers, 0)
+{
+}
+
+bool WorkerPool::spawn(size_t index)
+{
+	std::cout.flush();
+	pid_t pid = fork();
+	if (pid < 0) {
+		std::cout << "[workers] fork failed for worker " << index << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+	if (pid == 0) {
+		int code = worker_main_(index);
+		std::cout.flush();
+		// skip the parent's atexit handlers and static destructors, they belong to the parent
+		_exit(code);
+	}
+	pids_[index] = pid;
+	++alive_;
+	return true;
+}
+
+void WorkerPool::reap()
+{
+	int status = 0;
+	pid_t pid;
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+		auto it = std::find(pids_.begin(), pids_.end(), pid);
+		if (it == pids_.end()) {
+			continue;
+		}
+		*it = 0;
+		--alive_;
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			++abnormal_;
+			std::cout << "[workers] worker " << (it - pids_.begin()) << " (pid " << pid << ") "
+				  << (WIFSIGNALED(status) ? "killed by signal " : "exited with code ")
+				  << (WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status)) << std::endl;
+		}
+	}
+}
+
+void WorkerPool::signalAll(int sig)
+{
+	for (pid_t pid : pids_) {
+		if (pid > 0) {
+			kill(pid, sig);
+		}
+	}
+}
+
+void WorkerPool::stop()
+{
+	if (!stopping_) {
+		stopping_ = true;
+		signalAll(SIGTERM);
+	}
+}
+
+size_t WorkerPool::run(std::chrono::seconds timeout, int report_interval, std::function<void()> on_report,
+		       std::function<void()> on_tick)
+{
+	typedef std::chrono::steady_clock Clock;
+	const auto start = Clock::now();
+	const auto tick = std::chrono::milliseconds(50);
+	auto next_report = start + std::chrono::seconds(report_interval);
+	auto kill_at = Clock::time_point::max();
+	// workers drain after SIGTERM, SIGKILL is for those stuck in the SDK
+	int kill_signal = SIGTERM;
+
+	while ((!stopping_ && spawned_ < workers_) || alive_ > 0) {
+		auto now = Clock::now();
+
+		// spawn slot i is due at start + i / spawn_rate
+		while (!stopping_ && spawned_ < workers_ &&
+		       now >= start + std::chrono::duration_cast<Clock::duration>(
+						      std::chrono::duration<double>(spawned_ / spawn_rate_))) {
+			if (!spawn(spawned_)) {
+				++abnormal_;
+			}
+			++spawned_;
+			if (spawned_ == workers_) {
+				kill_at = Clock::now() + timeout;
+			}
+		}
+
+		reap();
+
+		if (report_interval > 0 && now >= next_report) {
+			on_report();
+			next_report += std::chrono::seconds(report_interval);
+		}
+
+		if (stopping_ && kill_signal == SIGTERM) {
+			// stop() sent the SIGTERM already
+			kill_at = now + std::chrono::seconds(30);
+			kill_signal = SIGKILL;
+		}
+		if (now >= kill_at) {
+			std::cout << "[workers] " << alive_ << " workers still running, sending "
+				  << (kill_signal == SIGTERM ? "SIGTERM" : "SIGKILL") << std::endl;
+			signalAll(kill_signal);
+			kill_at = kill_signal == SIGTERM ? now + std::chrono::seconds(30) : Clock::time_point::max();
+			kill_signal = SIGKILL;
+		}
+
+		if (on_tick) {
+			on_tick();
+		}
+
+		std::this_thread::sleep_for(tick);
+	}
+	return abnormal_;
+}
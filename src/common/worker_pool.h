@@ -0,0 +1,46 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Forks and supervises worker processes, one simulated user each.
+// The parent stays single threaded, so forking never happens while another thread holds a lock.
+class WorkerPool {
+public:
+	// Runs in the child right after fork(); its return value becomes the child's exit code.
+	typedef std::function<int(size_t index)> WorkerMain;
+
+	WorkerPool(size_t workers, double spawn_rate, WorkerMain worker_main);
+
+	// Spawns the workers at spawn_rate per second and calls on_report every report_interval seconds
+	// (never if 0) until all of them have exited. Workers still alive `timeout` after the last spawn
+	// are sent SIGTERM, and SIGKILL 30s later. on_tick, if set, runs on every pass of the supervision
+	// loop (every 50ms).
+	// Returns the number of workers that failed to start or exited abnormally.
+	size_t run(std::chrono::seconds timeout, int report_interval, std::function<void()> on_report,
+		   std::function<void()> on_tick = nullptr);
+
+	// Spawns no more workers and sends SIGTERM to the running ones, meant to be called from on_tick.
+	void stop();
+
+	size_t spawned() const { return spawned_; }
+	size_t alive() const { return alive_; }
+
+private:
+	bool spawn(size_t index);
+	void reap();
+	void signalAll(int sig);
+
+	const size_t workers_;
+	const double spawn_rate_;
+	WorkerMain worker_main_;
+
+	std::vector<pid_t> pids_;
+	size_t spawned_ = 0;
+	size_t alive_ = 0;
+	size_t abnormal_ = 0;
+	bool stopping_ = false;
+};
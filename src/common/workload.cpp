@@ -0,0 +1,135 @@
+#include "workload.h"
+
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+const char *const kOpNames[] = {"peer", "room", "history", "conversations"};
+
+bool parseNumber(const std::string &text, double &value)
+{
+	char *end = nullptr;
+	value = std::strtod(text.c_str(), &end);
+	return !text.empty() && end == text.c_str() + text.size() && value >= 0;
+}
+
+} // namespace
+
+bool parseWorkloadOp(const std::string &name, WorkloadOp &op)
+{
+	for (size_t i = 0; i < sizeof(kOpNames) / sizeof(kOpNames[0]); ++i) {
+		if (name == kOpNames[i]) {
+			op = static_cast<WorkloadOp>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *workloadOpName(WorkloadOp op) { return kOpNames[static_cast<size_t>(op)]; }
+
+bool Workload::load(const std::string &path, std::string &error)
+{
+	std::vector<CLI::ConfigItem> items;
+	try {
+		items = CLI::ConfigTOML().from_file(path);
+	} catch (const CLI::Error &e) {
+		error = e.what();
+		return false;
+	}
+
+	phases_.clear();
+	for (const auto &item : items) {
+		// "++" and "--" mark where a section starts and ends, top-level keys are options
+		if (item.name == "++" || item.name == "--" || item.parents.empty()) {
+			continue;
+		}
+		if (item.parents.size() > 1) {
+			error = "nested section " + item.fullname();
+			return false;
+		}
+		const std::string &name = item.parents.front();
+		auto phase = std::find_if(phases_.begin(), phases_.end(),
+					  [&](const WorkloadPhase &phase) { return phase.name == name; });
+		if (phase == phases_.end()) {
+			phases_.emplace_back();
+			phase = phases_.end() - 1;
+			phase->name = name;
+		}
+
+		double value = 0;
+		if (item.inputs.size() != 1 || !parseNumber(item.inputs.front(), value)) {
+			error = item.fullname() + " is not a non-negative number";
+			return false;
+		}
+		WorkloadOp op;
+		if (item.name == "duration") {
+			phase->duration = std::chrono::seconds(static_cast<long>(value));
+		} else if (item.name == "qps") {
+			phase->qps = value;
+		} else if (parseWorkloadOp(item.name, op)) {
+			if (value > 0) {
+				phase->weights.emplace_back(op, value);
+			}
+		} else {
+			error = "unknown key " + item.fullname();
+			return false;
+		}
+	}
+
+	if (phases_.empty()) {
+		error = "no phase in " + path;
+		return false;
+	}
+	for (const auto &phase : phases_) {
+		if (phase.duration.count() <= 0 || phase.qps <= 0 || phase.weights.empty()) {
+			error = "phase " + phase.name + " needs a duration, a qps and at least one operation";
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Workload::uses(WorkloadOp op) const
+{
+	for (const auto &phase : phases_) {
+		for (const auto &weight : phase.weights) {
+			if (weight.first == op) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+std::chrono::seconds Workload::duration() const
+{
+	std::chrono::seconds total(0);
+	for (const auto &phase : phases_) {
+		total += phase.duration;
+	}
+	return total;
+}
+
+OperationMix::OperationMix(const std::vector<std::pair<WorkloadOp, double>> &weights)
+	: weights_(weights), current_(weights.size(), 0)
+{
+	for (const auto &weight : weights_) {
+		total_ += weight.second;
+	}
+}
+
+WorkloadOp OperationMix::next()
+{
+	size_t best = 0;
+	for (size_t i = 0; i < weights_.size(); ++i) {
+		current_[i] += weights_[i].second;
+		if (current_[i] > current_[best]) {
+			best = i;
+		}
+	}
+	current_[best] -= total_;
+	return weights_[best].first;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What one slot of a --workload phase does.
+enum class WorkloadOp {
+	// sendMessage to the receiver
+	Peer,
+	// sendMessage to --room-id, which every user enters after login
+	Room,
+	// queryHistoryMessage of the conversation with the receiver
+	History,
+	// queryConversationList
+	Conversations,
+};
+
+bool parseWorkloadOp(const std::string &name, WorkloadOp &op);
+const char *workloadOpName(WorkloadOp op);
+
+struct WorkloadPhase {
+	std::string name;
+	std::chrono::seconds duration{0};
+	// calls per second of all users together, like --qps
+	double qps = 0;
+	// relative shares of the calls, in file order
+	std::vector<std::pair<WorkloadOp, double>> weights;
+};
+
+// A --workload file, read with the TOML/INI parser of CLI11. Keys before the first section are
+// ordinary command line options (the file is also given to CLI11 as the config file); every section
+// is a phase, run in file order:
+//
+//     qps = 100
+//     [warmup]
+//     duration = 30
+//     qps = 50
+//     peer = 70
+//     room = 10
+//     history = 5
+//     conversations = 5
+class Workload {
+public:
+	// false with the reason in `error` if the file cannot be read or a phase is incomplete
+	bool load(const std::string &path, std::string &error);
+
+	const std::vector<WorkloadPhase> &phases() const { return phases_; }
+	bool uses(WorkloadOp op) const;
+	std::chrono::seconds duration() const;
+
+private:
+	std::vector<WorkloadPhase> phases_;
+};
+
+// Hands out the operations of a phase in proportion to their weights and as evenly interleaved as
+// possible (smooth weighted round robin): peer = 7 and room = 3 give every 10 slots 7 peer and 3 room
+// calls, without runs of 7 peer calls in a row.
+class OperationMix {
+public:
+	explicit OperationMix(const std::vector<std::pair<WorkloadOp, double>> &weights);
+
+	WorkloadOp next();
+
+private:
+	std::vector<std::pair<WorkloadOp, double>> weights_;
+	std::vector<double> current_;
+	double total_ = 0;
+};
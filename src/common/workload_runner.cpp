@@ -0,0 +1,118 @@
+#include "workload_runner.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "message_sender.h"
+#include "worker.h"
+
+WorkloadRunner::WorkloadRunner(Worker &worker) : worker_(worker) {}
+
+void WorkloadRunner::run()
+{
+	MessageSender &sender = *worker_.sender();
+	if (!sender.begin()) {
+		return;
+	}
+	const Options &options = worker_.options();
+	RateScheduler &scheduler = sender.scheduler();
+	RateScheduler::Clock::time_point intended;
+	// `intended` is a slot taken from the scheduler that is not used yet
+	bool held = false;
+	uint64_t peer_sequence = 0;
+	uint64_t room_sequence = 0;
+	auto end = options.start_at != 0 ? steadyAt(options.load_start) : sender.started();
+	for (const auto &phase : options.workload.phases()) {
+		if (worker_.stopped()) {
+			break;
+		}
+		end += phase.duration;
+		if (end <= RateScheduler::Clock::now()) {
+			// a late login missed it
+			continue;
+		}
+		scheduler.setRate(phase.qps / options.sending_users);
+		OperationMix mix(phase.weights);
+		if (options.verbose) {
+			std::cout << "[workload] phase: " << phase.name << ", duration: " << phase.duration.count()
+				  << "s, qps: " << phase.qps << std::endl;
+		}
+		uint64_t calls[static_cast<size_t>(WorkloadOp::Conversations) + 1] = {};
+		// a slot due after the end is kept for the next phase, whose rate starts from there
+		while (held || scheduler.acquire(intended)) {
+			held = intended >= end;
+			if (held) {
+				break;
+			}
+			worker_.markAction();
+			WorkloadOp op = mix.next();
+			++calls[static_cast<size_t>(op)];
+			switch (op) {
+			case WorkloadOp::Peer:
+				sender.send(options.receiver, zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER,
+					    ++peer_sequence, intended);
+				break;
+			case WorkloadOp::Room:
+				sender.send(options.room_id, zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_ROOM,
+					    ++room_sequence, intended);
+				break;
+			case WorkloadOp::History:
+				queryHistory();
+				break;
+			case WorkloadOp::Conversations:
+				queryConversations();
+				break;
+			}
+		}
+		if (options.verbose) {
+			std::cout << "[workload] phase: " << phase.name << " issued";
+			for (const auto &weight : phase.weights) {
+				std::cout << " " << workloadOpName(weight.first) << ": "
+					  << calls[static_cast<size_t>(weight.first)];
+			}
+			std::cout << std::endl;
+		}
+	}
+}
+
+void WorkloadRunner::finish()
+{
+	auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(worker_.options().drain_timeout);
+	while (queries_in_flight_ > 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void WorkloadRunner::queryHistory()
+{
+	zim::ZIMMessageQueryConfig config;
+	config.count = 20;
+	config.reverse = true;
+	auto started = RateScheduler::Clock::now();
+	++worker_.metrics().operation(Operation::QueryHistory).issued;
+	++queries_in_flight_;
+	worker_.zim()->queryHistoryMessage(
+		worker_.options().receiver, zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER, config,
+		[this, started](const std::string &, zim::ZIMConversationType,
+				const std::vector<std::shared_ptr<zim::ZIMMessage>> &, const zim::ZIMError &errorInfo) {
+			worker_.recordOperation(Operation::QueryHistory, started, errorInfo);
+			--queries_in_flight_;
+		});
+}
+
+void WorkloadRunner::queryConversations()
+{
+	zim::ZIMConversationQueryConfig config;
+	config.count = 20;
+	auto started = RateScheduler::Clock::now();
+	++worker_.metrics().operation(Operation::QueryConversations).issued;
+	++queries_in_flight_;
+	worker_.zim()->queryConversationList(
+		config, [this, started](const std::vector<std::shared_ptr<zim::ZIMConversation>> &,
+					const zim::ZIMError &errorInfo) {
+			worker_.recordOperation(Operation::QueryConversations, started, errorInfo);
+			--queries_in_flight_;
+		});
+}
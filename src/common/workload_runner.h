@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+class Worker;
+
+// --workload: runs the phases one after the other, each with its own qps and mix of peer and room messages,
+// history pages and conversation lists. With --start-at the phases change at the same moments on every
+// host.
+class WorkloadRunner {
+public:
+	explicit WorkloadRunner(Worker &worker);
+
+	// until the last phase or the end of the run
+	void run();
+	// waits up to --drain-timeout for the queries in flight, like the sends
+	void finish();
+
+private:
+	// the latest page of the conversation with the receiver
+	void queryHistory();
+	// the first page of the conversation list
+	void queryConversations();
+
+	Worker &worker_;
+	std::atomic<uint64_t> queries_in_flight_{0};
+};
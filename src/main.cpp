@@ -1,128 +1,473 @@
 #define ZIM_MAIN_CONFIG
 #include <CLI/CLI.hpp>
 #include <ZIM.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 // #include "zim.h"
 #include "main.h"
+#include "delivery_tracker.h"
+#include "load_control.h"
+#include "load_profile.h"
+#include "media_files.h"
+#include "options.h"
+#include "payload_generator.h"
+#include "reporter.h"
+#include "runner.h"
+#include "send_variant.h"
 
+#ifdef ZIMCLI_MOCKZIM
+// the in-process mock accepts any credentials
+int appid = 1;
+std::string appsign = "mock";
+#else
 int appid = ;
 std::string appsign = ;
-
-zim::ZIM *zim_ = nullptr;
-std::thread thread_;
-std::string sender;
-std::string receiver;
-int qps = 1;
-int execution_time = 300; //default is 300s
-bool stopFlag = false;
-int debug = 0;
-std::string logpath = "/root/ZIMLogs";
-int logsize = 0;
+#endif
 
 int main(int argc, char **argv)
 {
 	std::cout << "Running..." << std::endl;
 
+	Options options;
+
 	CLI::App app("zimcli");
-	app.add_option("--sender", sender, "sender's userID");
-	app.add_option("--receiver", receiver, "receiver's userID");
-	app.add_option("--qps", qps, "qps, 1~10. Default is 1.")->default_val(1);
-
-	app.add_option("--debug", debug, "debug or not. Default is 0.")->default_val(0);
-	app.add_option("--logpath", logpath, "logpath. Default is /root/ZIMLogs")->default_val("/root/ZIMLogs");
-	app.add_option("--logsize", logsize, "logsize. Default is 5242880(5M)")->default_val(0);
-	app.add_option("--execution-time", execution_time,
+	app.add_option("--sender", options.sender, "sender's userID");
+	app.add_option("--receiver", options.receiver, "receiver's userID");
+	app.add_option("--role", options.role,
+		       "sender: send messages, receiver: log in as --receiver (or as every user of --users), record "
+		       "the delivery latency and check the sequence of every sender, login: log in as --sender (or as "
+		       "every user of --users) again and again, see --login-period. Default is sender.")
+		->default_val("sender")
+		->check(CLI::IsMember({"sender", "receiver", "login"}));
+	app.add_option("--login-period", options.login_period,
+		       "With --role login, every user logs out and in again at each multiple of this many ms on the "
+		       "wall clock, all users at the same moment. Default is 10000.")
+		->default_val(10000);
+	app.add_option("--login-jitter", options.login_jitter,
+		       "Spreads the relogins of --role login over this many ms after the period starts. Default is 0.")
+		->default_val(0);
+	app.add_option("--conversation", options.conversation,
+		       "peer: send to --receiver, room: enter --room-id and send to the room, group: create --groups "
+		       "groups and send to them, every member of a room or group records the delivery latency like "
+		       "--role receiver. Default is peer.")
+		->default_val("peer")
+		->check(CLI::IsMember({"peer", "room", "group"}));
+	app.add_option("--room-id", options.room_id, "Room of --conversation room. Default is zimcli_room.")
+		->default_val("zimcli_room");
+	app.add_option("--senders", options.senders,
+		       "With --conversation room and --users, only the first n users send and the others only receive, "
+		       "--qps is shared by the senders. Default is 0 (all).")
+		->default_val(0);
+	app.add_option("--groups", options.groups,
+		       "Groups of --conversation group, <group-prefix><n>. With --users, group n is created by user "
+		       "n % users, who sends to its groups in turn. Default is 1.")
+		->default_val(1);
+	app.add_option("--group-size", options.group_size,
+		       "Members of every group including its owner. With --users the members of group n are the users "
+		       "after its owner, at most --users; without, --receiver and <user-prefix><n>. Default is 10.")
+		->default_val(10);
+	app.add_option("--group-prefix", options.group_prefix, "groupID prefix of --groups. Default is zimcli_group_.")
+		->default_val("zimcli_group_");
+	app.add_option("--provision-concurrency", options.provision_concurrency,
+		       "Groups a user creates and fills at the same time before sending, they are dismissed the same "
+		       "way at exit. Default is 16.")
+		->default_val(16);
+	CLI::Option *workload_option = app.set_config(
+		"--workload", "",
+		"TOML/INI file of a mixed workload. Keys before the first section set the options of the same name, "
+		"every [section] is a phase run in file order with duration (s), qps and the relative shares of "
+		"peer, room (--room-id), history (queryHistoryMessage) and conversations (queryConversationList) "
+		"calls. --execution-time defaults to the phases plus 10s.");
+	app.add_option("--qps", options.qps,
+		       "qps, 1~5000 per process, 1~50000 with --message-type barrage. The total of all users with "
+		       "--users. Default is 1.")
+		->default_val(1);
+	app.add_option("--profile", options.profile_spec,
+		       "Total qps over the run instead of --qps: ramp:<from>:<to>:<seconds>, "
+		       "step:<from>:<step>:<hold seconds>[:<max>], sine:<min>:<max>:<period seconds> or "
+		       "spike:<base>:<peak>:<at seconds>:<length seconds>. Every step, or every --profile-window, is "
+		       "reported on its own.")
+		->check(
+			[](const std::string &spec) {
+				LoadProfile profile;
+				return profile.parse(spec) ? std::string() : "invalid profile " + spec;
+			},
+			"PROFILE");
+	app.add_option("--profile-window", options.profile_window,
+		       "Seconds of a report window of a ramp, sine or spike --profile. Default is 10.")
+		->default_val(10);
+	app.add_option("--control-socket", options.control_socket_path,
+		       "Unix socket changing the load while running, one command per connection: qps <total>, "
+		       "profile <spec>, pause, resume or stats (the load and the messages in flight).");
+	app.add_option("--rate-file", options.rate_file,
+		       "TOML file of qps, profile and paused, applied on SIGHUP. SIGUSR1 prints the totals so far.");
+	app.add_option("--pacing", options.pacing,
+		       "What to do when sending falls behind the schedule. catchup: send the late messages at once, "
+		       "skip: drop them. Default is catchup.")
+		->default_val("catchup")
+		->check(CLI::IsMember({"catchup", "skip"}));
+	app.add_option("--batch", options.batch,
+		       "Open loop: wait until this many slots of the schedule are due and send them back to back, one "
+		       "wake-up per batch for very high --qps, at up to batch / qps of extra response latency. "
+		       "Default is 1.")
+		->default_val(1);
+
+	app.add_option("--concurrency", options.concurrency,
+		       "Closed loop: keep this many sendMessage calls outstanding and send the next one as soon as one "
+		       "completes, --qps is ignored. The total of all users with --users. Default is 0 (open loop).")
+		->default_val(0);
+
+	app.add_option("--callback-timeout", options.callback_timeout,
+		       "Milliseconds after which a sendMessage without callback counts as a timeout, its --concurrency "
+		       "slot is freed and a later callback is counted as late. 0 turns the tracking off. Default is "
+		       "30000.")
+		->default_val(30000);
+
+	app.add_option("--payload-size", options.payload_size,
+		       "Message body size in bytes: fixed:<n>, uniform:<min>:<max>, lognormal:<median>:<sigma>, or "
+		       "file:<path> to replay the lines of a file. The size includes the stamp of about 40 bytes in "
+		       "front of every body (zc:<epoch>:<sequence>:<sent at>|), bodies shorter than it are sent as the "
+		       "stamp alone. Default is the stamp followed by \"hello world!\".")
+		->check(
+			[](const std::string &spec) {
+				PayloadGenerator generator;
+				return generator.parse(spec) ? std::string() : "invalid payload size " + spec;
+			},
+			"SIZE");
+	app.add_option("--payload-content", options.payload_content,
+		       "Generated bodies, words: compressible text, random: random alphanumerics. Default is words.")
+		->default_val("words")
+		->check(CLI::IsMember({"words", "random"}));
+	app.add_option("--payload-count", options.payload_count,
+		       "Bodies pregenerated per user and sent in turn. Default is 1024.")
+		->default_val(1024);
+	app.add_option("--extended-data-size", options.extended_data_size,
+		       "Bytes of extendedData on every message. A media message carries the stamp at its start, which "
+		       "counts towards the size. Default is 0.")
+		->default_val(0);
+	app.add_option("--mentions", options.mentions,
+		       "Mentioned userIDs on every message, the receiver and then <user-prefix><n>. Default is 0.")
+		->default_val(0);
+	app.add_option("--message-type", options.message_type,
+		       "text: ZIMTextMessage, barrage: ZIMBarrageMessage into the room of --conversation room, not "
+		       "stored and dropped under load, the members report the share that never arrived. Default is "
+		       "text.")
+		->default_val("text")
+		->check(CLI::IsMember({"text", "barrage"}));
+	app.add_option("--media", options.media_spec,
+		       "Send media messages with sendMediaMessage instead of text, the files of a comma separated "
+		       "list of <kind>:<size> in turn, kind image, file, audio or video, size in bytes with an "
+		       "optional K, M or G suffix. Default is none.")
+		->check(
+			[](const std::string &spec) {
+				MediaFiles files;
+				return files.parse(spec) ? std::string() : "invalid media " + spec;
+			},
+			"MEDIA");
+	app.add_option("--media-dir", options.media_dir,
+		       "Directory, preferably on tmpfs, for the sparse synthetic files of --media. They are deleted "
+		       "at the end. Default is /dev/shm/zimcli_media.")
+		->default_val("/dev/shm/zimcli_media");
+	app.add_option("--download-media", options.download_media,
+		       "Receivers download the original file of every media message they receive with "
+		       "downloadMediaFile. Default is 0.")
+		->default_val(0);
+	app.add_option("--history-walkers", options.history_walkers,
+		       "Conversation scroll benchmark: every sender walks its conversations with queryHistoryMessage, "
+		       "page after page from one end to the other and over again, with this many walks at once spread "
+		       "over them in turn. The pages are told apart by whether they could come from the local cache. "
+		       "Default is 0.")
+		->default_val(0);
+	app.add_option("--history-seed", options.history_seed,
+		       "Messages every sender of --history-walkers sends into each of its conversations at --qps "
+		       "before the walks start, 0 walks what the conversations hold already. Default is 0.")
+		->default_val(0);
+	app.add_option("--page-size", options.page_size,
+		       "ZIMMessageQueryConfig count of the pages of --history-walkers, 1~100. Default is 20.")
+		->default_val(20);
+	app.add_option("--history-reverse", options.history_reverse,
+		       "1: --history-walkers walk from the newest message to the oldest like scrolling up, 0: from the "
+		       "oldest to the newest. Default is 1.")
+		->default_val(1);
+	app.add_option("--priority", options.priority, "ZIMMessagePriority of every message. Default is low.")
+		->default_val("low")
+		->check(CLI::IsMember({"low", "medium", "high"}));
+	app.add_option("--receipt", options.receipt, "1: send every message with hasReceipt. Default is 0.")
+		->default_val(0);
+	app.add_option("--push", options.push, "1: send every message with an offline pushConfig. Default is 0.")
+		->default_val(0);
+	app.add_option("--matrix", options.matrix,
+		       "Seconds per cell of a sweep over every --priority with and without --receipt and --push, 12 "
+		       "cells one after the other, each reported with its throughput and latencies. The first cell "
+		       "starts at --start-at or once the users had time to log in. Default is 0 (off).")
+		->default_val(0);
+	app.add_option("--read-receipts", options.read_receipts,
+		       "Receivers and group members mark the messages sent with --receipt 1 read, this many per "
+		       "sendMessageReceiptsRead call and conversation. The senders time the receipts. Default is 0 "
+		       "(off).")
+		->default_val(0);
+	app.add_option("--receipt-delay", options.receipt_delay,
+		       "Milliseconds a --read-receipts batch waits at most for more messages, 0 only sends full "
+		       "batches. Default is 1000.")
+		->default_val(1000);
+
+	app.add_option("--report-interval", options.report_interval,
+		       "Seconds between two latency reports, 0 only reports at exit. Default is 10.")
+		->default_val(10);
+
+	app.add_option("--metrics-out", options.metrics_out,
+		       "File the metrics are written to every --metrics-interval ms, see --metrics-format.");
+	app.add_option("--metrics-format", options.metrics_format,
+		       "json: append one JSON object per interval, prometheus: rewrite the file in the Prometheus text "
+		       "format. Default is json.")
+		->default_val("json")
+		->check(CLI::IsMember({"json", "prometheus"}));
+	app.add_option("--metrics-port", options.metrics_port,
+		       "Serve the metrics in the Prometheus text format on http://127.0.0.1:<port>/metrics. Default is 0 "
+		       "(off).")
+		->default_val(0);
+	app.add_option("--metrics-interval", options.metrics_interval,
+		       "Milliseconds between two metrics updates. Default is 1000.")
+		->default_val(1000);
+
+	app.add_option("--users", options.users,
+		       "Fork this many worker processes, one user each, 0~10000. The senders are <user-prefix><n> for n in "
+		       "[user-start, user-start + users); without --receiver each user sends to the next one. Default is 0.")
+		->default_val(0);
+	app.add_option("--user-prefix", options.user_prefix, "userID prefix of --users. Default is zimcli_user_.")
+		->default_val("zimcli_user_");
+	app.add_option("--receiver-prefix", options.receiver_prefix,
+		       "userID prefix of the next user the senders of --users send to, e.g. the --user-prefix of a "
+		       "--role receiver run. Default is --user-prefix.");
+	app.add_option("--user-start", options.user_start, "First userID number of --users. Default is 0.")
+		->default_val(0);
+	app.add_option("--spawn-rate", options.spawn_rate,
+		       "Worker processes started per second with --users. Default is 100.")
+		->default_val(100);
+
+	app.add_option("--drain-timeout", options.drain_timeout,
+		       "Milliseconds to wait for the callbacks of the messages in flight after --execution-time or "
+		       "SIGINT/SIGTERM, before logging out. Default is 5000.")
+		->default_val(5000);
+
+	app.add_option("--debug", options.debug, "debug or not. Default is 0.")->default_val(0);
+	app.add_option("--logpath", options.logpath, "logpath. Default is /root/ZIMLogs")->default_val("/root/ZIMLogs");
+	app.add_option("--logsize", options.logsize, "logsize. Default is 5242880(5M)")->default_val(0);
+	app.add_option("--execution-time", options.execution_time,
 		       "The execution time of this command line programs. 0~900s. Default is 300s.")
 		->default_val(300);
+	app.add_option("--start-at", options.start_at,
+		       "Unix time in seconds to start sending at, after logging in. The same value on every host of a "
+		       "distributed run, with NTP synchronised clocks, lines up their --profile, --workload phases and "
+		       "--execution-time. Default is 0 (right after login).");
+	app.add_option("--histogram-out", options.histogram_out,
+		       "File the final counters and latency histograms are written to at exit, for --merge.");
+	app.add_option("--merge", options.merge_files,
+		       "Add up the --histogram-out files of the hosts of a distributed run into one report and exit.");
 	CLI11_PARSE(app, argc, argv);
+	options.appid = appid;
+	options.appsign = appsign;
 
-	if (qps > 10) {
-		qps = 10;
+	if (!options.merge_files.empty()) {
+		return runMerge(options.merge_files);
 	}
-	if (execution_time > 900) {
-		execution_time = 900;
-	}
-
-	logpath = logpath + "/" + sender;
-	std::string cachePath = "/root/ZIMCaches/" + sender;
 
-	std::cout << "sender: " << sender << std::endl;
-	std::cout << "receiver: " << receiver << std::endl;
-	std::cout << "execution_time: " << execution_time << std::endl;
-	std::cout << "logpath: " << logpath << std::endl;
-	std::cout << "cachepath: " << cachePath << std::endl;
-	std::cout << "logsize: " << logsize << std::endl;
-	std::cout << "ZIM version: " << zim::ZIM::getVersion() << std::endl;
-
-	if (sender.empty() || receiver.empty()) {
-		std::cout << "sender, receiver are required." << std::endl;
+	if (options.users < 0) {
+		options.users = 0;
+	}
+	if (options.users > 10000) {
+		options.users = 10000;
+	}
+	if (options.spawn_rate < 1) {
+		options.spawn_rate = 1;
+	}
+	if (options.message_type == "barrage") {
+		// barrages are small and not stored, a process sends far more of them than text messages
+		options.process_qps = 50000;
+	}
+	if (options.qps < 1) {
+		options.qps = 1;
+	}
+	if (options.qps > options.process_qps * std::max(options.users, 1)) {
+		options.qps = options.process_qps * std::max(options.users, 1);
+	}
+	if (options.batch < 1) {
+		options.batch = 1;
+	}
+	if (options.concurrency < 0) {
+		options.concurrency = 0;
+	}
+	if (options.payload_count < 1) {
+		options.payload_count = 1;
+	}
+	if (options.extended_data_size < 0) {
+		options.extended_data_size = 0;
+	}
+	if (options.extended_data_size > int(PayloadGenerator::kMaxPayloadSize)) {
+		options.extended_data_size = int(PayloadGenerator::kMaxPayloadSize);
+	}
+	if (options.mentions < 0) {
+		options.mentions = 0;
+	}
+	if (options.execution_time > 900) {
+		options.execution_time = 900;
+	}
+	if (options.metrics_interval < 100) {
+		options.metrics_interval = 100;
+	}
+	if (options.groups < 1) {
+		options.groups = 1;
+	}
+	if (options.group_size < 1) {
+		options.group_size = 1;
+	}
+	if (options.users > 0 && options.group_size > options.users) {
+		options.group_size = options.users;
+	}
+	if (options.provision_concurrency < 1) {
+		options.provision_concurrency = 1;
+	}
+	if (options.login_period < 100) {
+		options.login_period = 100;
+	}
+	options.load_start = unixMicros();
+	if (options.start_at != 0) {
+		if (options.start_at < 0 ||
+		    options.start_at * 1000000 > int64_t(options.load_start) + 24 * 3600 * 1000000LL) {
+			std::cout << "--start-at is negative or more than a day ahead." << std::endl;
+			return 1;
+		}
+		if (options.start_at * 1000000 < int64_t(options.load_start)) {
+			std::cout << "--start-at passed " << (options.load_start / 1000000 - options.start_at)
+				  << "s ago, the phases and the end are still counted from it." << std::endl;
+		}
+		options.load_start = options.start_at * 1000000;
+	}
+	if (options.login_jitter < 0) {
+		options.login_jitter = 0;
+	}
+	if (options.read_receipts < 0) {
+		options.read_receipts = 0;
+	}
+	if (options.receipt_delay < 0) {
+		options.receipt_delay = 0;
+	}
+	if (options.history_walkers < 0) {
+		options.history_walkers = 0;
+	}
+	if (options.history_seed < 0) {
+		options.history_seed = 0;
+	}
+	if (options.page_size < 1) {
+		options.page_size = 1;
+	}
+	if (options.page_size > 100) {
+		options.page_size = 100;
+	}
+	if (options.read_receipts > 0 && options.conversation == "room") {
+		std::cout << "--read-receipts needs --conversation peer or group, room messages have no receipts."
+			  << std::endl;
 		return 1;
 	}
 
-	// log path
-	zim::ZIMLogConfig log_config;
-	if (!logpath.empty()) {
-		log_config.logPath = logpath;
-	}
-	if (logsize != 0) {
-		log_config.logSize = logsize;
-	}
-	zim::ZIM::setLogConfig(log_config);
-	zim::ZIMCacheConfig cache_config;
-	cache_config.cachePath = cachePath;
-	zim::ZIM::setCacheConfig(cache_config);
-
-	// create zim
-	std::cout << "Create ZIM..." << std::endl;
-	zim::ZIMAppConfig app_config;
-	app_config.appID = appid;
-	app_config.appSign = appsign;
-	zim_ = zim::ZIM::create(app_config);
-
-	// login
-	std::cout << "Login ZIM..." << std::endl;
-	zim::ZIMUserInfo userInfo;
-	userInfo.userID = sender;
-	userInfo.userName = sender;
-	std::cout << "waiting for login success" << std::endl;
-	zim_->login(userInfo, [=](const zim::ZIMError &errorInfo) {
-		std::cout << "[callback][ZIMLoggedInCallback] code:" << errorInfo.code
-			  << ",message:" << errorInfo.message << std::endl;
-
-		thread_ = std::thread(loopMessage);
-	});
-
-	std::this_thread::sleep_for(std::chrono::seconds(execution_time));
-	stopFlag = true;
-	if (thread_.joinable()) {
-		thread_.join();
-	}
-	return 0;
-}
+	if (workload_option->count() > 0) {
+		std::string error;
+		if (!options.workload.load(workload_option->as<std::string>(), error)) {
+			std::cout << "invalid workload: " << error << std::endl;
+			return 1;
+		}
+		if (options.role != "sender" || options.conversation != "peer" || options.concurrency > 0) {
+			std::cout << "--workload replaces --conversation and --concurrency and needs --role sender."
+				  << std::endl;
+			return 1;
+		}
+		if (app.count("--execution-time") == 0) {
+			options.execution_time = std::min<int>(900, options.workload.duration().count() + 10);
+		}
+	}
 
-void loopMessage()
-{
-	int ms = 5 + 1000 / qps;
-	while (!stopFlag) {
+	if (options.message_type == "barrage" &&
+	    (options.conversation != "room" || !options.workload.phases().empty())) {
+		std::cout << "--message-type barrage needs --conversation room and no --workload." << std::endl;
+		return 1;
+	}
+	if (!options.media_spec.empty() && (options.message_type != "text" || !options.workload.phases().empty())) {
+		std::cout << "--media replaces --message-type and needs no --workload." << std::endl;
+		return 1;
+	}
+	if (options.history_walkers > 0 &&
+	    (options.role != "sender" || options.conversation == "room" || options.concurrency > 0 ||
+	     !options.workload.phases().empty() || !options.media_spec.empty())) {
+		std::cout << "--history-walkers needs --role sender and --conversation peer or group, and no "
+			     "--concurrency, --workload or --media."
+			  << std::endl;
+		return 1;
+	}
 
-		zim::ZIMMessageSendConfig sendConfig;
+	if (!options.profile_spec.empty()) {
+		if (options.role != "sender" || options.concurrency > 0 || !options.workload.phases().empty() ||
+		    options.history_walkers > 0) {
+			std::cout << "--profile needs --role sender and replaces --qps, --concurrency, --workload and "
+				     "--history-walkers."
+				  << std::endl;
+			return 1;
+		}
+		options.profile.parse(options.profile_spec);
+		options.profile.setWindow(std::max(1, options.profile_window));
+		options.profile_start = options.load_start;
+	}
 
-		auto message = std::make_shared<zim::ZIMTextMessage>("hello world!");
-		// auto notification = std::make_shared<zim::ZIMMessageSendNotification>(
-		// 	[=](const std::shared_ptr<zim::ZIMMessage> &message) {
+	if (options.matrix > 0) {
+		if (options.role != "sender" || !options.workload.phases().empty() || !options.profile_spec.empty() ||
+		    options.history_walkers > 0) {
+			std::cout << "--matrix needs --role sender and replaces --workload, --profile and "
+				     "--history-walkers."
+				  << std::endl;
+			return 1;
+		}
+		if (options.start_at == 0) {
+			// a barrier of its own, the first cell is not to be measured against users still logging in
+			options.start_at = options.load_start / 1000000 + options.users / options.spawn_rate + 5;
+			options.load_start = options.start_at * 1000000;
+		}
+		if (app.count("--execution-time") == 0) {
+			options.execution_time = std::min<int>(900, options.matrix * SendVariant::kMatrixCells);
+		}
+	}
+	parseMessagePriority(options.priority, options.send_variant.priority);
+	options.send_variant.receipt = options.receipt != 0;
+	options.send_variant.push = options.push != 0;
 
-		// 	});
+	options.sending = options.role == "sender";
+	// room calls of a workload make every user a room member
+	options.receiving = options.role != "login" && (options.role == "receiver" || options.conversation != "peer" ||
+						      options.workload.uses(WorkloadOp::Room));
+	options.timing_receipts = options.role == "sender" && (options.receipt != 0 || options.matrix > 0);
+	options.rate = options.qps;
 
-		zim_->sendMessage(std::static_pointer_cast<zim::ZIMMessage>(message), receiver,
-				  zim::ZIMConversationType::ZIM_CONVERSATION_TYPE_PEER, sendConfig, nullptr,
-				  [=](const std::shared_ptr<zim::ZIMMessage> &message, const zim::ZIMError &errorInfo) {
-					  if (debug != 0) {
-						  std::cout << "[callback][sendMessage] code:" << errorInfo.code
-							    << ",message:" << errorInfo.message << std::endl;
-					  }
-				  });
+	LoadControl::catchSignals();
+	if (options.users > 0) {
+		return runFanOut(options);
+	}
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	if (options.role == "receiver" && options.receiver.empty()) {
+		std::cout << "receiver is required." << std::endl;
+		return 1;
+	}
+	if (options.role == "login" && options.sender.empty()) {
+		std::cout << "sender is required." << std::endl;
+		return 1;
 	}
-}
\ No newline at end of file
+	if (options.role == "sender" && options.conversation != "peer" && options.sender.empty()) {
+		std::cout << "sender is required." << std::endl;
+		return 1;
+	}
+	if (options.role == "sender" && options.conversation == "peer" &&
+	    (options.sender.empty() || options.receiver.empty())) {
+		std::cout << "sender, receiver are required." << std::endl;
+		return 1;
+	}
+
+	return runSingle(options);
+}
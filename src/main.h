@@ -1,5 +1,4 @@
 #pragma once
 
-void loopMessage();
 void printVersion();
 void zimMain();
@@ -0,0 +1,31 @@
+#pragma once
+
+// What the test files of zimcli_tests share: CHECK notes a failure and goes on, REGISTER_TEST makes a test
+// runnable by name as `zimcli_tests <name>`.
+#include <iostream>
+#include <vector>
+
+namespace checks {
+
+struct Test {
+	const char *name;
+	void (*run)();
+};
+
+extern int failures;
+
+// in the order the test files were linked
+std::vector<Test> &tests();
+bool add(const char *name, void (*run)());
+
+} // namespace checks
+
+#define CHECK(condition)                                                                                       \
+	do {                                                                                                   \
+		if (!(condition)) {                                                                            \
+			std::cout << __FILE__ << ":" << __LINE__ << ": " << #condition << std::endl;           \
+			++checks::failures;                                                                    \
+		}                                                                                              \
+	} while (0)
+
+#define REGISTER_TEST(name, function) static const bool function##_registered = checks::add(name, function)
@@ -0,0 +1,87 @@
+// CompletionTracker: the timing wheel of --callback-timeout.
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "check.h"
+#include "completion_tracker.h"
+
+namespace {
+
+void completionTracker()
+{
+	typedef CompletionTracker::Clock Clock;
+	CompletionTracker tracker(std::chrono::milliseconds(100), std::chrono::milliseconds(10));
+	auto now = Clock::now();
+	uint64_t completed = tracker.start(now);
+	uint64_t lost = tracker.start(now);
+	uint64_t late = tracker.start(now);
+	CHECK(tracker.outstanding() == 3);
+	CHECK(tracker.complete(completed));
+	CHECK(!tracker.complete(completed));
+
+	// never before the timeout
+	CHECK(tracker.expire(now + std::chrono::milliseconds(99)) == 0);
+	CHECK(tracker.outstanding() == 2);
+	// at most a tick after it
+	CHECK(tracker.expire(now + std::chrono::milliseconds(121)) == 2);
+	CHECK(tracker.outstanding() == 0);
+	CHECK(!tracker.complete(late));
+	CHECK(!tracker.complete(lost));
+
+	// a pause longer than a turn of the wheel expires everything that is due, and only that
+	auto later = now + std::chrono::milliseconds(200);
+	uint64_t early = tracker.start(later);
+	uint64_t recent = tracker.start(later + std::chrono::milliseconds(950));
+	CHECK(tracker.expire(later + std::chrono::milliseconds(1000)) == 1);
+	CHECK(!tracker.complete(early));
+	CHECK(tracker.complete(recent));
+	CHECK(tracker.expire(later + std::chrono::seconds(10)) == 0);
+}
+REGISTER_TEST("completion_tracker", completionTracker);
+
+// the contexts of the expired operations come back, those of the completed ones do not
+void completionTrackerContexts()
+{
+	typedef CompletionTracker::Clock Clock;
+	CompletionTracker tracker(std::chrono::milliseconds(100), std::chrono::milliseconds(10));
+	int first = 0;
+	int second = 0;
+	auto now = Clock::now();
+	uint64_t completed = tracker.start(now, &first);
+	tracker.start(now, &second);
+	tracker.start(now);
+	CHECK(tracker.complete(completed));
+	std::vector<void *> contexts;
+	CHECK(tracker.expire(now + std::chrono::milliseconds(121), &contexts) == 2);
+	CHECK(contexts.size() == 1 && contexts.front() == &second);
+}
+REGISTER_TEST("completion_tracker_contexts", completionTrackerContexts);
+
+// an old operation that never completes keeps its place while many newer ones come and go past it
+void completionTrackerWindow()
+{
+	typedef CompletionTracker::Clock Clock;
+	CompletionTracker tracker(std::chrono::milliseconds(100), std::chrono::milliseconds(10));
+	int context = 0;
+	auto now = Clock::now();
+	uint64_t old = tracker.start(now, &context);
+	std::vector<uint64_t> tokens;
+	for (int i = 0; i < 5000; ++i) {
+		tokens.push_back(tracker.start(now));
+		if (i % 2 == 0) {
+			CHECK(tracker.complete(tokens.back()));
+		}
+	}
+	CHECK(tracker.outstanding() == 2501);
+	for (size_t i = 0; i < tokens.size(); ++i) {
+		CHECK(tracker.complete(tokens[i]) == (i % 2 == 1));
+	}
+	std::vector<void *> contexts;
+	CHECK(tracker.expire(now + std::chrono::milliseconds(121), &contexts) == 1);
+	CHECK(contexts.size() == 1 && contexts.front() == &context);
+	CHECK(!tracker.complete(old));
+}
+REGISTER_TEST("completion_tracker_window", completionTrackerWindow);
+
+} // namespace
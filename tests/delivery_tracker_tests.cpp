@@ -0,0 +1,117 @@
+// MessageStamp and DeliveryTracker: the stamps a receiver accepts, and what it counts for a sender's
+// sequences arriving in order, late, twice or not at all.
+#include <cstdint>
+#include <string>
+
+#include "check.h"
+#include "delivery_tracker.h"
+
+namespace {
+
+struct Stamp {
+	const char *text;
+	bool valid;
+	uint64_t epoch;
+	uint64_t sequence;
+	uint64_t sent_micros;
+};
+
+const Stamp kStamps[] = {
+	{"zc:1:2:3|", true, 1, 2, 3},
+	{"zc:1700000000000:1:1700000000000000|hello", true, 1700000000000, 1, 1700000000000000},
+	{"zc:18446744073709551615:1:1|", true, 18446744073709551615ULL, 1, 1},
+	{"zc:0:0:0|", true, 0, 0, 0},
+	{"zc:1:2:3", false, 0, 0, 0},
+	{"zc:1:2|", false, 0, 0, 0},
+	{"zc::2:3|", false, 0, 0, 0},
+	{"zc:1:x:3|", false, 0, 0, 0},
+	{"zc:1:2:3:4|", false, 0, 0, 0},
+	{"zc:-1:2:3|", false, 0, 0, 0},
+	{"zc:123456789012345678901:2:3|", false, 0, 0, 0},
+	{"zd:1:2:3|", false, 0, 0, 0},
+	{"hello zc:1:2:3|", false, 0, 0, 0},
+	{"", false, 0, 0, 0},
+};
+
+void messageStampParse()
+{
+	for (const auto &expected : kStamps) {
+		MessageStamp stamp;
+		bool valid = MessageStamp::parse(expected.text, stamp);
+		if (valid != expected.valid) {
+			std::cout << "  " << expected.text << std::endl;
+		}
+		CHECK(valid == expected.valid);
+		if (valid && expected.valid) {
+			CHECK(stamp.epoch == expected.epoch && stamp.sequence == expected.sequence &&
+			      stamp.sent_micros == expected.sent_micros);
+		}
+	}
+
+	// what write() makes parses back, at the longest it can be
+	MessageStamp longest;
+	longest.epoch = longest.sequence = longest.sent_micros = 18446744073709551615ULL;
+	char buffer[MessageStamp::kMaxLength];
+	MessageStamp parsed;
+	CHECK(MessageStamp::parse(std::string(buffer, longest.write(buffer)), parsed));
+	CHECK(parsed.epoch == longest.epoch && parsed.sequence == longest.sequence &&
+	      parsed.sent_micros == longest.sent_micros);
+}
+REGISTER_TEST("message_stamp_parse", messageStampParse);
+
+struct Arrival {
+	uint64_t epoch;
+	uint64_t sequence;
+	DeliveryTracker::Outcome outcome;
+	// missing after it
+	uint64_t missing;
+};
+
+const Arrival kArrivals[] = {
+	// counting starts at 10, what came before it was never missing
+	{1, 10, DeliveryTracker::InOrder, 0},
+	{1, 11, DeliveryTracker::InOrder, 0},
+	{1, 8, DeliveryTracker::Reordered, 0},
+	{1, 8, DeliveryTracker::Duplicate, 0},
+	// 12 to 14 skipped
+	{1, 15, DeliveryTracker::InOrder, 3},
+	{1, 13, DeliveryTracker::Reordered, 2},
+	{1, 13, DeliveryTracker::Duplicate, 2},
+	{1, 15, DeliveryTracker::Duplicate, 2},
+	{1, 9, DeliveryTracker::Reordered, 2},
+	{1, 12, DeliveryTracker::Reordered, 1},
+	// so far back it cannot be told from a duplicate, and the gap stays counted
+	{1, 5000, DeliveryTracker::InOrder, 4985},
+	{1, 14, DeliveryTracker::Reordered, 4985},
+	// an older run does not count, a newer one starts over
+	{0, 4999, DeliveryTracker::Stale, 4985},
+	{2, 3, DeliveryTracker::InOrder, 4985},
+	{2, 1, DeliveryTracker::Reordered, 4985},
+	{2, 5, DeliveryTracker::InOrder, 4986},
+	{2, 4, DeliveryTracker::Reordered, 4985},
+};
+
+void deliveryTrackerSequences()
+{
+	WorkerMetrics metrics{};
+	DeliveryTracker tracker(metrics);
+	for (const auto &arrival : kArrivals) {
+		MessageStamp stamp;
+		stamp.epoch = arrival.epoch;
+		stamp.sequence = arrival.sequence;
+		auto outcome = tracker.record("sender", stamp);
+		if (outcome != arrival.outcome || metrics.missing != arrival.missing) {
+			std::cout << "  " << arrival.epoch << ":" << arrival.sequence << std::endl;
+		}
+		CHECK(outcome == arrival.outcome);
+		CHECK(metrics.missing == arrival.missing);
+	}
+	CHECK(metrics.received == sizeof(kArrivals) / sizeof(kArrivals[0]));
+	CHECK(metrics.duplicates == 3);
+	CHECK(metrics.reordered == 7);
+	auto worst = tracker.worst(1);
+	CHECK(worst.size() == 1 && worst.front().user_id == "sender" && worst.front().missing == metrics.missing);
+}
+REGISTER_TEST("delivery_tracker_sequences", deliveryTrackerSequences);
+
+} // namespace
@@ -0,0 +1,62 @@
+// LatencyHistogram: the accuracy of the quantiles, concurrent records and the snapshots of --histogram-out.
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "latency_histogram.h"
+
+namespace {
+
+void latencyHistogram()
+{
+	LatencyHistogram histogram;
+	for (uint64_t value = 1; value <= 100000; ++value) {
+		histogram.record(value);
+	}
+	auto snapshot = histogram.snapshot();
+	CHECK(snapshot.count() == 100000);
+	CHECK(snapshot.max() == 100000);
+	// within 1/128 of the exact quantile
+	const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+	for (double q : quantiles) {
+		double exact = q * 100000;
+		double reported = snapshot.quantile(q);
+		CHECK(reported >= exact * (1 - 1.0 / 128) && reported <= exact * (1 + 1.0 / 128));
+	}
+	// values below 128us are exact
+	LatencyHistogram small;
+	small.record(std::chrono::microseconds(7));
+	CHECK(small.snapshot().quantile(0.5) == 7);
+
+	// recorded from several threads at once, nothing is lost
+	LatencyHistogram shared;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&shared, t]() {
+			for (uint64_t value = 0; value < 50000; ++value) {
+				shared.record(value * (t + 1));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	auto concurrent = shared.snapshot();
+	CHECK(concurrent.count() == 200000);
+	CHECK(concurrent.max() == 49999 * 4);
+
+	// interval deltas and the round trip through --histogram-out
+	auto later = concurrent;
+	later.add(snapshot);
+	CHECK(later.since(concurrent).count() == snapshot.count());
+	CHECK(later.since(concurrent).quantile(0.5) == snapshot.quantile(0.5));
+	HistogramSnapshot decoded;
+	CHECK(decoded.decode(later.encode()));
+	CHECK(decoded.count() == later.count() && decoded.sum() == later.sum() && decoded.max() == later.max());
+	CHECK(decoded.quantile(0.99) == later.quantile(0.99));
+}
+REGISTER_TEST("latency_histogram", latencyHistogram);
+
+} // namespace
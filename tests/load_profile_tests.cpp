@@ -0,0 +1,84 @@
+// LoadProfile: the specs of --profile that are accepted and rejected, and a profile parsed again over another.
+#include <cmath>
+#include <string>
+
+#include "check.h"
+#include "load_profile.h"
+
+namespace {
+
+struct Spec {
+	const char *spec;
+	bool valid;
+	// qps at 0s and 30s of a valid one
+	double start;
+	double later;
+};
+
+const Spec kSpecs[] = {
+	{"ramp:10:100:60", true, 10, 55},
+	{"ramp:100:10:60", true, 100, 55},
+	{"step:10:5:10", true, 10, 25},
+	{"step:10:5:10:20", true, 10, 20},
+	{"sine:10:30:120", true, 20, 30},
+	{"spike:10:100:20:20", true, 10, 100},
+	{"spike:10:100:0:0", true, 10, 10},
+	{"ramp:0:100:60", false, 0, 0},
+	{"ramp:10:100", false, 0, 0},
+	{"ramp:10:100:60:1", false, 0, 0},
+	{"ramp:10:x:60", false, 0, 0},
+	{"ramp:10:100:60s", false, 0, 0},
+	{"ramp:-1:100:60", false, 0, 0},
+	{"step:10:5:0", false, 0, 0},
+	{"step:10:5:10:5", false, 0, 0},
+	{"sine:30:10:120", false, 0, 0},
+	{"sine:10:30:0", false, 0, 0},
+	{"spike:10:0:20:20", false, 0, 0},
+	{"spike:10:100:20", false, 0, 0},
+	{"wave:10:100:60", false, 0, 0},
+	{"ramp", false, 0, 0},
+	{"", false, 0, 0},
+	{"ramp:10:100:60:1:2", false, 0, 0},
+};
+
+bool same(double a, double b)
+{
+	return std::fabs(a - b) < 1e-9;
+}
+
+void loadProfileSpecs()
+{
+	for (const auto &spec : kSpecs) {
+		LoadProfile profile;
+		bool valid = profile.parse(spec.spec);
+		if (valid != spec.valid) {
+			std::cout << "  " << spec.spec << std::endl;
+		}
+		CHECK(valid == spec.valid);
+		if (valid && spec.valid) {
+			CHECK(same(profile.qps(0), spec.start));
+			CHECK(same(profile.qps(30), spec.later));
+		}
+	}
+}
+REGISTER_TEST("load_profile_specs", loadProfileSpecs);
+
+// the live path parses every new spec into the same profile
+void loadProfileReparse()
+{
+	LoadProfile profile;
+	CHECK(profile.parse("spike:10:100:20:5"));
+	// the length of the spike would have been the cap of the step
+	CHECK(profile.parse("step:10:5:10"));
+	CHECK(same(profile.qps(0), 10));
+	CHECK(same(profile.qps(30), 25));
+
+	// a rejected spec keeps the last valid one
+	CHECK(!profile.parse("ramp:0:100:60"));
+	CHECK(!profile.parse("sine:10"));
+	CHECK(same(profile.qps(30), 25));
+	CHECK(same(profile.windowEnd(12), 20));
+}
+REGISTER_TEST("load_profile_reparse", loadProfileReparse);
+
+} // namespace
@@ -0,0 +1,87 @@
+// MediaFiles: the specs of --media that are accepted and rejected, and the sparse files they make.
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+
+#include "check.h"
+#include "media_files.h"
+
+namespace {
+
+struct Spec {
+	const char *spec;
+	bool valid;
+	// files and their total size of a valid one
+	size_t count;
+	uint64_t total;
+};
+
+const Spec kSpecs[] = {
+	{"image:1K", true, 1, 1024},
+	{"image:1.5M,video:2M", true, 2, 1572864 + 2097152},
+	{"file:1,file:2,file:3", true, 3, 6},
+	{"audio:160000", true, 1, 160000},
+	{"video:1g", true, 1, 1073741824},
+	{"image:1K,", true, 1, 1024},
+	{"image:0", false, 0, 0},
+	{"image:0.5", false, 0, 0},
+	{"image:1T", false, 0, 0},
+	{"image:1KB", false, 0, 0},
+	{"image:-1K", false, 0, 0},
+	{"photo:1K", false, 0, 0},
+	{"image", false, 0, 0},
+	{"image:", false, 0, 0},
+	{",image:1K", false, 0, 0},
+	{"image:1K,,file:1", false, 0, 0},
+	{"", false, 0, 0},
+};
+
+void mediaFilesSpecs()
+{
+	for (const auto &spec : kSpecs) {
+		MediaFiles files;
+		bool valid = files.parse(spec.spec);
+		if (valid != spec.valid) {
+			std::cout << "  " << spec.spec << std::endl;
+		}
+		CHECK(valid == spec.valid);
+		if (valid && spec.valid) {
+			CHECK(files.count() == spec.count && files.totalSize() == spec.total);
+		}
+	}
+
+	// 160000 bytes are 10 seconds of the 128 kbit/s audio, an image has no duration
+	MediaFiles files;
+	CHECK(files.parse("audio:160000,image:1K"));
+	CHECK(files.next().duration == 10);
+	CHECK(files.next().duration == 0);
+	CHECK(files.next().kind == MediaKind::Audio);
+
+	// a rejected spec keeps the last valid one and its place in it
+	CHECK(!files.parse("image:1K,photo:1K"));
+	CHECK(files.count() == 2 && files.next().kind == MediaKind::Image);
+}
+REGISTER_TEST("media_files_specs", mediaFilesSpecs);
+
+void mediaFilesCreate()
+{
+	MediaFiles files;
+	// smaller than its header, the file grows to hold it
+	CHECK(files.parse("video:10M,file:1"));
+	CHECK(files.create("media_files_tests/nested", "tag"));
+	const MediaFiles::File &video = files.next();
+	const MediaFiles::File &file = files.next();
+	struct stat status;
+	CHECK(::stat(video.path.c_str(), &status) == 0 && uint64_t(status.st_size) == 10 * 1024 * 1024);
+	CHECK(video.path.find(".mp4") != std::string::npos);
+	CHECK(::stat(file.path.c_str(), &status) == 0 && uint64_t(status.st_size) == file.size && file.size > 1);
+	files.remove();
+	CHECK(::stat(video.path.c_str(), &status) != 0 && ::stat(file.path.c_str(), &status) != 0);
+	::rmdir("media_files_tests/nested");
+	::rmdir("media_files_tests");
+}
+REGISTER_TEST("media_files_create", mediaFilesCreate);
+
+} // namespace
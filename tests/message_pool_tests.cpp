@@ -0,0 +1,39 @@
+// MessagePool: messages handed out, put back and reclaimed after a timeout.
+#include <ZIM.h>
+#include <memory>
+#include <set>
+
+#include "check.h"
+#include "message_pool.h"
+
+namespace {
+
+void messagePoolReclaim()
+{
+	MessagePool<zim::ZIMTextMessage> pool(2, zim::ZIMTextMessage("prototype"));
+	auto first = pool.acquire();
+	auto second = pool.acquire();
+	CHECK(pool.size() == 2);
+	first->message = "sent";
+	pool.release(first.get());
+	CHECK(pool.acquire() == first);
+	CHECK(first->message == "prototype");
+
+	// the SDK keeps the timed out message, the pool hands out a new one in its place and does not grow
+	PooledTextMessage *timed_out = second.get();
+	pool.reclaim(timed_out);
+	auto replacement = pool.acquire();
+	CHECK(replacement != second);
+	CHECK(replacement->message == "prototype");
+	CHECK(pool.size() == 2);
+	CHECK(second.use_count() == 1);
+
+	// with every message in flight it grows
+	auto third = pool.acquire();
+	CHECK(pool.size() == 3);
+	std::set<PooledTextMessage *> lent{first.get(), replacement.get(), third.get()};
+	CHECK(lent.size() == 3);
+}
+REGISTER_TEST("message_pool_reclaim", messagePoolReclaim);
+
+} // namespace
@@ -0,0 +1,92 @@
+// PayloadGenerator: the specs of --payload-size that are accepted and rejected, and the sizes and lines
+// they make.
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "check.h"
+#include "payload_generator.h"
+
+namespace {
+
+struct Spec {
+	const char *spec;
+	bool valid;
+	// bounds of the generated sizes of a valid one
+	size_t least;
+	size_t most;
+};
+
+const Spec kSpecs[] = {
+	{"fixed:100", true, 100, 100},
+	{"fixed:1", true, 1, 1},
+	{"fixed:2000000", true, PayloadGenerator::kMaxPayloadSize, PayloadGenerator::kMaxPayloadSize},
+	{"uniform:10:20", true, 10, 20},
+	{"uniform:10:10", true, 10, 10},
+	{"lognormal:100:0", true, 100, 100},
+	{"lognormal:100:0.5", true, 1, PayloadGenerator::kMaxPayloadSize},
+	{"fixed:0", false, 0, 0},
+	{"fixed", false, 0, 0},
+	{"fixed:100:1", false, 0, 0},
+	{"fixed:-5", false, 0, 0},
+	{"fixed:1k", false, 0, 0},
+	{"uniform:20:10", false, 0, 0},
+	{"uniform:0:10", false, 0, 0},
+	{"uniform:10", false, 0, 0},
+	{"lognormal:0:1", false, 0, 0},
+	{"lognormal:100", false, 0, 0},
+	{"normal:100:10", false, 0, 0},
+	{"file:", false, 0, 0},
+	{"", false, 0, 0},
+};
+
+void payloadGeneratorSpecs()
+{
+	for (const auto &spec : kSpecs) {
+		PayloadGenerator generator;
+		bool valid = generator.parse(spec.spec);
+		if (valid != spec.valid) {
+			std::cout << "  " << spec.spec << std::endl;
+		}
+		CHECK(valid == spec.valid);
+		if (!valid || !spec.valid) {
+			continue;
+		}
+		CHECK(generator.generate(20, PayloadContent::Words, 1));
+		CHECK(generator.count() == 20);
+		for (size_t i = 0; i < generator.count(); ++i) {
+			size_t size = generator.next().size();
+			CHECK(size >= spec.least && size <= spec.most);
+		}
+	}
+}
+REGISTER_TEST("payload_generator_specs", payloadGeneratorSpecs);
+
+void payloadGeneratorFile()
+{
+	const std::string path = "payload_generator_tests.txt";
+	{
+		std::ofstream file(path);
+		file << "first\r\n\nsecond\n";
+	}
+	PayloadGenerator generator;
+	CHECK(generator.parse("file:" + path));
+	CHECK(generator.generate(10, PayloadContent::Random, 1));
+	CHECK(generator.count() == 2);
+	CHECK(generator.next() == "first");
+	CHECK(generator.next() == "second");
+	CHECK(generator.next() == "first");
+
+	// a rejected spec keeps the last valid one
+	CHECK(generator.parse("fixed:5"));
+	CHECK(!generator.parse("file:"));
+	CHECK(generator.generate(3, PayloadContent::Random, 1) && generator.next().size() == 5);
+
+	CHECK(generator.parse("file:" + path + ".missing"));
+	CHECK(!generator.generate(10, PayloadContent::Words, 1));
+	std::remove(path.c_str());
+}
+REGISTER_TEST("payload_generator_file", payloadGeneratorFile);
+
+} // namespace
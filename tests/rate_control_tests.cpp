@@ -0,0 +1,45 @@
+// RateControl: the seqlock the parent publishes the load of --control-socket and --rate-file through.
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "check.h"
+#include "shared_metrics.h"
+
+namespace {
+
+// RateControl readers never see half of a store
+void rateControl()
+{
+	RateControl control;
+	std::atomic<bool> stopped{false};
+	std::atomic<int> torn{0};
+	std::thread reader([&control, &stopped, &torn]() {
+		RateControl::Settings settings;
+		while (!stopped) {
+			control.load(settings);
+			// every store writes a qps and a profile that name each other
+			std::string expected = "ramp:1:" + std::to_string(int(settings.qps)) + ":10";
+			if (settings.qps != 0 && settings.profile != expected) {
+				++torn;
+			}
+		}
+	});
+	uint64_t version = control.version();
+	for (int i = 1; i <= 20000; ++i) {
+		RateControl::Settings settings;
+		settings.qps = i;
+		settings.profile = "ramp:1:" + std::to_string(i) + ":10";
+		control.store(settings);
+	}
+	stopped = true;
+	reader.join();
+	CHECK(torn == 0);
+	CHECK(control.version() != version);
+	RateControl::Settings settings;
+	control.load(settings);
+	CHECK(settings.qps == 20000 && settings.profile == "ramp:1:20000:10");
+}
+REGISTER_TEST("rate_control", rateControl);
+
+} // namespace
@@ -0,0 +1,64 @@
+// RateScheduler: the deadlines of the slots, catchup and skip.
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "rate_scheduler.h"
+
+namespace {
+
+// `duration` is `ms` up to the rounding of the slot times to the clock
+bool near(RateScheduler::Clock::duration duration, int ms)
+{
+	auto difference = duration - std::chrono::milliseconds(ms);
+	return difference < std::chrono::microseconds(1) && difference > -std::chrono::microseconds(1);
+}
+
+void rateScheduler()
+{
+	typedef RateScheduler::Clock Clock;
+	RateScheduler scheduler(1000, PacingMode::CatchUp);
+	Clock::time_point first, intended;
+	CHECK(scheduler.acquire(first));
+	for (int i = 1; i < 200; ++i) {
+		CHECK(scheduler.acquire(intended));
+	}
+	// slot n is due n intervals after the first, however late it was handed out
+	CHECK(near(intended - first, 199));
+	CHECK(Clock::now() >= intended);
+	CHECK(scheduler.issued() == 200);
+
+	// a batch waits for its last slot and hands out all of them
+	std::vector<Clock::time_point> batch;
+	CHECK(scheduler.acquire(10, batch));
+	CHECK(batch.size() == 10 && near(batch.front() - intended, 1));
+	CHECK(Clock::now() >= batch.back());
+
+	// catchup hands out the slots missed meanwhile at once: all of them were due before the first was taken
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	auto caught = Clock::now();
+	for (int i = 0; i < 40; ++i) {
+		CHECK(scheduler.acquire(intended));
+	}
+	CHECK(near(intended - batch.back(), 40));
+	CHECK(intended < caught);
+	CHECK(scheduler.skipped() == 0);
+
+	scheduler.stop();
+	CHECK(!scheduler.acquire(intended));
+
+	// skip drops them instead and jumps to the last slot that is due, every slot in between is counted
+	RateScheduler skipping(1000, PacingMode::Skip);
+	CHECK(skipping.acquire(first));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	CHECK(skipping.acquire(intended));
+	auto slot = std::chrono::duration_cast<std::chrono::microseconds>(intended - first).count() + 500;
+	slot /= 1000;
+	CHECK(slot >= 49);
+	CHECK(near(intended - first, int(slot)));
+	CHECK(skipping.skipped() == uint64_t(slot - 1));
+}
+REGISTER_TEST("rate_scheduler", rateScheduler);
+
+} // namespace
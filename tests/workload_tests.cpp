@@ -0,0 +1,88 @@
+// Workload and OperationMix: the --workload files that are accepted and rejected, and how a phase's
+// weights interleave.
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "check.h"
+#include "workload.h"
+
+namespace {
+
+struct File {
+	const char *text;
+	bool valid;
+	// phases of a valid one
+	size_t phases;
+	long seconds;
+};
+
+const File kFiles[] = {
+	{"qps = 10\n[warmup]\nduration = 30\nqps = 50\npeer = 70\nroom = 10\n", true, 1, 30},
+	{"[a]\nduration = 10\nqps = 5\nhistory = 1\n[b]\nduration = 20\nqps = 5\nconversations = 1\n", true, 2, 30},
+	{"[a]\nduration = 10\nqps = 5\npeer = 1\nroom = 0\n", true, 1, 10},
+	{"[a]\nduration = 10\n[b]\nduration = 5\nqps = 1\npeer = 1\n[a]\nqps = 2\npeer = 1\n", true, 2, 15},
+	{"qps = 10\n", false, 0, 0},
+	{"", false, 0, 0},
+	{"[a]\nqps = 5\npeer = 1\n", false, 0, 0},
+	{"[a]\nduration = 10\npeer = 1\n", false, 0, 0},
+	{"[a]\nduration = 10\nqps = 5\n", false, 0, 0},
+	{"[a]\nduration = 10\nqps = 5\npeer = 0\n", false, 0, 0},
+	{"[a]\nduration = 10\nqps = 5\nlogin = 1\n", false, 0, 0},
+	{"[a]\nduration = 10\nqps = -5\npeer = 1\n", false, 0, 0},
+	{"[a]\nduration = ten\nqps = 5\npeer = 1\n", false, 0, 0},
+	{"[a.b]\nduration = 10\nqps = 5\npeer = 1\n", false, 0, 0},
+};
+
+void workloadFiles()
+{
+	const std::string path = "workload_tests.toml";
+	for (const auto &file : kFiles) {
+		{
+			std::ofstream out(path);
+			out << file.text;
+		}
+		Workload workload;
+		std::string error;
+		bool valid = workload.load(path, error);
+		if (valid != file.valid) {
+			std::cout << "  " << file.text << std::endl;
+		}
+		CHECK(valid == file.valid);
+		CHECK(valid || !error.empty());
+		if (valid && file.valid) {
+			CHECK(workload.phases().size() == file.phases);
+			CHECK(workload.duration().count() == file.seconds);
+		}
+	}
+	Workload workload;
+	std::string error;
+	CHECK(!workload.load(path + ".missing", error) && !error.empty());
+	std::remove(path.c_str());
+}
+REGISTER_TEST("workload_files", workloadFiles);
+
+void operationMix()
+{
+	OperationMix mix({{WorkloadOp::Peer, 7}, {WorkloadOp::Room, 3}});
+	std::map<WorkloadOp, int> counts;
+	int run = 0;
+	int longest = 0;
+	for (int i = 0; i < 100; ++i) {
+		WorkloadOp op = mix.next();
+		++counts[op];
+		run = op == WorkloadOp::Peer ? run + 1 : 0;
+		longest = std::max(longest, run);
+	}
+	CHECK(counts[WorkloadOp::Peer] == 70 && counts[WorkloadOp::Room] == 30);
+	// interleaved, not 7 in a row
+	CHECK(longest <= 3);
+
+	OperationMix single({{WorkloadOp::History, 2}});
+	CHECK(single.next() == WorkloadOp::History && single.next() == WorkloadOp::History);
+}
+REGISTER_TEST("operation_mix", operationMix);
+
+} // namespace
@@ -0,0 +1,210 @@
+// Checks of the structures on the hot path of a send. This file has the pending message table of the SDK
+// wrapper and main(), the other structures register their tests from files of their own, see check.h. Run
+// one with `zimcli_tests <name>`, or all of them without an argument.
+#include <ZIM.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+namespace checks {
+
+int failures = 0;
+
+std::vector<Test> &tests()
+{
+	static std::vector<Test> tests;
+	return tests;
+}
+
+bool add(const char *name, void (*run)())
+{
+	tests().push_back(Test{name, run});
+	return true;
+}
+
+} // namespace checks
+
+namespace {
+
+// shards and slots of ZIMPendingMessageTable: the low 4 bits pick the shard, the next ones the home slot,
+// and a shard starts with 16 slots
+const zim_sequence kShards = 16;
+const zim_sequence kSlots = 16;
+
+zim::ZIMPendingMessage pending(zim_sequence sequence)
+{
+	zim::ZIMPendingMessage pending;
+	pending.message = std::make_shared<zim::ZIMTextMessage>(std::to_string(sequence));
+	return pending;
+}
+
+// the message of `sequence` is the one inserted for it
+bool holds(zim::ZIMPendingMessageTable &table, zim_sequence sequence)
+{
+	std::string text;
+	bool found = table.visit(sequence, [&text](zim::ZIMPendingMessage &pending) {
+		text = static_cast<zim::ZIMTextMessage *>(pending.message.get())->message;
+	});
+	return found && text == std::to_string(sequence);
+}
+
+bool takes(zim::ZIMPendingMessageTable &table, zim_sequence sequence)
+{
+	zim::ZIMPendingMessage taken;
+	return table.take(sequence, taken) && taken.message &&
+	       static_cast<zim::ZIMTextMessage *>(taken.message.get())->message == std::to_string(sequence);
+}
+
+// sequences of one shard with the same home slot probe past each other
+void pendingTableCollisions()
+{
+	zim::ZIMPendingMessageTable table;
+	std::vector<zim_sequence> sequences;
+	for (zim_sequence i = 0; i < 5; ++i) {
+		sequences.push_back(3 + i * kShards * kSlots);
+	}
+	for (auto sequence : sequences) {
+		table.insert(sequence, pending(sequence));
+	}
+	for (auto sequence : sequences) {
+		CHECK(holds(table, sequence));
+	}
+	// the same home, never inserted
+	CHECK(!holds(table, 3 + 5 * kShards * kSlots));
+
+	// taking one from the middle of the run keeps the ones behind it reachable
+	CHECK(takes(table, sequences[1]));
+	CHECK(!holds(table, sequences[1]));
+	CHECK(!takes(table, sequences[1]));
+	for (size_t i = 0; i < sequences.size(); ++i) {
+		CHECK(i == 1 || holds(table, sequences[i]));
+	}
+
+	// inserting again replaces the entry
+	table.insert(sequences[0], pending(sequences[0]));
+	CHECK(holds(table, sequences[0]));
+	for (size_t i = 0; i < sequences.size(); ++i) {
+		CHECK(i == 1 || takes(table, sequences[i]));
+	}
+	for (auto sequence : sequences) {
+		CHECK(!holds(table, sequence));
+	}
+}
+REGISTER_TEST("pending_table_collisions", pendingTableCollisions);
+
+// a probe run starting at the last slot wraps around to the first ones, deletions inside it move the
+// entries behind it back across the end of the array
+void pendingTableWrappedDelete()
+{
+	zim::ZIMPendingMessageTable table;
+	// home slot 15 of shard 0, they take slots 15, 0 and 1
+	zim_sequence last[] = {(kSlots - 1) * kShards, (2 * kSlots - 1) * kShards, (3 * kSlots - 1) * kShards};
+	// home slot 0, pushed to slot 2
+	zim_sequence first = kSlots * kShards;
+	// home slot 1, pushed to slot 3
+	zim_sequence second = (kSlots + 1) * kShards;
+	for (auto sequence : last) {
+		table.insert(sequence, pending(sequence));
+	}
+	table.insert(first, pending(first));
+	table.insert(second, pending(second));
+
+	CHECK(takes(table, last[0]));
+	CHECK(holds(table, last[1]));
+	CHECK(holds(table, last[2]));
+	CHECK(holds(table, first));
+	CHECK(holds(table, second));
+	// absent, its probe from slot 15 has to stop at the first free slot after the shifted run
+	CHECK(!holds(table, (4 * kSlots - 1) * kShards));
+
+	CHECK(takes(table, last[2]));
+	CHECK(takes(table, first));
+	CHECK(holds(table, last[1]));
+	CHECK(holds(table, second));
+	CHECK(takes(table, second));
+	CHECK(takes(table, last[1]));
+	CHECK(!holds(table, second));
+}
+REGISTER_TEST("pending_table_wrapped_delete", pendingTableWrappedDelete);
+
+// thousands of sequences in one shard, negative like the ones the SDK assigns, grow it again and again
+void pendingTableFullShard()
+{
+	zim::ZIMPendingMessageTable table;
+	const zim_sequence count = 5000;
+	for (zim_sequence i = 1; i <= count; ++i) {
+		table.insert(-i * kShards, pending(-i * kShards));
+		// a neighbouring shard stays out of the way
+		table.insert(-i * kShards + 1, pending(-i * kShards + 1));
+	}
+	for (zim_sequence i = 1; i <= count; ++i) {
+		CHECK(holds(table, -i * kShards));
+	}
+	for (zim_sequence i = 1; i <= count; i += 2) {
+		CHECK(takes(table, -i * kShards));
+	}
+	for (zim_sequence i = 1; i <= count; ++i) {
+		CHECK(holds(table, -i * kShards) == (i % 2 == 0));
+		CHECK(holds(table, -i * kShards + 1));
+	}
+	// the freed slots are used again
+	for (zim_sequence i = 1; i <= count; i += 2) {
+		table.insert(-i * kShards, pending(-i * kShards));
+	}
+	for (zim_sequence i = 1; i <= count; ++i) {
+		CHECK(takes(table, -i * kShards));
+		CHECK(takes(table, -i * kShards + 1));
+	}
+	CHECK(!holds(table, -kShards));
+}
+REGISTER_TEST("pending_table_full_shard", pendingTableFullShard);
+
+// concurrent sends and completions, as from the caller and the callback threads
+void pendingTableThreads()
+{
+	zim::ZIMPendingMessageTable table;
+	std::atomic<int> missing{0};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&table, &missing, t]() {
+			for (zim_sequence i = 0; i < 20000; ++i) {
+				zim_sequence sequence = -(i * 4 + t + 1);
+				table.insert(sequence, pending(sequence));
+				if (i >= 100 && !takes(table, sequence + 400)) {
+					++missing;
+				}
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	CHECK(missing == 0);
+}
+REGISTER_TEST("pending_table_threads", pendingTableThreads);
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	bool found = false;
+	for (const auto &test : checks::tests()) {
+		if (argc > 1 && std::strcmp(argv[1], test.name) != 0) {
+			continue;
+		}
+		found = true;
+		int before = checks::failures;
+		test.run();
+		std::cout << test.name << ": " << (checks::failures == before ? "ok" : "FAILED") << std::endl;
+	}
+	if (!found) {
+		std::cout << "unknown test " << argv[1] << std::endl;
+		return 1;
+	}
+	return checks::failures == 0 ? 0 : 1;
+}